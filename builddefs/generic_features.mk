@@ -27,13 +27,16 @@ GENERIC_FEATURES = \
     ENCODER \
     GRAVE_ESC \
     HAPTIC \
+    IDLE_WAIT \
     KEY_LOCK \
     KEY_OVERRIDE \
     LEADER \
     PROGRAMMABLE_BUTTON \
+    SEND_STRING_ASYNC \
     SPACE_CADET \
     SWAP_HANDS \
     TAP_DANCE \
+    TASK_PROFILE \
     VELOCIKEY \
     WPM \
     DYNAMIC_TAPPING_TERM \
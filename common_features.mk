@@ -39,6 +39,17 @@ else
     include $(PLATFORM_PATH)/$(PLATFORM_KEY)/printf.mk
 endif
 
+ifeq ($(strip $(IDLE_WAIT_ENABLE)), yes)
+    # Platforms without their own wait implementation fall back to polling
+    SRC += $(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/idle_wait.c)
+endif
+
+ifneq ($(filter yes,$(strip $(TASK_PROFILE_ENABLE)) $(strip $(RGB_MATRIX_ENABLE))),)
+    # Also gives RGB_MATRIX_RENDER_BUDGET_US its timer. Platforms without their own fall back to millisecond resolution
+    SRC += $(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/task_profile.c)
+    SRC += $(QUANTUM_DIR)/task_profile_timer.c
+endif
+
 ifeq ($(strip $(DEBUG_MATRIX_SCAN_RATE_ENABLE)), yes)
     OPT_DEFS += -DDEBUG_MATRIX_SCAN_RATE
     CONSOLE_ENABLE = yes
@@ -508,6 +519,14 @@ ifneq ($(strip $(CUSTOM_MATRIX)), yes)
     ifneq ($(strip $(CUSTOM_MATRIX)), lite)
         # Include the standard or split matrix code if needed
         QUANTUM_SRC += $(QUANTUM_DIR)/matrix.c
+
+        ifeq ($(strip $(MATRIX_BACKGROUND_SCAN_ENABLE)), yes)
+            ifeq ($(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/matrix_background.c),)
+                $(error MATRIX_BACKGROUND_SCAN_ENABLE is not supported on $(PLATFORM_KEY))
+            endif
+            OPT_DEFS += -DMATRIX_BACKGROUND_SCAN_ENABLE
+            QUANTUM_SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/matrix_background.c
+        endif
     endif
 endif
 
@@ -548,6 +567,9 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
         else
             QUANTUM_LIB_SRC += serial_$(strip $(SERIAL_DRIVER)).c
         endif
+
+        # The test platform has no serial driver, it simulates the other half in-process instead
+        SRC += $(wildcard $(PLATFORM_PATH)/$(PLATFORM_KEY)/split_sim.c)
     endif
     COMMON_VPATH += $(QUANTUM_PATH)/split_common
 endif
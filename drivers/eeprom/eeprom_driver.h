@@ -20,3 +20,5 @@
 
 void eeprom_driver_init(void);
 void eeprom_driver_erase(void);
+void eeprom_driver_task(void);
+void eeprom_driver_flush(void);
@@ -20,6 +20,10 @@
 #include "i2c_master.h"
 #include "wait.h"
 
+#if defined(ISSI_ASYNC_FLUSH) && !defined(PROTOCOL_CHIBIOS)
+#    error "ISSI_ASYNC_FLUSH is only available on ChibiOS"
+#endif
+
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
 // The address will vary depending on your wiring:
@@ -66,11 +70,20 @@ uint8_t g_twi_transfer_buffer[20];
 // buffers and the transfers in IS31FL3731_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][144];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+// one bit for each 16 byte transfer of g_pwm_buffer, set when it changed since it was last written
+uint16_t g_pwm_buffer_dirty_chunks[DRIVER_COUNT] = {0};
 
 uint8_t g_led_control_registers[DRIVER_COUNT][18]             = {{0}};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
 
+#ifdef ISSI_ASYNC_FLUSH
+// copies of the dirty transfers for the I2C thread to send from, while the next frame is rendered into g_pwm_buffer
+uint8_t         g_pwm_transfer_buffer[DRIVER_COUNT][9][17];
+static uint32_t g_pwm_transfer_mark[DRIVER_COUNT] = {0};
+// the chunks sent before each driver's mark, marked dirty again if sending them failed
+static uint16_t g_pwm_transfer_chunks[DRIVER_COUNT] = {0};
+#endif
+
 // This is the bit pattern in the LED control registers
 // (for matrix A, add one to register for matrix B)
 //
@@ -98,30 +111,35 @@ void IS31FL3731_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-void IS31FL3731_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
-    // assumes bank is already selected
-
-    // transmit PWM registers in 9 transfers of 16 bytes
-    // g_twi_transfer_buffer[] is 20 bytes
+static bool IS31FL3731_write_pwm_chunk(uint8_t addr, uint8_t *pwm_buffer, uint8_t chunk) {
+    uint8_t i = chunk * 16;
 
-    // iterate over the pwm_buffer contents at 16 byte intervals
-    for (int i = 0; i < 144; i += 16) {
-        // set the first register, e.g. 0x24, 0x34, 0x44, etc.
-        g_twi_transfer_buffer[0] = 0x24 + i;
-        // copy the data from i to i+15
-        // device will auto-increment register for data after the first byte
-        // thus this sets registers 0x24-0x33, 0x34-0x43, etc. in one transfer
-        for (int j = 0; j < 16; j++) {
-            g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
-        }
+    // set the first register, e.g. 0x24, 0x34, 0x44, etc.
+    g_twi_transfer_buffer[0] = 0x24 + i;
+    // copy the data from i to i+15
+    // device will auto-increment register for data after the first byte
+    // thus this sets registers 0x24-0x33, 0x34-0x43, etc. in one transfer
+    for (int j = 0; j < 16; j++) {
+        g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
+    }
 
 #if ISSI_PERSISTENCE > 0
-        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0) break;
-        }
+    for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0) return true;
+    }
+    return false;
 #else
-        i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT);
+    return i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0;
 #endif
+}
+
+void IS31FL3731_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    // assumes bank is already selected
+
+    // transmit PWM registers in 9 transfers of 16 bytes
+    // g_twi_transfer_buffer[] is 20 bytes
+    for (uint8_t chunk = 0; chunk < 9; chunk++) {
+        IS31FL3731_write_pwm_chunk(addr, pwm_buffer, chunk);
     }
 }
 
@@ -180,16 +198,22 @@ void IS31FL3731_init(uint8_t addr) {
     IS31FL3731_write_register(addr, ISSI_COMMANDREGISTER, 0);
 }
 
+static inline void IS31FL3731_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty_chunks[driver] |= 1 << (reg / 16);
+    }
+}
+
 void IS31FL3731_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31_led led;
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
         // Subtract 0x24 to get the second index of g_pwm_buffer
-        g_pwm_buffer[led.driver][led.r - 0x24]   = red;
-        g_pwm_buffer[led.driver][led.g - 0x24]   = green;
-        g_pwm_buffer[led.driver][led.b - 0x24]   = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3731_set_pwm(led.driver, led.r - 0x24, red);
+        IS31FL3731_set_pwm(led.driver, led.g - 0x24, green);
+        IS31FL3731_set_pwm(led.driver, led.b - 0x24, blue);
     }
 }
 
@@ -229,11 +253,50 @@ void IS31FL3731_set_led_control_register(uint8_t index, bool red, bool green, bo
     g_led_control_registers_update_required[led.driver] = true;
 }
 
+#ifdef ISSI_ASYNC_FLUSH
+static void IS31FL3731_queue_pwm_chunks(uint8_t addr, uint8_t index) {
+    // only blocks if this driver's previous frame is still being sent
+    if (i2c_async_wait_for(g_pwm_transfer_mark[index]) != I2C_STATUS_SUCCESS) {
+        // the error could have come from any transfer sent since the last wait, so all of them are sent again
+        for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+            g_pwm_buffer_dirty_chunks[i] |= g_pwm_transfer_chunks[i];
+        }
+    }
+    g_pwm_transfer_chunks[index] = 0;
+    if (!g_pwm_buffer_dirty_chunks[index]) {
+        return;
+    }
+
+    for (uint8_t chunk = 0; chunk < 9; chunk++) {
+        if (g_pwm_buffer_dirty_chunks[index] & (1 << chunk)) {
+            uint8_t *transfer = g_pwm_transfer_buffer[index][chunk];
+            transfer[0]       = 0x24 + chunk * 16;
+            memcpy(transfer + 1, &g_pwm_buffer[index][chunk * 16], 16);
+            i2c_transmit_async(addr << 1, transfer, 17, ISSI_TIMEOUT);
+        }
+    }
+    g_pwm_transfer_mark[index]       = i2c_async_mark();
+    g_pwm_transfer_chunks[index]     = g_pwm_buffer_dirty_chunks[index];
+    g_pwm_buffer_dirty_chunks[index] = 0;
+}
+#endif
+
 void IS31FL3731_update_pwm_buffers(uint8_t addr, uint8_t index) {
-    if (g_pwm_buffer_update_required[index]) {
-        IS31FL3731_write_pwm_buffer(addr, g_pwm_buffer[index]);
+#ifdef ISSI_ASYNC_FLUSH
+    // also checks on the previous frame, after which there may be nothing left to queue
+    if (g_pwm_buffer_dirty_chunks[index] || g_pwm_transfer_chunks[index]) {
+        IS31FL3731_queue_pwm_chunks(addr, index);
     }
-    g_pwm_buffer_update_required[index] = false;
+#else
+    if (g_pwm_buffer_dirty_chunks[index]) {
+        // only the transfers that changed are written, and those that fail stay dirty for the next flush
+        for (uint8_t chunk = 0; chunk < 9; chunk++) {
+            if ((g_pwm_buffer_dirty_chunks[index] & (1 << chunk)) && IS31FL3731_write_pwm_chunk(addr, g_pwm_buffer[index], chunk)) {
+                g_pwm_buffer_dirty_chunks[index] &= ~(1 << chunk);
+            }
+        }
+    }
+#endif
 }
 
 void IS31FL3731_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -21,6 +21,10 @@
 #include "i2c_master.h"
 #include "wait.h"
 
+#if defined(ISSI_ASYNC_FLUSH) && !defined(PROTOCOL_CHIBIOS)
+#    error "ISSI_ASYNC_FLUSH is only available on ChibiOS"
+#endif
+
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
 // The address will vary depending on your wiring:
@@ -79,11 +83,23 @@ uint8_t g_twi_transfer_buffer[20];
 // buffers and the transfers in IS31FL3733_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+// One bit for each 16 byte transfer of g_pwm_buffer, set when it changed since it was last written.
+uint16_t g_pwm_buffer_dirty_chunks[DRIVER_COUNT] = {0};
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24]             = {0};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
 
+#ifdef ISSI_ASYNC_FLUSH
+// Copies of the dirty transfers for the I2C thread to send from, while the next frame is rendered into g_pwm_buffer.
+uint8_t         g_pwm_transfer_buffer[DRIVER_COUNT][12][17];
+static uint32_t g_pwm_transfer_mark[DRIVER_COUNT] = {0};
+// The chunks sent before each driver's mark, marked dirty again if sending them failed.
+static uint16_t g_pwm_transfer_chunks[DRIVER_COUNT] = {0};
+// Kept in RAM for DMA.
+static uint8_t g_unlock_command[2]   = {ISSI_COMMANDREGISTER_WRITELOCK, 0xC5};
+static uint8_t g_pwm_page_command[2] = {ISSI_COMMANDREGISTER, ISSI_PAGE_PWM};
+#endif
+
 bool IS31FL3733_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
     // If the transaction fails function returns false.
     g_twi_transfer_buffer[0] = reg;
@@ -103,33 +119,40 @@ bool IS31FL3733_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
     return true;
 }
 
-bool IS31FL3733_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
-    // Assumes PG1 is already selected.
-    // If any of the transactions fails function returns false.
-    // Transmit PWM registers in 12 transfers of 16 bytes.
-    // g_twi_transfer_buffer[] is 20 bytes
+static bool IS31FL3733_write_pwm_chunk(uint8_t addr, uint8_t *pwm_buffer, uint8_t chunk) {
+    uint8_t i = chunk * 16;
 
-    // Iterate over the pwm_buffer contents at 16 byte intervals.
-    for (int i = 0; i < 192; i += 16) {
-        g_twi_transfer_buffer[0] = i;
-        // Copy the data from i to i+15.
-        // Device will auto-increment register for data after the first byte
-        // Thus this sets registers 0x00-0x0F, 0x10-0x1F, etc. in one transfer.
-        for (int j = 0; j < 16; j++) {
-            g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
-        }
+    g_twi_transfer_buffer[0] = i;
+    // Copy the data from i to i+15.
+    // Device will auto-increment register for data after the first byte
+    // Thus this sets registers 0x00-0x0F, 0x10-0x1F, etc. in one transfer.
+    for (int j = 0; j < 16; j++) {
+        g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
+    }
 
 #if ISSI_PERSISTENCE > 0
-        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) != 0) {
-                return false;
-            }
-        }
-#else
+    for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
         if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) != 0) {
             return false;
         }
+    }
+#else
+    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) != 0) {
+        return false;
+    }
 #endif
+    return true;
+}
+
+bool IS31FL3733_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    // Assumes PG1 is already selected.
+    // If any of the transactions fails function returns false.
+    // Transmit PWM registers in 12 transfers of 16 bytes.
+    // g_twi_transfer_buffer[] is 20 bytes
+    for (uint8_t chunk = 0; chunk < 12; chunk++) {
+        if (!IS31FL3733_write_pwm_chunk(addr, pwm_buffer, chunk)) {
+            return false;
+        }
     }
     return true;
 }
@@ -180,15 +203,21 @@ void IS31FL3733_init(uint8_t addr, uint8_t sync) {
     wait_ms(10);
 }
 
+static inline void IS31FL3733_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty_chunks[driver] |= 1 << (reg / 16);
+    }
+}
+
 void IS31FL3733_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31_led led;
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3733_set_pwm(led.driver, led.r, red);
+        IS31FL3733_set_pwm(led.driver, led.g, green);
+        IS31FL3733_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -228,19 +257,66 @@ void IS31FL3733_set_led_control_register(uint8_t index, bool red, bool green, bo
     g_led_control_registers_update_required[led.driver] = true;
 }
 
+#ifdef ISSI_ASYNC_FLUSH
+static void IS31FL3733_queue_pwm_chunks(uint8_t addr, uint8_t index) {
+    // Only blocks if this driver's previous frame is still being sent.
+    if (i2c_async_wait_for(g_pwm_transfer_mark[index]) != I2C_STATUS_SUCCESS) {
+        // The error could have come from any transfer sent since the last wait, so all of them are sent again,
+        // and PG0 is refreshed in case it was written to instead.
+        for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+            if (g_pwm_transfer_chunks[i]) {
+                g_pwm_buffer_dirty_chunks[i] |= g_pwm_transfer_chunks[i];
+                g_led_control_registers_update_required[i] = true;
+            }
+        }
+    }
+    g_pwm_transfer_chunks[index] = 0;
+    if (!g_pwm_buffer_dirty_chunks[index]) {
+        return;
+    }
+
+    i2c_transmit_async(addr << 1, g_unlock_command, 2, ISSI_TIMEOUT);
+    i2c_transmit_async(addr << 1, g_pwm_page_command, 2, ISSI_TIMEOUT);
+    for (uint8_t chunk = 0; chunk < 12; chunk++) {
+        if (g_pwm_buffer_dirty_chunks[index] & (1 << chunk)) {
+            uint8_t *transfer = g_pwm_transfer_buffer[index][chunk];
+            transfer[0]       = chunk * 16;
+            memcpy(transfer + 1, &g_pwm_buffer[index][chunk * 16], 16);
+            i2c_transmit_async(addr << 1, transfer, 17, ISSI_TIMEOUT);
+        }
+    }
+    g_pwm_transfer_mark[index]       = i2c_async_mark();
+    g_pwm_transfer_chunks[index]     = g_pwm_buffer_dirty_chunks[index];
+    g_pwm_buffer_dirty_chunks[index] = 0;
+}
+#endif
+
 void IS31FL3733_update_pwm_buffers(uint8_t addr, uint8_t index) {
-    if (g_pwm_buffer_update_required[index]) {
+#ifdef ISSI_ASYNC_FLUSH
+    // Also checks on the previous frame, after which there may be nothing left to queue.
+    if (g_pwm_buffer_dirty_chunks[index] || g_pwm_transfer_chunks[index]) {
+        IS31FL3733_queue_pwm_chunks(addr, index);
+    }
+#else
+    if (g_pwm_buffer_dirty_chunks[index]) {
         // Firstly we need to unlock the command register and select PG1.
         IS31FL3733_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
         IS31FL3733_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
-        // If any of the transactions fail we risk writing dirty PG0,
-        // refresh page 0 just in case.
-        if (!IS31FL3733_write_pwm_buffer(addr, g_pwm_buffer[index])) {
-            g_led_control_registers_update_required[index] = true;
+        // Only the transfers that changed are written, and those that fail stay dirty for the next flush.
+        for (uint8_t chunk = 0; chunk < 12; chunk++) {
+            if (g_pwm_buffer_dirty_chunks[index] & (1 << chunk)) {
+                if (IS31FL3733_write_pwm_chunk(addr, g_pwm_buffer[index], chunk)) {
+                    g_pwm_buffer_dirty_chunks[index] &= ~(1 << chunk);
+                } else {
+                    // If any of the transactions fail we risk writing dirty PG0,
+                    // refresh page 0 just in case.
+                    g_led_control_registers_update_required[index] = true;
+                }
+            }
         }
     }
-    g_pwm_buffer_update_required[index] = false;
+#endif
 }
 
 void IS31FL3733_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -21,6 +21,10 @@
 #include "i2c_master.h"
 #include "wait.h"
 
+#if defined(ISSI_ASYNC_FLUSH) && !defined(PROTOCOL_CHIBIOS)
+#    error "ISSI_ASYNC_FLUSH is only available on ChibiOS"
+#endif
+
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
 // The address will vary depending on your wiring:
@@ -76,11 +80,23 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+// one bit for each 16 byte transfer of g_pwm_buffer, set when it changed since it was last written
+uint16_t g_pwm_buffer_dirty_chunks[DRIVER_COUNT] = {0};
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24]             = {0};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
 
+#ifdef ISSI_ASYNC_FLUSH
+// copies of the dirty transfers for the I2C thread to send from, while the next frame is rendered into g_pwm_buffer
+uint8_t         g_pwm_transfer_buffer[DRIVER_COUNT][12][17];
+static uint32_t g_pwm_transfer_mark[DRIVER_COUNT] = {0};
+// the chunks sent before each driver's mark, marked dirty again if sending them failed
+static uint16_t g_pwm_transfer_chunks[DRIVER_COUNT] = {0};
+// kept in RAM for DMA
+static uint8_t g_unlock_command[2]   = {ISSI_COMMANDREGISTER_WRITELOCK, 0xC5};
+static uint8_t g_pwm_page_command[2] = {ISSI_COMMANDREGISTER, ISSI_PAGE_PWM};
+#endif
+
 void IS31FL3737_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
     g_twi_transfer_buffer[0] = reg;
     g_twi_transfer_buffer[1] = data;
@@ -94,29 +110,34 @@ void IS31FL3737_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-void IS31FL3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
-    // assumes PG1 is already selected
-
-    // transmit PWM registers in 12 transfers of 16 bytes
-    // g_twi_transfer_buffer[] is 20 bytes
+static bool IS31FL3737_write_pwm_chunk(uint8_t addr, uint8_t *pwm_buffer, uint8_t chunk) {
+    uint8_t i = chunk * 16;
 
-    // iterate over the pwm_buffer contents at 16 byte intervals
-    for (int i = 0; i < 192; i += 16) {
-        g_twi_transfer_buffer[0] = i;
-        // copy the data from i to i+15
-        // device will auto-increment register for data after the first byte
-        // thus this sets registers 0x00-0x0F, 0x10-0x1F, etc. in one transfer
-        for (int j = 0; j < 16; j++) {
-            g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
-        }
+    g_twi_transfer_buffer[0] = i;
+    // copy the data from i to i+15
+    // device will auto-increment register for data after the first byte
+    // thus this sets registers 0x00-0x0F, 0x10-0x1F, etc. in one transfer
+    for (int j = 0; j < 16; j++) {
+        g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
+    }
 
 #if ISSI_PERSISTENCE > 0
-        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0) break;
-        }
+    for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0) return true;
+    }
+    return false;
 #else
-        i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT);
+    return i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0;
 #endif
+}
+
+void IS31FL3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    // assumes PG1 is already selected
+
+    // transmit PWM registers in 12 transfers of 16 bytes
+    // g_twi_transfer_buffer[] is 20 bytes
+    for (uint8_t chunk = 0; chunk < 12; chunk++) {
+        IS31FL3737_write_pwm_chunk(addr, pwm_buffer, chunk);
     }
 }
 
@@ -165,15 +186,21 @@ void IS31FL3737_init(uint8_t addr) {
     wait_ms(10);
 }
 
+static inline void IS31FL3737_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty_chunks[driver] |= 1 << (reg / 16);
+    }
+}
+
 void IS31FL3737_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31_led led;
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3737_set_pwm(led.driver, led.r, red);
+        IS31FL3737_set_pwm(led.driver, led.g, green);
+        IS31FL3737_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -213,15 +240,56 @@ void IS31FL3737_set_led_control_register(uint8_t index, bool red, bool green, bo
     g_led_control_registers_update_required[led.driver] = true;
 }
 
+#ifdef ISSI_ASYNC_FLUSH
+static void IS31FL3737_queue_pwm_chunks(uint8_t addr, uint8_t index) {
+    // only blocks if this driver's previous frame is still being sent
+    if (i2c_async_wait_for(g_pwm_transfer_mark[index]) != I2C_STATUS_SUCCESS) {
+        // the error could have come from any transfer sent since the last wait, so all of them are sent again
+        for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+            g_pwm_buffer_dirty_chunks[i] |= g_pwm_transfer_chunks[i];
+        }
+    }
+    g_pwm_transfer_chunks[index] = 0;
+    if (!g_pwm_buffer_dirty_chunks[index]) {
+        return;
+    }
+
+    i2c_transmit_async(addr << 1, g_unlock_command, 2, ISSI_TIMEOUT);
+    i2c_transmit_async(addr << 1, g_pwm_page_command, 2, ISSI_TIMEOUT);
+    for (uint8_t chunk = 0; chunk < 12; chunk++) {
+        if (g_pwm_buffer_dirty_chunks[index] & (1 << chunk)) {
+            uint8_t *transfer = g_pwm_transfer_buffer[index][chunk];
+            transfer[0]       = chunk * 16;
+            memcpy(transfer + 1, &g_pwm_buffer[index][chunk * 16], 16);
+            i2c_transmit_async(addr << 1, transfer, 17, ISSI_TIMEOUT);
+        }
+    }
+    g_pwm_transfer_mark[index]       = i2c_async_mark();
+    g_pwm_transfer_chunks[index]     = g_pwm_buffer_dirty_chunks[index];
+    g_pwm_buffer_dirty_chunks[index] = 0;
+}
+#endif
+
 void IS31FL3737_update_pwm_buffers(uint8_t addr, uint8_t index) {
-    if (g_pwm_buffer_update_required[index]) {
+#ifdef ISSI_ASYNC_FLUSH
+    // also checks on the previous frame, after which there may be nothing left to queue
+    if (g_pwm_buffer_dirty_chunks[index] || g_pwm_transfer_chunks[index]) {
+        IS31FL3737_queue_pwm_chunks(addr, index);
+    }
+#else
+    if (g_pwm_buffer_dirty_chunks[index]) {
         // Firstly we need to unlock the command register and select PG1
         IS31FL3737_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
         IS31FL3737_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
-        IS31FL3737_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        // only the transfers that changed are written, and those that fail stay dirty for the next flush
+        for (uint8_t chunk = 0; chunk < 12; chunk++) {
+            if ((g_pwm_buffer_dirty_chunks[index] & (1 << chunk)) && IS31FL3737_write_pwm_chunk(addr, g_pwm_buffer[index], chunk)) {
+                g_pwm_buffer_dirty_chunks[index] &= ~(1 << chunk);
+            }
+        }
     }
-    g_pwm_buffer_update_required[index] = false;
+#endif
 }
 
 void IS31FL3737_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -24,6 +24,10 @@
 #include "i2c_master.h"
 #include "progmem.h"
 
+#if defined(ISSI_ASYNC_FLUSH) && !defined(PROTOCOL_CHIBIOS)
+#    error "ISSI_ASYNC_FLUSH is only available on ChibiOS"
+#endif
+
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
 // The address will vary depending on your wiring:
@@ -71,6 +75,12 @@
 
 #define ISSI_MAX_LEDS 351
 
+// PWM registers are written in transfers of 18 bytes, the last one holding the remaining 9
+#define ISSI_PWM_CHUNKS 20
+#define ISSI_PWM_CHUNK_SIZE 18
+// chunks from this one onwards are on PG1
+#define ISSI_PWM_CHUNKS_PG0 10
+
 // Transfer buffer for TWITransmitData()
 uint8_t g_twi_transfer_buffer[20] = {0xFF};
 
@@ -81,8 +91,20 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // buffers and the transfers in IS31FL3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT]        = {false};
 bool    g_scaling_registers_update_required[DRIVER_COUNT] = {false};
+// one bit for each transfer of g_pwm_buffer, set when it changed since it was last written
+uint32_t g_pwm_buffer_dirty_chunks[DRIVER_COUNT] = {0};
+
+#ifdef ISSI_ASYNC_FLUSH
+// copies of the dirty transfers for the I2C thread to send from, while the next frame is rendered into g_pwm_buffer
+uint8_t         g_pwm_transfer_buffer[DRIVER_COUNT][ISSI_PWM_CHUNKS][ISSI_PWM_CHUNK_SIZE + 1];
+static uint32_t g_pwm_transfer_mark[DRIVER_COUNT] = {0};
+// the chunks sent before each driver's mark, marked dirty again if sending them failed
+static uint32_t g_pwm_transfer_chunks[DRIVER_COUNT] = {0};
+// kept in RAM for DMA
+static uint8_t g_unlock_command[2]    = {ISSI_COMMANDREGISTER_WRITELOCK, 0xC5};
+static uint8_t g_pwm_page_commands[2][2] = {{ISSI_COMMANDREGISTER, ISSI_PAGE_PWM0}, {ISSI_COMMANDREGISTER, ISSI_PAGE_PWM1}};
+#endif
 
 uint8_t g_scaling_registers[DRIVER_COUNT][ISSI_MAX_LEDS];
 
@@ -99,53 +121,59 @@ void IS31FL3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-bool IS31FL3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
-    // unlock the command register and select PG2
-    IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
-    IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM0);
+// bytes in a transfer, as the total number is 351 the last one only has 9
+static inline uint8_t IS31FL3741_pwm_chunk_length(uint8_t chunk) { return chunk == ISSI_PWM_CHUNKS - 1 ? ISSI_MAX_LEDS - chunk * ISSI_PWM_CHUNK_SIZE : ISSI_PWM_CHUNK_SIZE; }
 
-    for (int i = 0; i < 342; i += 18) {
-        if (i == 180) {
-            // unlock the command register and select PG2
-            IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
-            IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM1);
-        }
+// assumes the chunk's page is already selected
+static bool IS31FL3741_write_pwm_chunk(uint8_t addr, uint8_t *pwm_buffer, uint8_t chunk) {
+    uint16_t i      = chunk * ISSI_PWM_CHUNK_SIZE;
+    uint8_t  length = IS31FL3741_pwm_chunk_length(chunk);
 
-        g_twi_transfer_buffer[0] = i % 180;
-        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, 18);
-
-#if ISSI_PERSISTENCE > 0
-        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, ISSI_TIMEOUT) != 0) {
-                return false;
-            }
-        }
-#else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, ISSI_TIMEOUT) != 0) {
-            return false;
-        }
-#endif
-    }
-
-    // transfer the left cause the total number is 351
-    g_twi_transfer_buffer[0] = 162;
-    memcpy(g_twi_transfer_buffer + 1, pwm_buffer + 342, 9);
+    g_twi_transfer_buffer[0] = i % 180;
+    memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, length);
 
 #if ISSI_PERSISTENCE > 0
     for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, ISSI_TIMEOUT) != 0) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
             return false;
         }
     }
 #else
-    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, ISSI_TIMEOUT) != 0) {
+    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
         return false;
     }
 #endif
-
     return true;
 }
 
+// first chunk of PG0 or PG1, and the one after the last
+static inline uint8_t IS31FL3741_pwm_page_start(uint8_t page) { return page == 0 ? 0 : ISSI_PWM_CHUNKS_PG0; }
+static inline uint8_t IS31FL3741_pwm_page_end(uint8_t page) { return page == 0 ? ISSI_PWM_CHUNKS_PG0 : ISSI_PWM_CHUNKS; }
+
+static inline bool IS31FL3741_pwm_page_dirty(uint32_t chunks, uint8_t page) { return chunks & ((1UL << IS31FL3741_pwm_page_end(page)) - (1UL << IS31FL3741_pwm_page_start(page))); }
+
+// writes the chunks set in `chunks`, selecting PG0 and PG1 as needed, and returns those that failed
+static uint32_t IS31FL3741_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint32_t chunks) {
+    for (uint8_t page = 0; page < 2; page++) {
+        if (!IS31FL3741_pwm_page_dirty(chunks, page)) {
+            continue;
+        }
+
+        // unlock the command register and select PG0 or PG1
+        IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
+        IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, page == 0 ? ISSI_PAGE_PWM0 : ISSI_PAGE_PWM1);
+
+        for (uint8_t chunk = IS31FL3741_pwm_page_start(page); chunk < IS31FL3741_pwm_page_end(page); chunk++) {
+            if ((chunks & (1UL << chunk)) && IS31FL3741_write_pwm_chunk(addr, pwm_buffer, chunk)) {
+                chunks &= ~(1UL << chunk);
+            }
+        }
+    }
+    return chunks;
+}
+
+bool IS31FL3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) { return IS31FL3741_write_pwm_chunks(addr, pwm_buffer, (1UL << ISSI_PWM_CHUNKS) - 1) == 0; }
+
 void IS31FL3741_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -173,15 +201,21 @@ void IS31FL3741_init(uint8_t addr) {
     wait_ms(10);
 }
 
+static inline void IS31FL3741_set_pwm(uint8_t driver, uint16_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty_chunks[driver] |= 1UL << (reg / ISSI_PWM_CHUNK_SIZE);
+    }
+}
+
 void IS31FL3741_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31_led led;
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3741_set_pwm(led.driver, led.r, red);
+        IS31FL3741_set_pwm(led.driver, led.g, green);
+        IS31FL3741_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -216,20 +250,62 @@ void IS31FL3741_set_led_control_register(uint8_t index, bool red, bool green, bo
     g_scaling_registers_update_required[led.driver] = true;
 }
 
-void IS31FL3741_update_pwm_buffers(uint8_t addr, uint8_t index) {
-    if (g_pwm_buffer_update_required[index]) {
-        IS31FL3741_write_pwm_buffer(addr, g_pwm_buffer[index]);
+#ifdef ISSI_ASYNC_FLUSH
+static void IS31FL3741_queue_pwm_chunks(uint8_t addr, uint8_t index) {
+    // only blocks if this driver's previous frame is still being sent
+    if (i2c_async_wait_for(g_pwm_transfer_mark[index]) != I2C_STATUS_SUCCESS) {
+        // the error could have come from any transfer sent since the last wait, so all of them are sent again
+        for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+            g_pwm_buffer_dirty_chunks[i] |= g_pwm_transfer_chunks[i];
+        }
+    }
+    g_pwm_transfer_chunks[index] = 0;
+    if (!g_pwm_buffer_dirty_chunks[index]) {
+        return;
+    }
+
+    for (uint8_t page = 0; page < 2; page++) {
+        if (!IS31FL3741_pwm_page_dirty(g_pwm_buffer_dirty_chunks[index], page)) {
+            continue;
+        }
+
+        i2c_transmit_async(addr << 1, g_unlock_command, 2, ISSI_TIMEOUT);
+        i2c_transmit_async(addr << 1, g_pwm_page_commands[page], 2, ISSI_TIMEOUT);
+        for (uint8_t chunk = IS31FL3741_pwm_page_start(page); chunk < IS31FL3741_pwm_page_end(page); chunk++) {
+            if (g_pwm_buffer_dirty_chunks[index] & (1UL << chunk)) {
+                uint16_t i        = chunk * ISSI_PWM_CHUNK_SIZE;
+                uint8_t  length   = IS31FL3741_pwm_chunk_length(chunk);
+                uint8_t *transfer = g_pwm_transfer_buffer[index][chunk];
+                transfer[0]       = i % 180;
+                memcpy(transfer + 1, &g_pwm_buffer[index][i], length);
+                i2c_transmit_async(addr << 1, transfer, length + 1, ISSI_TIMEOUT);
+            }
+        }
     }
+    g_pwm_transfer_mark[index]       = i2c_async_mark();
+    g_pwm_transfer_chunks[index]     = g_pwm_buffer_dirty_chunks[index];
+    g_pwm_buffer_dirty_chunks[index] = 0;
+}
+#endif
 
-    g_pwm_buffer_update_required[index] = false;
+void IS31FL3741_update_pwm_buffers(uint8_t addr, uint8_t index) {
+#ifdef ISSI_ASYNC_FLUSH
+    // also checks on the previous frame, after which there may be nothing left to queue
+    if (g_pwm_buffer_dirty_chunks[index] || g_pwm_transfer_chunks[index]) {
+        IS31FL3741_queue_pwm_chunks(addr, index);
+    }
+#else
+    // only the transfers that changed are written, and those that fail stay dirty for the next flush
+    if (g_pwm_buffer_dirty_chunks[index]) {
+        g_pwm_buffer_dirty_chunks[index] = IS31FL3741_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_dirty_chunks[index]);
+    }
+#endif
 }
 
 void IS31FL3741_set_pwm_buffer(const is31_led *pled, uint8_t red, uint8_t green, uint8_t blue) {
-    g_pwm_buffer[pled->driver][pled->r] = red;
-    g_pwm_buffer[pled->driver][pled->g] = green;
-    g_pwm_buffer[pled->driver][pled->b] = blue;
-
-    g_pwm_buffer_update_required[pled->driver] = true;
+    IS31FL3741_set_pwm(pled->driver, pled->r, red);
+    IS31FL3741_set_pwm(pled->driver, pled->g, green);
+    IS31FL3741_set_pwm(pled->driver, pled->b, blue);
 }
 
 void IS31FL3741_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #include <transactions.h>
 
@@ -44,3 +45,12 @@ int soft_serial_transaction(int sstd_index);
 //    or TRANSACTION_ACCEPTED
 #define TRANSACTION_ACCEPTED 0x8
 int soft_serial_get_and_clean_status(int sstd_index);
+
+#ifdef SERIAL_USART_SLAVE_PUSH
+// target sends data to the initiator outside of a transaction
+bool soft_serial_target_push(const void *data, size_t size);
+// target sends the last pushed data again
+void soft_serial_target_repush(void);
+// initiator takes the oldest data pushed by the target, without blocking
+bool soft_serial_initiator_receive_push(void *data, size_t size);
+#endif
@@ -0,0 +1,106 @@
+#ifndef __INC_LIB8TION_BATCH_H
+#define __INC_LIB8TION_BATCH_H
+
+///@ingroup lib8tion
+
+///@defgroup Batch Batch functions
+/// Versions of the 8-bit scaling and saturating math functions
+/// that work on a whole buffer of bytes at once, such as the
+/// color channels of every LED in a frame.
+///
+/// On 32-bit targets, four bytes are processed per word: on
+/// ARM cores with the DSP extension (Cortex-M4 and up) with the
+/// UXTB16 and UQADD8 SIMD instructions, elsewhere with plain
+/// 32-bit arithmetic.  The results are exactly the same as
+/// calling scale8 or qadd8 on each byte in turn.
+///@{
+
+#if !defined(__AVR__)
+
+/// load four bytes of a buffer, whatever their alignment
+LIB8STATIC_ALWAYS_INLINE uint32_t load8x4( const uint8_t* p)
+{
+    uint32_t x;
+    memcpy( &x, p, sizeof(x));
+    return x;
+}
+
+/// store four bytes to a buffer, whatever their alignment
+LIB8STATIC_ALWAYS_INLINE void store8x4( uint8_t* p, uint32_t x)
+{
+    memcpy( p, &x, sizeof(x));
+}
+
+/// scale each of the four bytes of a word by the same fract8
+LIB8STATIC_ALWAYS_INLINE uint32_t scale8x4( uint32_t x, fract8 scale)
+{
+#if (FASTLED_SCALE8_FIXED == 1)
+    uint32_t m = (uint32_t)scale + 1;
+#else
+    uint32_t m = scale;
+#endif
+    uint32_t even, odd;
+#if defined(__ARM_FEATURE_DSP)
+    asm( "uxtb16 %0, %1" : "=r" (even) : "r" (x));
+    asm( "uxtb16 %0, %1, ror #8" : "=r" (odd) : "r" (x));
+#else
+    even = x & 0x00FF00FF;
+    odd = (x >> 8) & 0x00FF00FF;
+#endif
+    // Each product fits in its own 16-bit lane, so they can't carry
+    // into each other
+    even = ((even * m) >> 8) & 0x00FF00FF;
+    odd = (odd * m) & 0xFF00FF00;
+    return even | odd;
+}
+
+/// add four pairs of bytes at once, saturating each sum at 0xFF
+LIB8STATIC_ALWAYS_INLINE uint32_t qadd8x4( uint32_t i, uint32_t j)
+{
+#if defined(__ARM_FEATURE_DSP)
+    asm( "uqadd8 %0, %0, %1" : "+r" (i) : "r" (j));
+    return i;
+#else
+    // Add the low seven bits of each byte, then the top bits without
+    // carrying out of the byte, and set every byte that overflowed
+    uint32_t sum = ((i & 0x7F7F7F7F) + (j & 0x7F7F7F7F)) ^ ((i ^ j) & 0x80808080);
+    uint32_t overflow = ((i & j) | ((i | j) & ~sum)) & 0x80808080;
+    return sum | ((overflow >> 7) * 0xFF);
+#endif
+}
+
+#endif
+
+/// scale every byte of a buffer by the same fract8, in place,
+/// as if by scale8
+LIB8STATIC void scale8_buffer( uint8_t* buf, uint16_t len, fract8 scale)
+{
+#if !defined(__AVR__)
+    for (; len >= 4; len -= 4, buf += 4) {
+        store8x4( buf, scale8x4( load8x4( buf), scale));
+    }
+#endif
+    while (len--) {
+        *buf = scale8( *buf, scale);
+        buf++;
+    }
+}
+
+/// add the same value to every byte of a buffer, in place,
+/// saturating at 0xFF, as if by qadd8
+LIB8STATIC void qadd8_buffer( uint8_t* buf, uint16_t len, uint8_t j)
+{
+#if !defined(__AVR__)
+    uint32_t j4 = j * 0x01010101U;
+    for (; len >= 4; len -= 4, buf += 4) {
+        store8x4( buf, qadd8x4( load8x4( buf), j4));
+    }
+#endif
+    while (len--) {
+        *buf = qadd8( *buf, j);
+        buf++;
+    }
+}
+
+///@}
+#endif
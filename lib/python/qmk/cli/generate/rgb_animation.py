@@ -0,0 +1,158 @@
+"""Generate a pre-rendered RGB Matrix animation header.
+"""
+import re
+from argparse import ArgumentTypeError
+
+from milc import cli
+
+import qmk.path
+from qmk.json_schema import json_load
+
+OP_SKIP = 0x00
+OP_FILL = 0x80
+OP_LITERAL = 0xC0
+MAX_SKIP = 0x80
+MAX_RUN = 0x40
+
+
+def c_identifier(value):
+    if re.fullmatch(r'[A-Za-z_][A-Za-z0-9_]*', value):
+        return value
+    else:
+        raise ArgumentTypeError('Name must be a valid C identifier')
+
+
+def parse_color(color):
+    """Turns "#RRGGBB" or [r, g, b] into an (r, g, b) tuple.
+    """
+    if isinstance(color, str) and re.fullmatch(r'#[0-9A-Fa-f]{6}', color):
+        return tuple(int(color[i:i + 2], 16) for i in (1, 3, 5))
+
+    if isinstance(color, list) and len(color) == 3 and all(isinstance(c, int) and 0 <= c <= 255 for c in color):
+        return tuple(color)
+
+    raise ValueError(f'Invalid color {color!r}, expected "#RRGGBB" or [r, g, b]')
+
+
+def run_length(values, start, limit):
+    """Returns how many values from start are the same as the first one, up to limit.
+    """
+    length = 1
+    while start + length < len(values) and length < limit and values[start + length] == values[start]:
+        length += 1
+    return length
+
+
+def encode_frame(previous, frame):
+    """Encodes a frame as the runs described in quantum/rgb_matrix/animations/playback_anim.h.
+
+    Runs of LEDs that didn't change since the previous frame are skipped, runs of the same colour are filled, and
+    everything else is written out as is. The first frame has no previous one, so nothing is skipped in it.
+    """
+    data = []
+    led = 0
+    while led < len(frame):
+        if previous is not None and frame[led] == previous[led]:
+            length = 1
+            while led + length < len(frame) and length < MAX_SKIP and frame[led + length] == previous[led + length]:
+                length += 1
+            data.append(OP_SKIP + length - 1)
+            led += length
+            continue
+
+        length = run_length(frame, led, MAX_RUN)
+        if length > 1:
+            data.append(OP_FILL + length - 1)
+            data.extend(frame[led])
+            led += length
+            continue
+
+        # Gather LEDs until a fill or skip would do better
+        end = led + 1
+        while end < len(frame) and end - led < MAX_RUN and run_length(frame, end, 3) < 3 and (previous is None or frame[end] != previous[end]):
+            end += 1
+        data.append(OP_LITERAL + end - led - 1)
+        for color in frame[led:end]:
+            data.extend(color)
+        led = end
+
+    return data
+
+
+def encode_animation(frames):
+    data = []
+    previous = None
+    for frame in frames:
+        data.extend(encode_frame(previous, frame))
+        previous = frame
+    return data
+
+
+@cli.argument('-o', '--output', arg_only=True, type=qmk.path.normpath, help='File to write to')
+@cli.argument('-q', '--quiet', arg_only=True, action='store_true', help='Quiet mode, only output error messages')
+@cli.argument('-n', '--name', arg_only=True, type=c_identifier, default='rgb_animation', help='The name of the animation in C. Default: rgb_animation')
+@cli.argument('-f', '--frame-ms', arg_only=True, type=int, help='How long each frame is shown for, in milliseconds, overriding frame_ms in the input')
+@cli.argument('input', arg_only=True, type=qmk.path.normpath, help='The animation to encode, as a JSON file of frames')
+@cli.subcommand('Generates a pre-rendered animation header for the RGB Matrix playback effect.')
+def generate_rgb_animation(cli):
+    """Generates a header containing an animation for the RGB Matrix PLAYBACK effect.
+
+    The input is a JSON object with "frame_ms", how long each frame is shown for, and "frames", a list of frames, each a
+    list of the LED colours in g_led_config order, as "#RRGGBB" or [r, g, b].
+    """
+    animation = json_load(cli.args.input)
+    frame_ms = cli.args.frame_ms if cli.args.frame_ms is not None else animation.get('frame_ms', 33)
+
+    try:
+        frames = [[parse_color(color) for color in frame] for frame in animation['frames']]
+    except (KeyError, TypeError, ValueError) as e:
+        cli.log.error('Invalid animation: %s', e)
+        return False
+
+    if not frames:
+        cli.log.error('The animation has no frames.')
+        return False
+
+    led_count = len(frames[0])
+    if led_count == 0 or led_count > 255 or any(len(frame) != led_count for frame in frames):
+        cli.log.error('Every frame needs the same number of LEDs, between 1 and 255.')
+        return False
+
+    if len(frames) > 65534 or not 0 < frame_ms < 65536:
+        cli.log.error('The animation needs fewer than 65535 frames, of 1 to 65535 ms each.')
+        return False
+
+    data = encode_animation(frames)
+
+    data_lines = []
+    for i in range(0, len(data), 16):
+        data_lines.append('    ' + ', '.join(f'0x{value:02X}' for value in data[i:i + 16]) + ',')
+
+    header = f'''#pragma once
+
+// clang-format off
+
+// {len(frames)} frames of {led_count} LEDs, {frame_ms} ms each, {len(data)} bytes
+
+static const uint8_t PROGMEM {cli.args.name}_data[] = {{
+{chr(10).join(data_lines)}
+}};
+
+static const rgb_matrix_animation_t {cli.args.name} = {{
+    .frame_count = {len(frames)},
+    .frame_ms    = {frame_ms},
+    .led_count   = {led_count},
+    .data        = {cli.args.name}_data,
+}};
+'''
+
+    if cli.args.output:
+        cli.args.output.parent.mkdir(parents=True, exist_ok=True)
+        if cli.args.output.exists():
+            cli.args.output.replace(cli.args.output.parent / (cli.args.output.name + '.bak'))
+        cli.args.output.write_text(header)
+
+        if not cli.args.quiet:
+            cli.log.info('Wrote header to %s.', cli.args.output)
+    else:
+        print(header)
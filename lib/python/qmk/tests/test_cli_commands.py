@@ -243,6 +243,14 @@ def test_generate_rgb_breathe_table():
     assert 'Breathing max:    127' in result.stdout
 
 
+def test_generate_rgb_animation():
+    result = check_subcommand('generate-rgb-animation', '-n', 'test_animation', 'lib/python/qmk/tests/rgb_animation.json')
+    check_returncode(result)
+    assert '// 2 frames of 5 LEDs, 50 ms each, 16 bytes' in result.stdout
+    assert '0x82, 0xFF, 0x00, 0x00, 0xC1, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x03, 0xC0, 0x00, 0x00, 0xFE,' in result.stdout
+    assert 'static const rgb_matrix_animation_t test_animation = {' in result.stdout
+
+
 def test_generate_config_h():
     result = check_subcommand('generate-config-h', '-kb', 'handwired/pytest/basic')
     check_returncode(result)
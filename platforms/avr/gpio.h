@@ -47,3 +47,8 @@ typedef uint8_t port_data_t;
 
 #define writePortBitLow(port, bit) (PORTx_ADDRESS(port) &= ~_BV((bit)&0xF))
 #define writePortBitHigh(port, bit) (PORTx_ADDRESS(port) |= _BV((bit)&0xF))
+
+/* Grouping of pins by port. */
+
+#define isSamePort(pin_a, pin_b) (((pin_a) >> 4) == ((pin_b) >> 4))
+#define getPortBit(pin) ((pin)&0xF)
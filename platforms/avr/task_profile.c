@@ -0,0 +1,34 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "timer_avr.h"
+#include "timer.h"
+#include "task_profile.h"
+
+#if defined(__AVR_ATmega32A__)
+#    define TIMER_COMPARE_PENDING() (TIFR & _BV(OCF0))
+#elif defined(__AVR_ATtiny85__)
+#    define TIMER_COMPARE_PENDING() (TIFR & _BV(OCF0A))
+#else
+#    define TIMER_COMPARE_PENDING() (TIFR0 & _BV(OCF0A))
+#endif
+
+// Combines the millisecond count with the Timer0 count within the current millisecond
+uint32_t task_profile_timer_read(void) {
+    uint32_t ms;
+    uint8_t  raw;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms  = timer_count;
+        raw = TIMER_RAW;
+        // The compare match may have happened without its interrupt having run yet
+        if (TIMER_COMPARE_PENDING()) {
+            ms++;
+            raw = TIMER_RAW;
+        }
+    }
+    return ms * 1000 + (uint32_t)raw * 1000 / TIMER_RAW_TOP;
+}
+
+uint32_t task_profile_timer_elapsed_us(uint32_t start) { return task_profile_timer_read() - start; }
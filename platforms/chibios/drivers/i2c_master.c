@@ -60,6 +60,85 @@ static i2c_status_t chibios_to_qmk(const msg_t* status) {
     }
 }
 
+typedef struct {
+    const uint8_t* data;
+    uint16_t       length;
+    uint16_t       timeout;
+    uint8_t        address;
+} i2c_async_transfer_t;
+
+static i2c_async_transfer_t  async_queue[I2C_ASYNC_QUEUE_SIZE];
+static uint8_t               async_head   = 0;
+static uint8_t               async_tail   = 0;
+static uint32_t              async_queued = 0;
+static volatile uint32_t     async_done   = 0;
+static volatile i2c_status_t async_status = I2C_STATUS_SUCCESS;
+static thread_t*             async_thread = NULL;
+static thread_reference_t    async_waiter = NULL;
+static SEMAPHORE_DECL(async_free, I2C_ASYNC_QUEUE_SIZE);
+static SEMAPHORE_DECL(async_ready, 0);
+
+static THD_WORKING_AREA(waI2CAsyncThread, 256);
+static THD_FUNCTION(I2CAsyncThread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c_async");
+
+    while (true) {
+        chSemWait(&async_ready);
+
+        const i2c_async_transfer_t* transfer = &async_queue[async_tail];
+        i2cStart(&I2C_DRIVER, &i2cconfig);
+        msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (transfer->address >> 1), transfer->data, transfer->length, 0, 0, TIME_MS2I(transfer->timeout));
+        async_tail   = (async_tail + 1) % I2C_ASYNC_QUEUE_SIZE;
+
+        chSysLock();
+        if (status != I2C_NO_ERROR && async_status == I2C_STATUS_SUCCESS) {
+            async_status = chibios_to_qmk(&status);
+        }
+        async_done++;
+        chSemSignalI(&async_free);
+        chThdResumeI(&async_waiter, MSG_OK);
+        chSchRescheduleS();
+        chSysUnlock();
+    }
+}
+
+static void async_wait_until(uint32_t mark) {
+    chSysLock();
+    while ((int32_t)(async_done - mark) < 0) {
+        chThdSuspendS(&async_waiter);
+    }
+    chSysUnlock();
+}
+
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (async_thread == NULL) {
+        // Above the main loop, so transfers get going straight away. The thread spends most of its time waiting on DMA.
+        async_thread = chThdCreateStatic(waI2CAsyncThread, sizeof(waI2CAsyncThread), NORMALPRIO + 1, I2CAsyncThread, NULL);
+    }
+
+    chSemWait(&async_free);
+    async_queue[async_head] = (i2c_async_transfer_t){.data = data, .length = length, .timeout = timeout, .address = address};
+    async_head              = (async_head + 1) % I2C_ASYNC_QUEUE_SIZE;
+    async_queued++;
+    chSemSignal(&async_ready);
+    return I2C_STATUS_SUCCESS;
+}
+
+uint32_t i2c_async_mark(void) { return async_queued; }
+
+i2c_status_t i2c_async_wait_for(uint32_t mark) {
+    async_wait_until(mark);
+
+    chSysLock();
+    i2c_status_t status = async_status;
+    async_status        = I2C_STATUS_SUCCESS;
+    chSysUnlock();
+    return status;
+}
+
+i2c_status_t i2c_async_wait(void) { return i2c_async_wait_for(async_queued); }
+
 __attribute__((weak)) void i2c_init(void) {
     static bool is_initialised = false;
     if (!is_initialised) {
@@ -81,12 +160,14 @@ __attribute__((weak)) void i2c_init(void) {
 }
 
 i2c_status_t i2c_start(uint8_t address) {
+    async_wait_until(async_queued);
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     return I2C_STATUS_SUCCESS;
 }
 
 i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    async_wait_until(async_queued);
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
@@ -94,6 +175,7 @@ i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length,
 }
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    async_wait_until(async_queued);
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, TIME_MS2I(timeout));
@@ -101,6 +183,7 @@ i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16
 }
 
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    async_wait_until(async_queued);
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -115,6 +198,7 @@ i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data,
 }
 
 i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    async_wait_until(async_queued);
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -130,6 +214,7 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
 }
 
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    async_wait_until(async_queued);
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
@@ -137,6 +222,7 @@ i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16
 }
 
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    async_wait_until(async_queued);
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
@@ -144,4 +230,7 @@ i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uin
     return chibios_to_qmk(&status);
 }
 
-void i2c_stop(void) { i2cStop(&I2C_DRIVER); }
+void i2c_stop(void) {
+    async_wait_until(async_queued);
+    i2cStop(&I2C_DRIVER);
+}
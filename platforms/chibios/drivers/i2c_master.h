@@ -68,6 +68,11 @@
 #    define I2C_DRIVER I2CD1
 #endif
 
+// Transmissions that can be queued by i2c_transmit_async() before it blocks
+#ifndef I2C_ASYNC_QUEUE_SIZE
+#    define I2C_ASYNC_QUEUE_SIZE 32
+#endif
+
 #ifdef USE_GPIOV1
 #    ifndef I2C1_SCL_PAL_MODE
 #        define I2C1_SCL_PAL_MODE PAL_MODE_ALTERNATE_OPENDRAIN
@@ -100,3 +105,15 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 void         i2c_stop(void);
+
+/* Asynchronous transmissions are handed to a background thread, which waits for the DMA transfer while the caller carries
+ * on. They are sent in the order they were queued, and every other function above waits for them before using the bus.
+ * The data has to stay untouched until the transmission is done, and only a single thread may queue and wait for them.
+ */
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout);
+// Marks everything queued so far, for i2c_async_wait_for()
+uint32_t i2c_async_mark(void);
+// Waits until everything queued before the mark is done. Returns the first error since the last wait, if any
+i2c_status_t i2c_async_wait_for(uint32_t mark);
+// Waits until everything queued so far is done. Returns the first error since the last wait, if any
+i2c_status_t i2c_async_wait(void);
@@ -16,6 +16,8 @@
 
 #include "serial_usart.h"
 
+#include <string.h>
+
 #if defined(SERIAL_USART_CONFIG)
 static SerialConfig serial_config = SERIAL_USART_CONFIG;
 #else
@@ -38,6 +40,7 @@ static inline bool __attribute__((nonnull)) receive(uint8_t* destination, const
 static inline bool __attribute__((nonnull)) send(const uint8_t* source, const size_t size);
 static inline int  initiate_transaction(uint8_t sstd_index);
 static inline void usart_clear(void);
+static inline bool usart_input_available(void);
 
 /**
  * @brief Clear the receive input queue.
@@ -63,6 +66,16 @@ static inline void usart_clear(void) {
     }
 }
 
+/**
+ * @brief Check for received bytes without blocking.
+ */
+static inline bool usart_input_available(void) {
+    osalSysLock();
+    bool available = !iqIsEmptyI(&serial_driver->iqueue);
+    osalSysUnlock();
+    return available;
+}
+
 /**
  * @brief Blocking send of buffer with timeout.
  *
@@ -158,6 +171,98 @@ __attribute__((weak, nonnull)) void usart_slave_init(SerialDriver** driver) {
     usart_init();
 }
 
+#if defined(SERIAL_USART_SLAVE_PUSH)
+
+#    define SERIAL_EVENT EVENT_MASK(0)
+#    define PUSH_EVENT EVENT_MASK(1)
+
+static thread_t* slave_thread = NULL;
+static uint8_t   push_buffer[1 + sizeof(split_slave_push_t)];
+static bool      push_pending = false;
+
+/**
+ * @brief Hand data to the slave thread, which sends it to the master between transactions.
+ *
+ * @return true Push queued.
+ * @return false Wrong size or the slave thread is not running yet.
+ */
+bool soft_serial_target_push(const void* data, size_t size) {
+    if (size != sizeof(push_buffer) - 1 || !slave_thread) {
+        return false;
+    }
+
+    osalSysLock();
+    push_buffer[0] = PUSH_MAGIC;
+    memcpy(&push_buffer[1], data, size);
+    push_pending = true;
+    chEvtSignalI(slave_thread, PUSH_EVENT);
+    /* The slave thread runs at a higher priority, let it send right away. */
+    chSchRescheduleS();
+    osalSysUnlock();
+    return true;
+}
+
+/**
+ * @brief Send the last push again, e.g. from a slave callback when the master asks for it.
+ */
+void soft_serial_target_repush(void) {
+    osalSysLock();
+    if (push_buffer[0] == PUSH_MAGIC) {
+        push_pending = true;
+        chEvtSignalI(slave_thread, PUSH_EVENT);
+    }
+    osalSysUnlock();
+}
+
+/**
+ * @brief Send a pending push to the master. Only called from the slave thread, so it never
+ * interleaves with the reply to a transaction.
+ */
+static inline void push_to_master(void) {
+    uint8_t frame[sizeof(push_buffer)];
+
+    osalSysLock();
+    bool pending = push_pending;
+    push_pending = false;
+    memcpy(frame, push_buffer, sizeof(frame));
+    osalSysUnlock();
+
+    if (pending) {
+        send(frame, sizeof(frame));
+    }
+}
+
+/**
+ * @brief This thread runs on the slave, responds to transactions initiated
+ * by the master and sends pushes in between.
+ */
+static THD_WORKING_AREA(waSlaveThread, 1024);
+static THD_FUNCTION(SlaveThread, arg) {
+    (void)arg;
+    chRegSetThreadName("usart_tx_rx");
+
+    event_listener_t serial_listener;
+    chEvtRegisterMaskWithFlags(chnGetEventSource(serial_driver), &serial_listener, SERIAL_EVENT, CHN_INPUT_AVAILABLE);
+
+    while (true) {
+        eventmask_t events = chEvtWaitAny(SERIAL_EVENT | PUSH_EVENT);
+
+        if (events & PUSH_EVENT) {
+            push_to_master();
+        }
+
+        while (usart_input_available()) {
+            if (!react_to_transactions()) {
+                /* Clear the receive queue, to start with a clean slate.
+                 * Parts of failed transactions or spurious bytes could still be in it. */
+                usart_clear();
+            }
+        }
+    }
+}
+
+#else
+
 /**
  * @brief This thread runs on the slave and responds to transactions initiated
  * by the master.
@@ -176,6 +281,8 @@ static THD_FUNCTION(SlaveThread, arg) {
     }
 }
 
+#endif
+
 /**
  * @brief Slave specific initializations.
  */
@@ -185,7 +292,10 @@ void soft_serial_target_init(void) {
     sdStart(serial_driver, &serial_config);
 
     /* Start transport thread. */
-    chThdCreateStatic(waSlaveThread, sizeof(waSlaveThread), HIGHPRIO, SlaveThread, NULL);
+#if defined(SERIAL_USART_SLAVE_PUSH)
+    slave_thread =
+#endif
+        chThdCreateStatic(waSlaveThread, sizeof(waSlaveThread), HIGHPRIO, SlaveThread, NULL);
 }
 
 /**
@@ -248,6 +358,67 @@ void soft_serial_initiator_init(void) {
     sdStart(serial_driver, &serial_config);
 }
 
+#if defined(SERIAL_USART_SLAVE_PUSH)
+
+static uint8_t push_queue[SERIAL_USART_PUSH_QUEUE_SIZE][sizeof(split_slave_push_t)];
+static uint8_t push_queue_head  = 0;
+static uint8_t push_queue_count = 0;
+
+/**
+ * @brief Receive the rest of a push, after its PUSH_MAGIC, into the queue.
+ * A full queue keeps its oldest entries and has the newest one overwritten,
+ * so the final state of the slave always arrives.
+ */
+static inline bool receive_push(void) {
+    uint8_t push[sizeof(split_slave_push_t)];
+    if (!receive(push, sizeof(push))) {
+        return false;
+    }
+
+    if (push_queue_count == SERIAL_USART_PUSH_QUEUE_SIZE) {
+        push_queue_count--;
+    }
+    memcpy(push_queue[(push_queue_head + push_queue_count++) % SERIAL_USART_PUSH_QUEUE_SIZE], push, sizeof(push));
+    return true;
+}
+
+/**
+ * @brief Queue up everything the slave pushed since the last transaction.
+ * Anything else received outside of a transaction is spurious and cleared.
+ */
+static inline void usart_receive_pushes(void) {
+    while (usart_input_available()) {
+        if (sdGetTimeout(serial_driver, TIME_IMMEDIATE) != PUSH_MAGIC || !receive_push()) {
+            usart_clear();
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Take the oldest push received from the slave, without blocking.
+ *
+ * @return true A push was copied to data.
+ * @return false No push waiting.
+ */
+bool soft_serial_initiator_receive_push(void* data, size_t size) {
+    if (size != sizeof(push_queue[0])) {
+        return false;
+    }
+
+    usart_receive_pushes();
+    if (!push_queue_count) {
+        return false;
+    }
+
+    memcpy(data, push_queue[push_queue_head], size);
+    push_queue_head = (push_queue_head + 1) % SERIAL_USART_PUSH_QUEUE_SIZE;
+    push_queue_count--;
+    return true;
+}
+
+#endif
+
 /**
  * @brief Start transaction from the master half to the slave half.
  *
@@ -257,9 +428,14 @@ void soft_serial_initiator_init(void) {
  *             TRANSACTION_END in case of success.
  */
 int soft_serial_transaction(int index) {
+#if defined(SERIAL_USART_SLAVE_PUSH)
+    /* Keep what the slave pushed in the meantime, clearing anything else. */
+    usart_receive_pushes();
+#else
     /* Clear the receive queue, to start with a clean slate.
      * Parts of failed transactions or spurious bytes could still be in it. */
     usart_clear();
+#endif
     return initiate_transaction((uint8_t)index);
 }
 
@@ -293,7 +469,16 @@ static inline int initiate_transaction(uint8_t sstd_index) {
      *   - due to the half duplex limitations on return codes, we always have to read *something*.
      *   - without the read, write only transactions *always* succeed, even during the boot process where the slave is not ready.
      */
-    if (!receive(&sstd_index_shake, sizeof(sstd_index_shake)) || (sstd_index_shake != (sstd_index ^ HANDSHAKE_MAGIC))) {
+    bool received = receive(&sstd_index_shake, sizeof(sstd_index_shake));
+
+#if defined(SERIAL_USART_SLAVE_PUSH)
+    /* The slave may have started pushing before it saw the transaction id, the handshake follows the push. */
+    while (received && sstd_index_shake == PUSH_MAGIC) {
+        received = receive_push() && receive(&sstd_index_shake, sizeof(sstd_index_shake));
+    }
+#endif
+
+    if (!received || (sstd_index_shake != (sstd_index ^ HANDSHAKE_MAGIC))) {
         dprintln("USART: Handshake failed.");
         return TRANSACTION_NO_RESPONSE;
     }
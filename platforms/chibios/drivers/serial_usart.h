@@ -114,3 +114,18 @@
 #endif
 
 #define HANDSHAKE_MAGIC 7
+
+#if defined(SERIAL_USART_SLAVE_PUSH)
+#    if !defined(SERIAL_USART_FULL_DUPLEX)
+#        error "SERIAL_USART_SLAVE_PUSH requires SERIAL_USART_FULL_DUPLEX"
+#    endif
+
+/* Starts a push from the slave. Has to differ from every handshake, which are transaction ids XORed with HANDSHAKE_MAGIC. */
+#    define PUSH_MAGIC 0xA5
+_Static_assert(PUSH_MAGIC >= ((NUM_TOTAL_TRANSACTIONS - 1) | HANDSHAKE_MAGIC) + 1, "PUSH_MAGIC collides with a handshake");
+
+/* Number of pushes the master holds until it gets around to them. */
+#    if !defined(SERIAL_USART_PUSH_QUEUE_SIZE)
+#        define SERIAL_USART_PUSH_QUEUE_SIZE 4
+#    endif
+#endif
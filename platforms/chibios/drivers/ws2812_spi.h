@@ -0,0 +1,66 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include "ws2812.h"
+
+/* The SPI driver sends each bit of a colour as 4 bits on MOSI, 1110 for a one and 1000 for a zero, so at about 3.2MHz
+ * the high time of a one is around 900ns and that of a zero around 300ns.
+ */
+
+#define WS2812_SPI_BYTES_PER_CHANNEL 4
+#ifdef RGBW
+#    define WS2812_SPI_CHANNELS 4
+#else
+#    define WS2812_SPI_CHANNELS 3
+#endif
+#define WS2812_SPI_BYTES_PER_LED (WS2812_SPI_BYTES_PER_CHANNEL * WS2812_SPI_CHANNELS)
+
+// Zeros sent ahead of the first LED, and after the last one to latch the frame
+#define WS2812_SPI_PREAMBLE_SIZE 4
+#define WS2812_SPI_RESET_SIZE (1000 * WS2812_TRST_US / (2 * WS2812_TIMING))
+
+#define WS2812_SPI_FRAME_SIZE(leds) (WS2812_SPI_PREAMBLE_SIZE + (leds)*WS2812_SPI_BYTES_PER_LED + WS2812_SPI_RESET_SIZE)
+
+// Encodes bits 7-pos*2 and 6-pos*2 of a colour byte, most significant first
+static inline uint8_t ws2812_spi_encode_bits(uint8_t data, uint8_t pos) {
+    uint8_t shift = 2 * (3 - pos);
+    return ((data & (2 << shift)) ? 0b11100000 : 0b10000000) | ((data & (1 << shift)) ? 0b1110 : 0b1000);
+}
+
+static inline void ws2812_spi_encode_channel(uint8_t *out, uint8_t data) {
+    for (uint8_t pos = 0; pos < WS2812_SPI_BYTES_PER_CHANNEL; pos++) {
+        out[pos] = ws2812_spi_encode_bits(data, pos);
+    }
+}
+
+// Encodes a single LED into WS2812_SPI_BYTES_PER_LED bytes, in the order given by WS2812_BYTE_ORDER
+static inline void ws2812_spi_encode_led(uint8_t *out, LED_TYPE color) {
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
+    ws2812_spi_encode_channel(out, color.g);
+    ws2812_spi_encode_channel(out + WS2812_SPI_BYTES_PER_CHANNEL, color.r);
+    ws2812_spi_encode_channel(out + WS2812_SPI_BYTES_PER_CHANNEL * 2, color.b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+    ws2812_spi_encode_channel(out, color.r);
+    ws2812_spi_encode_channel(out + WS2812_SPI_BYTES_PER_CHANNEL, color.g);
+    ws2812_spi_encode_channel(out + WS2812_SPI_BYTES_PER_CHANNEL * 2, color.b);
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+    ws2812_spi_encode_channel(out, color.b);
+    ws2812_spi_encode_channel(out + WS2812_SPI_BYTES_PER_CHANNEL, color.g);
+    ws2812_spi_encode_channel(out + WS2812_SPI_BYTES_PER_CHANNEL * 2, color.r);
+#endif
+#ifdef RGBW
+    ws2812_spi_encode_channel(out + WS2812_SPI_BYTES_PER_CHANNEL * 3, color.w);
+#endif
+}
+
+// Encodes the LEDs into a frame buffer of WS2812_SPI_FRAME_SIZE bytes, leaving its preamble and reset period alone
+static inline void ws2812_spi_encode_frame(uint8_t *frame, const LED_TYPE *ledarray, uint16_t leds) {
+    uint8_t *out = frame + WS2812_SPI_PREAMBLE_SIZE;
+    for (uint16_t i = 0; i < leds; i++) {
+        ws2812_spi_encode_led(out, ledarray[i]);
+        out += WS2812_SPI_BYTES_PER_LED;
+    }
+}
@@ -20,6 +20,7 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include "util.h"
 #include "debug.h"
 #include "eeprom_stm32.h"
@@ -53,6 +54,8 @@
  *
  * FEE_PAGE_COUNT   # Total number of pages to use for eeprom simulation (Compact + Write log)
  * FEE_DENSITY_BYTES   # Size of simulated eeprom. (Defaults to half the space allocated by FEE_PAGE_COUNT)
+ * FEE_BACKGROUND_COMPACTION   # Split the pages into two banks, and compact into the unused one from EEPROM_Task()
+ * FEE_WRITE_BEHIND_DELAY   # Hold changes in RAM until no writes have happened for this many milliseconds
  * NOTE: The current implementation does not include page swapping,
  * and FEE_DENSITY_BYTES will consume that amount of RAM as a cached view of actual EEPROM contents.
  *
@@ -80,6 +83,27 @@
  * Otherwise a Write log entry is constructed and appended to the next free position in the Write log.
  *
  *
+ * *** Background Compaction ***
+ *
+ * With FEE_BACKGROUND_COMPACTION, the pages are split into two banks, each holding a header, a Compacted-flash area and a Write log:
+ *
+ * ┌─ Bank 0 ───────────────────────┬─ Bank 1 ───────────────────────┐
+ * │[SEQ][DONE]│Compacted│Write Log │[SEQ][DONE]│Compacted│Write Log │
+ * └───────────┴─────────┴──────────┴───────────┴─────────┴──────────┘
+ *
+ * Once the Write log of the active bank passes FEE_COMPACTION_THRESHOLD, EEPROM_Task() erases the other bank a page at a time,
+ * claims it with the next sequence number, then copies the cache into its Compacted-flash area FEE_COMPACTION_SLICE_WORDS at a time.
+ * Writes keep going to the active bank meanwhile; writes to the part already copied are also logged in the new bank.
+ * When the copy is done DONE is cleared, and the new bank becomes active. During initialization, the complete bank with the most
+ * recent sequence number is used, so losing power at any point leaves the previous contents intact.
+ * Should the active Write log fill up before compaction is done, the rest of the compaction is performed immediately.
+ *
+ * With FEE_WRITE_BEHIND_DELAY, writes only update the cache and mark the word as changed. EEPROM_Task() writes changed words
+ * to flash, FEE_WRITE_BEHIND_SLICE_WORDS at a time, once no writes have happened for FEE_WRITE_BEHIND_DELAY milliseconds.
+ * Repeated writes to the same word in the meantime cost a single Write log entry. Changes not written yet are lost on power loss,
+ * EEPROM_Flush() writes them immediately.
+ *
+ *
  * *** Write Log Structure ***
  *
  * Write log entries allow for optimized byte writes to addresses below 128. Writing 0 or 1 words are also optimized when word-aligned.
@@ -150,16 +174,33 @@
 /* Flash word value after erase */
 #define FEE_EMPTY_WORD ((uint16_t)0xFFFF)
 
-/* Size of combined compacted eeprom and write log pages */
-#define FEE_DENSITY_MAX_SIZE (FEE_PAGE_COUNT * FEE_PAGE_SIZE)
-
 #ifndef FEE_MCU_FLASH_SIZE_IGNORE_CHECK /* *TODO: Get rid of this check */
-#    if FEE_DENSITY_MAX_SIZE > (FEE_MCU_FLASH_SIZE * 1024)
-#        pragma message STR(FEE_DENSITY_MAX_SIZE) " > " STR(FEE_MCU_FLASH_SIZE * 1024)
-#        error emulated eeprom: FEE_DENSITY_MAX_SIZE is greater than available flash size
+#    if (FEE_PAGE_COUNT * FEE_PAGE_SIZE) > (FEE_MCU_FLASH_SIZE * 1024)
+#        pragma message STR(FEE_PAGE_COUNT * FEE_PAGE_SIZE) " > " STR(FEE_MCU_FLASH_SIZE * 1024)
+#        error emulated eeprom: FEE_PAGE_COUNT * FEE_PAGE_SIZE is greater than available flash size
 #    endif
 #endif
 
+/* Pages are split into banks. With background compaction there are two, so one can be compacted into while the other is in use */
+#ifdef FEE_BACKGROUND_COMPACTION
+#    if (FEE_PAGE_COUNT < 2) || ((FEE_PAGE_COUNT % 2) == 1)
+#        error emulated eeprom: FEE_BACKGROUND_COMPACTION requires an even FEE_PAGE_COUNT
+#    endif
+#    define FEE_BANK_COUNT 2
+/* Each bank starts with a header: a sequence number, followed by a word cleared once compaction into the bank has completed */
+#    define FEE_BANK_HEADER_BYTES 4
+#else
+#    define FEE_BANK_COUNT 1
+#    define FEE_BANK_HEADER_BYTES 0
+#endif
+
+/* Size of a single bank */
+#define FEE_BANK_PAGE_COUNT (FEE_PAGE_COUNT / FEE_BANK_COUNT)
+#define FEE_BANK_SIZE (FEE_BANK_PAGE_COUNT * FEE_PAGE_SIZE)
+
+/* Size of combined compacted eeprom and write log pages */
+#define FEE_DENSITY_MAX_SIZE (FEE_BANK_SIZE - FEE_BANK_HEADER_BYTES)
+
 /* Size of emulated eeprom */
 #ifdef FEE_DENSITY_BYTES
 #    if (FEE_DENSITY_BYTES > FEE_DENSITY_MAX_SIZE)
@@ -179,7 +220,7 @@
 #    endif
 #else
 /* Default to half of allocated space used for emulated eeprom, half for write log */
-#    define FEE_DENSITY_BYTES (FEE_PAGE_COUNT * FEE_PAGE_SIZE / 2)
+#    define FEE_DENSITY_BYTES ((FEE_DENSITY_MAX_SIZE / 2) & ~1)
 #endif
 
 /* Size of write log */
@@ -193,29 +234,72 @@
 #    endif
 #else
 /* Default to use all remaining space */
-#    define FEE_WRITE_LOG_BYTES (FEE_PAGE_COUNT * FEE_PAGE_SIZE - FEE_DENSITY_BYTES)
+#    define FEE_WRITE_LOG_BYTES (FEE_DENSITY_MAX_SIZE - FEE_DENSITY_BYTES)
 #endif
 
+/* Start of a bank */
+#define FEE_BANK_BASE_ADDRESS(bank) (FEE_PAGE_BASE_ADDRESS + (bank)*FEE_BANK_SIZE)
 /* Start of the emulated eeprom compacted flash area */
-#define FEE_COMPACTED_BASE_ADDRESS FEE_PAGE_BASE_ADDRESS
+#define FEE_COMPACTED_BASE_ADDRESS(bank) (FEE_BANK_BASE_ADDRESS(bank) + FEE_BANK_HEADER_BYTES)
 /* End of the emulated eeprom compacted flash area */
-#define FEE_COMPACTED_LAST_ADDRESS (FEE_COMPACTED_BASE_ADDRESS + FEE_DENSITY_BYTES)
+#define FEE_COMPACTED_LAST_ADDRESS(bank) (FEE_COMPACTED_BASE_ADDRESS(bank) + FEE_DENSITY_BYTES)
 /* Start of the emulated eeprom write log */
-#define FEE_WRITE_LOG_BASE_ADDRESS FEE_COMPACTED_LAST_ADDRESS
+#define FEE_WRITE_LOG_BASE_ADDRESS(bank) FEE_COMPACTED_LAST_ADDRESS(bank)
 /* End of the emulated eeprom write log */
-#define FEE_WRITE_LOG_LAST_ADDRESS (FEE_WRITE_LOG_BASE_ADDRESS + FEE_WRITE_LOG_BYTES)
+#define FEE_WRITE_LOG_LAST_ADDRESS(bank) (FEE_WRITE_LOG_BASE_ADDRESS(bank) + FEE_WRITE_LOG_BYTES)
 
 #if defined(DYNAMIC_KEYMAP_EEPROM_MAX_ADDR) && (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR >= FEE_DENSITY_BYTES)
 #    error emulated eeprom: DYNAMIC_KEYMAP_EEPROM_MAX_ADDR is greater than the FEE_DENSITY_BYTES available
 #endif
 
+#ifdef FEE_BACKGROUND_COMPACTION
+/* Write log usage at which compaction into the other bank is started in the background */
+#    ifndef FEE_COMPACTION_THRESHOLD
+#        define FEE_COMPACTION_THRESHOLD (FEE_WRITE_LOG_BYTES / 2)
+#    endif
+/* Number of words copied into the other bank per call to EEPROM_Task() */
+#    ifndef FEE_COMPACTION_SLICE_WORDS
+#        define FEE_COMPACTION_SLICE_WORDS 64
+#    endif
+#endif
+
+#ifdef FEE_WRITE_BEHIND_DELAY
+#    include "timer.h"
+/* Number of changed words written to flash per call to EEPROM_Task() */
+#    ifndef FEE_WRITE_BEHIND_SLICE_WORDS
+#        define FEE_WRITE_BEHIND_SLICE_WORDS 16
+#    endif
+#endif
+
 /* In-memory contents of emulated eeprom for faster access */
 /* *TODO: Implement page swapping */
 static uint16_t WordBuf[FEE_DENSITY_BYTES / 2];
 static uint8_t *DataBuf = (uint8_t *)WordBuf;
 
-/* Pointer to the first available slot within the write log */
-static uint16_t *empty_slot;
+/* Bank which currently holds the emulated eeprom contents */
+static uint8_t active_bank = 0;
+
+/* Pointer to the first available slot within the write log of each bank */
+static uint16_t *empty_slot[FEE_BANK_COUNT];
+
+#ifdef FEE_BACKGROUND_COMPACTION
+typedef enum {
+    FEE_COMPACTION_IDLE,
+    FEE_COMPACTION_ERASE,
+    FEE_COMPACTION_COPY,
+} fee_compaction_state_t;
+
+static fee_compaction_state_t compaction_state = FEE_COMPACTION_IDLE;
+/* Next page to erase, or next address to copy, within the bank being compacted into */
+static uint16_t compaction_cursor = 0;
+#endif
+
+#ifdef FEE_WRITE_BEHIND_DELAY
+/* One bit per word of DataBuf which has not been written to flash yet */
+static uint8_t  dirty_words[(FEE_DENSITY_BYTES / 2 + 7) / 8];
+static uint16_t dirty_count     = 0;
+static uint32_t last_write_time = 0;
+#endif
 
 // #define DEBUG_EEPROM_OUTPUT
 
@@ -275,11 +359,41 @@ void print_eeprom(void) {
 #endif
 }
 
+#ifdef FEE_BACKGROUND_COMPACTION
+/* A bank is only used once compaction into it has completed */
+static bool eeprom_bank_is_complete(uint8_t bank) {
+    uint16_t *header = (uint16_t *)FEE_BANK_BASE_ADDRESS(bank);
+    return header[0] != FEE_EMPTY_WORD && header[1] == 0;
+}
+
+static uint8_t eeprom_find_active_bank(void) {
+    bool complete0 = eeprom_bank_is_complete(0);
+    bool complete1 = eeprom_bank_is_complete(1);
+    if (complete0 && complete1) {
+        /* Both are complete if power was lost before the older one got erased; use the most recent */
+        uint16_t sequence0 = *(uint16_t *)FEE_BANK_BASE_ADDRESS(0);
+        uint16_t sequence1 = *(uint16_t *)FEE_BANK_BASE_ADDRESS(1);
+        return (int16_t)(sequence1 - sequence0) > 0 ? 1 : 0;
+    }
+    /* Freshly erased flash has no complete bank, and starts out in the first */
+    return complete1 ? 1 : 0;
+}
+#endif
+
 uint16_t EEPROM_Init(void) {
+#ifdef FEE_BACKGROUND_COMPACTION
+    active_bank      = eeprom_find_active_bank();
+    compaction_state = FEE_COMPACTION_IDLE;
+#endif
+#ifdef FEE_WRITE_BEHIND_DELAY
+    memset(dirty_words, 0, sizeof(dirty_words));
+    dirty_count = 0;
+#endif
+
     /* Load emulated eeprom contents from compacted flash into memory */
-    uint16_t *src  = (uint16_t *)FEE_COMPACTED_BASE_ADDRESS;
+    uint16_t *src  = (uint16_t *)FEE_COMPACTED_BASE_ADDRESS(active_bank);
     uint16_t *dest = (uint16_t *)DataBuf;
-    for (; src < (uint16_t *)FEE_COMPACTED_LAST_ADDRESS; ++src, ++dest) {
+    for (; src < (uint16_t *)FEE_COMPACTED_LAST_ADDRESS(active_bank); ++src, ++dest) {
         *dest = ~*src;
     }
 
@@ -291,7 +405,7 @@ uint16_t EEPROM_Init(void) {
 
     /* Replay write log */
     uint16_t *log_addr;
-    for (log_addr = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS; log_addr < (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS; ++log_addr) {
+    for (log_addr = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS(active_bank); log_addr < (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(active_bank); ++log_addr) {
         uint16_t address = *log_addr;
         if (address == FEE_EMPTY_WORD) {
             break;
@@ -307,7 +421,7 @@ uint16_t EEPROM_Init(void) {
             /* Check if value is in next word */
             if ((address & FEE_VALUE_NEXT) == FEE_VALUE_NEXT) {
                 /* Read value from next word */
-                if (++log_addr >= (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS) {
+                if (++log_addr >= (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(active_bank)) {
                     break;
                 }
                 wvalue = ~*log_addr;
@@ -340,7 +454,7 @@ uint16_t EEPROM_Init(void) {
         }
     }
 
-    empty_slot = log_addr;
+    empty_slot[active_bank] = log_addr;
 
     if (debug_eeprom) {
         println("EEPROM_Init Final DataBuf:");
@@ -361,8 +475,9 @@ static void eeprom_clear(void) {
 
     FLASH_Lock();
 
-    empty_slot = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS;
-    eeprom_printf("eeprom_clear empty_slot: 0x%08x\n", (uint32_t)empty_slot);
+    active_bank             = 0;
+    empty_slot[active_bank] = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS(active_bank);
+    eeprom_printf("eeprom_clear empty_slot: 0x%08x\n", (uint32_t)empty_slot[active_bank]);
 }
 
 /* Erase emulated eeprom */
@@ -374,8 +489,85 @@ void EEPROM_Erase(void) {
     EEPROM_Init();
 }
 
+#ifdef FEE_BACKGROUND_COMPACTION
+static void eeprom_compaction_start(void) {
+    eeprom_println("eeprom_compaction_start");
+    compaction_state  = FEE_COMPACTION_ERASE;
+    compaction_cursor = 0;
+}
+
+/* Performs a bounded amount of work towards moving the contents of DataBuf into the other bank */
+static uint8_t eeprom_compaction_step(void) {
+    uint8_t      bank   = active_bank ^ 1;
+    FLASH_Status status = FLASH_COMPLETE;
+
+    FLASH_Unlock();
+
+    if (compaction_state == FEE_COMPACTION_ERASE) {
+        /* The first page holds the header, so the bank is invalidated before anything else is touched */
+        uintptr_t page = FEE_BANK_BASE_ADDRESS(bank) + (compaction_cursor * FEE_PAGE_SIZE);
+        eeprom_printf("FLASH_ErasePage(0x%04x)\n", (uint32_t)page);
+        status = FLASH_ErasePage(page);
+
+        if (++compaction_cursor == FEE_BANK_PAGE_COUNT) {
+            /* Claim the bank with the next sequence number; the old bank remains in use until this one is complete */
+            uint16_t sequence = 0;
+            if (eeprom_bank_is_complete(active_bank)) {
+                sequence = *(uint16_t *)FEE_BANK_BASE_ADDRESS(active_bank) + 1;
+                if (sequence == FEE_EMPTY_WORD) sequence = 0;
+            }
+            FLASH_Status header_status = FLASH_ProgramHalfWord(FEE_BANK_BASE_ADDRESS(bank), sequence);
+            if (header_status != FLASH_COMPLETE) status = header_status;
+
+            empty_slot[bank]  = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS(bank);
+            compaction_state  = FEE_COMPACTION_COPY;
+            compaction_cursor = 0;
+        }
+    } else if (compaction_state == FEE_COMPACTION_COPY) {
+        /* Write emulated eeprom contents from memory to compacted flash */
+        for (uint16_t words = 0; words < FEE_COMPACTION_SLICE_WORDS && compaction_cursor < FEE_DENSITY_BYTES; ++words, compaction_cursor += 2) {
+            uint16_t value = *(uint16_t *)(&DataBuf[compaction_cursor]);
+            if (value) {
+                FLASH_Status word_status = FLASH_ProgramHalfWord(FEE_COMPACTED_BASE_ADDRESS(bank) + compaction_cursor, ~value);
+                if (word_status != FLASH_COMPLETE) status = word_status;
+            }
+        }
+
+        if (compaction_cursor >= FEE_DENSITY_BYTES) {
+            /* Mark the bank complete, and switch over to it */
+            FLASH_Status header_status = FLASH_ProgramHalfWord(FEE_BANK_BASE_ADDRESS(bank) + 2, 0);
+            if (header_status != FLASH_COMPLETE) status = header_status;
+
+            active_bank      = bank;
+            compaction_state = FEE_COMPACTION_IDLE;
+            eeprom_printf("eeprom_compaction complete, bank %d\n", bank);
+        }
+    }
+
+    FLASH_Lock();
+
+    if (status != FLASH_COMPLETE) {
+        /* Leave the bank incomplete, and start over next time */
+        eeprom_printf("eeprom_compaction_step [STATUS == %d]\n", status);
+        compaction_state = FEE_COMPACTION_IDLE;
+    }
+    return status;
+}
+#endif
+
 /* Compact write log */
 static uint8_t eeprom_compact(void) {
+#ifdef FEE_BACKGROUND_COMPACTION
+    /* Finish off any compaction already in progress, otherwise run a full one */
+    if (compaction_state == FEE_COMPACTION_IDLE) {
+        eeprom_compaction_start();
+    }
+
+    FLASH_Status final_status = FLASH_COMPLETE;
+    while (compaction_state != FEE_COMPACTION_IDLE) {
+        final_status = eeprom_compaction_step();
+    }
+#else
     /* Erase compacted pages and write log */
     eeprom_clear();
 
@@ -385,9 +577,9 @@ static uint8_t eeprom_compact(void) {
 
     /* Write emulated eeprom contents from memory to compacted flash */
     uint16_t *src  = (uint16_t *)DataBuf;
-    uintptr_t dest = FEE_COMPACTED_BASE_ADDRESS;
+    uintptr_t dest = FEE_COMPACTED_BASE_ADDRESS(active_bank);
     uint16_t  value;
-    for (; dest < FEE_COMPACTED_LAST_ADDRESS; ++src, dest += 2) {
+    for (; dest < FEE_COMPACTED_LAST_ADDRESS(active_bank); ++src, dest += 2) {
         value = *src;
         if (value) {
             eeprom_printf("FLASH_ProgramHalfWord(0x%04x, 0x%04x)\n", (uint32_t)dest, ~value);
@@ -397,6 +589,7 @@ static uint8_t eeprom_compact(void) {
     }
 
     FLASH_Lock();
+#endif
 
     if (debug_eeprom) {
         println("eeprom_compacted:");
@@ -406,9 +599,23 @@ static uint8_t eeprom_compact(void) {
     return final_status;
 }
 
-static uint8_t eeprom_write_direct_entry(uint16_t Address) {
+/* Called when the write log of a bank has no room left */
+static uint8_t eeprom_write_log_full(uint8_t bank) {
+#ifdef FEE_BACKGROUND_COMPACTION
+    if (bank != active_bank) {
+        /* The bank being compacted into filled up before it was complete, give up on it and start over later */
+        eeprom_println("eeprom_write_log_full [ABORT COMPACTION]");
+        compaction_state = FEE_COMPACTION_IDLE;
+        return FLASH_COMPLETE;
+    }
+#endif
+    /* compact the write log into the compacted flash area */
+    return eeprom_compact();
+}
+
+static uint8_t eeprom_write_direct_entry(uint8_t bank, uint16_t Address) {
     /* Check if we can just write this directly to the compacted flash area */
-    uintptr_t directAddress = FEE_COMPACTED_BASE_ADDRESS + (Address & 0xFFFE);
+    uintptr_t directAddress = FEE_COMPACTED_BASE_ADDRESS(bank) + (Address & 0xFFFE);
     if (*(uint16_t *)directAddress == FEE_EMPTY_WORD) {
         /* Write the value directly to the compacted area without a log entry */
         uint16_t value = ~*(uint16_t *)(&DataBuf[Address & 0xFFFE]);
@@ -426,7 +633,7 @@ static uint8_t eeprom_write_direct_entry(uint16_t Address) {
     return 0;
 }
 
-static uint8_t eeprom_write_log_word_entry(uint16_t Address) {
+static uint8_t eeprom_write_log_word_entry(uint8_t bank, uint16_t Address) {
     FLASH_Status final_status = FLASH_COMPLETE;
 
     uint16_t value = *(uint16_t *)(&DataBuf[Address]);
@@ -446,9 +653,8 @@ static uint8_t eeprom_write_log_word_entry(uint16_t Address) {
     }
 
     /* if we can't find an empty spot, we must compact emulated eeprom */
-    if (empty_slot > (uint16_t *)(FEE_WRITE_LOG_LAST_ADDRESS - entry_size)) {
-        /* compact the write log into the compacted flash area */
-        return eeprom_compact();
+    if (empty_slot[bank] > (uint16_t *)(FEE_WRITE_LOG_LAST_ADDRESS(bank) - entry_size)) {
+        return eeprom_write_log_full(bank);
     }
 
     /* Word log writes should be word-aligned.  Take back a bit */
@@ -459,13 +665,13 @@ static uint8_t eeprom_write_log_word_entry(uint16_t Address) {
     FLASH_Unlock();
 
     /* address */
-    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot, Address);
-    final_status = FLASH_ProgramHalfWord((uintptr_t)empty_slot++, Address);
+    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot[bank], Address);
+    final_status = FLASH_ProgramHalfWord((uintptr_t)empty_slot[bank]++, Address);
 
     /* value */
     if (encoding == (FEE_WORD_ENCODING | FEE_VALUE_NEXT)) {
-        eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot, ~value);
-        FLASH_Status status = FLASH_ProgramHalfWord((uintptr_t)empty_slot++, ~value);
+        eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot[bank], ~value);
+        FLASH_Status status = FLASH_ProgramHalfWord((uintptr_t)empty_slot[bank]++, ~value);
         if (status != FLASH_COMPLETE) final_status = status;
     }
 
@@ -474,13 +680,12 @@ static uint8_t eeprom_write_log_word_entry(uint16_t Address) {
     return final_status;
 }
 
-static uint8_t eeprom_write_log_byte_entry(uint16_t Address) {
+static uint8_t eeprom_write_log_byte_entry(uint8_t bank, uint16_t Address) {
     eeprom_printf("eeprom_write_log_byte_entry(0x%04x): 0x%02x\n", Address, DataBuf[Address]);
 
     /* if couldn't find an empty spot, we must compact emulated eeprom */
-    if (empty_slot >= (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS) {
-        /* compact the write log into the compacted flash area */
-        return eeprom_compact();
+    if (empty_slot[bank] >= (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS(bank)) {
+        return eeprom_write_log_full(bank);
     }
 
     /* ok we found a place let's write our data */
@@ -490,14 +695,74 @@ static uint8_t eeprom_write_log_byte_entry(uint16_t Address) {
     uint16_t value = (Address << 8) | DataBuf[Address];
 
     /* write to flash */
-    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot, value);
-    FLASH_Status status = FLASH_ProgramHalfWord((uintptr_t)empty_slot++, value);
+    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot[bank], value);
+    FLASH_Status status = FLASH_ProgramHalfWord((uintptr_t)empty_slot[bank]++, value);
 
     FLASH_Lock();
 
     return status;
 }
 
+#if defined(FEE_BACKGROUND_COMPACTION) || defined(FEE_WRITE_BEHIND_DELAY)
+/* Writes the current DataBuf contents of a whole (aligned) word to a bank */
+static uint8_t eeprom_write_word_entry(uint8_t bank, uint16_t Address) {
+    FLASH_Status status = eeprom_write_direct_entry(bank, Address);
+    if (!status) {
+        if (Address < FEE_BYTE_RANGE && *(uint16_t *)(&DataBuf[Address]) > 1) {
+            status = eeprom_write_log_byte_entry(bank, Address);
+            if (status == FLASH_COMPLETE) status = eeprom_write_log_byte_entry(bank, Address + 1);
+        } else {
+            status = eeprom_write_log_word_entry(bank, Address);
+        }
+    }
+    return status;
+}
+#endif
+
+/* Keeps a bank being compacted into up to date with changes to the part of it which has already been copied */
+static inline void eeprom_compaction_track(uint16_t Address) {
+#ifdef FEE_BACKGROUND_COMPACTION
+    if (compaction_state == FEE_COMPACTION_COPY && (Address & 0xFFFE) < compaction_cursor) {
+        eeprom_write_word_entry(active_bank ^ 1, Address & 0xFFFE);
+    }
+#endif
+}
+
+#ifdef FEE_WRITE_BEHIND_DELAY
+static void eeprom_mark_dirty(uint16_t Address) {
+    uint16_t word = Address >> 1;
+    uint8_t  mask = 1 << (word % 8);
+    if (!(dirty_words[word / 8] & mask)) {
+        dirty_words[word / 8] |= mask;
+        ++dirty_count;
+    }
+    last_write_time = timer_read32();
+}
+
+/* Writes up to max_words changed words to flash, lowest address first */
+static uint8_t eeprom_write_behind_flush(uint16_t max_words) {
+    FLASH_Status final_status = FLASH_COMPLETE;
+    for (uint16_t index = 0; index < sizeof(dirty_words) && dirty_count > 0 && max_words > 0; ++index) {
+        if (!dirty_words[index]) {
+            continue;
+        }
+        for (uint8_t bit = 0; bit < 8 && max_words > 0; ++bit) {
+            if (dirty_words[index] & (1 << bit)) {
+                dirty_words[index] &= ~(1 << bit);
+                --dirty_count;
+                --max_words;
+
+                uint16_t Address = ((index * 8) + bit) * 2;
+                eeprom_compaction_track(Address);
+                FLASH_Status status = eeprom_write_word_entry(active_bank, Address);
+                if (status != 0 && status != FLASH_COMPLETE) final_status = status;
+            }
+        }
+    }
+    return final_status;
+}
+#endif
+
 uint8_t EEPROM_WriteDataByte(uint16_t Address, uint8_t DataByte) {
     /* if the address is out-of-bounds, do nothing */
     if (Address >= FEE_DENSITY_BYTES) {
@@ -515,21 +780,29 @@ uint8_t EEPROM_WriteDataByte(uint16_t Address, uint8_t DataByte) {
     DataBuf[Address] = DataByte;
     eeprom_printf("EEPROM_WriteDataByte DataBuf[0x%04x] = 0x%02x\n", Address, DataBuf[Address]);
 
+#ifdef FEE_WRITE_BEHIND_DELAY
+    /* defer the write into flash memory */
+    eeprom_mark_dirty(Address);
+    return FLASH_COMPLETE;
+#else
+    eeprom_compaction_track(Address);
+
     /* perform the write into flash memory */
     /* First, attempt to write directly into the compacted flash area */
-    FLASH_Status status = eeprom_write_direct_entry(Address);
+    FLASH_Status status = eeprom_write_direct_entry(active_bank, Address);
     if (!status) {
         /* Otherwise append to the write log */
         if (Address < FEE_BYTE_RANGE) {
-            status = eeprom_write_log_byte_entry(Address);
+            status = eeprom_write_log_byte_entry(active_bank, Address);
         } else {
-            status = eeprom_write_log_word_entry(Address & 0xFFFE);
+            status = eeprom_write_log_word_entry(active_bank, Address & 0xFFFE);
         }
     }
     if (status != 0 && status != FLASH_COMPLETE) {
         eeprom_printf("EEPROM_WriteDataByte [STATUS == %d]\n", status);
     }
     return status;
+#endif
 }
 
 uint8_t EEPROM_WriteDataWord(uint16_t Address, uint16_t DataWord) {
@@ -562,9 +835,16 @@ uint8_t EEPROM_WriteDataWord(uint16_t Address, uint16_t DataWord) {
     *(uint16_t *)(&DataBuf[Address]) = DataWord;
     eeprom_printf("EEPROM_WriteDataWord DataBuf[0x%04x] = 0x%04x\n", Address, *(uint16_t *)(&DataBuf[Address]));
 
+#ifdef FEE_WRITE_BEHIND_DELAY
+    /* defer the write into flash memory */
+    eeprom_mark_dirty(Address);
+    return FLASH_COMPLETE;
+#else
+    eeprom_compaction_track(Address);
+
     /* perform the write into flash memory */
     /* First, attempt to write directly into the compacted flash area */
-    final_status = eeprom_write_direct_entry(Address);
+    final_status = eeprom_write_direct_entry(active_bank, Address);
     if (!final_status) {
         /* Otherwise append to the write log */
         /* Check if we need to fall back to byte write */
@@ -572,22 +852,23 @@ uint8_t EEPROM_WriteDataWord(uint16_t Address, uint16_t DataWord) {
             final_status = FLASH_COMPLETE;
             /* Only write a byte if it has changed */
             if ((uint8_t)oldValue != (uint8_t)DataWord) {
-                final_status = eeprom_write_log_byte_entry(Address);
+                final_status = eeprom_write_log_byte_entry(active_bank, Address);
             }
             FLASH_Status status = FLASH_COMPLETE;
             /* Only write a byte if it has changed */
             if ((oldValue >> 8) != (DataWord >> 8)) {
-                status = eeprom_write_log_byte_entry(Address + 1);
+                status = eeprom_write_log_byte_entry(active_bank, Address + 1);
             }
             if (status != FLASH_COMPLETE) final_status = status;
         } else {
-            final_status = eeprom_write_log_word_entry(Address);
+            final_status = eeprom_write_log_word_entry(active_bank, Address);
         }
     }
     if (final_status != 0 && final_status != FLASH_COMPLETE) {
         eeprom_printf("EEPROM_WriteDataWord [STATUS == %d]\n", final_status);
     }
     return final_status;
+#endif
 }
 
 uint8_t EEPROM_ReadDataByte(uint16_t Address) {
@@ -619,6 +900,31 @@ uint16_t EEPROM_ReadDataWord(uint16_t Address) {
     return DataWord;
 }
 
+void EEPROM_Task(void) {
+#ifdef FEE_WRITE_BEHIND_DELAY
+    /* Write back once the burst of changes is over */
+    if (dirty_count > 0 && timer_elapsed32(last_write_time) >= FEE_WRITE_BEHIND_DELAY) {
+        eeprom_write_behind_flush(FEE_WRITE_BEHIND_SLICE_WORDS);
+    }
+#endif
+
+#ifdef FEE_BACKGROUND_COMPACTION
+    if (compaction_state == FEE_COMPACTION_IDLE) {
+        if ((uintptr_t)empty_slot[active_bank] - FEE_WRITE_LOG_BASE_ADDRESS(active_bank) >= FEE_COMPACTION_THRESHOLD) {
+            eeprom_compaction_start();
+        }
+    } else {
+        eeprom_compaction_step();
+    }
+#endif
+}
+
+void EEPROM_Flush(void) {
+#ifdef FEE_WRITE_BEHIND_DELAY
+    eeprom_write_behind_flush(FEE_DENSITY_BYTES / 2);
+#endif
+}
+
 /*****************************************************************************
  *  Bind to eeprom_driver.c
  *******************************************************************************/
@@ -626,6 +932,10 @@ void eeprom_driver_init(void) { EEPROM_Init(); }
 
 void eeprom_driver_erase(void) { EEPROM_Erase(); }
 
+void eeprom_driver_task(void) { EEPROM_Task(); }
+
+void eeprom_driver_flush(void) { EEPROM_Flush(); }
+
 void eeprom_read_block(void *buf, const void *addr, size_t len) {
     const uint8_t *src  = (const uint8_t *)addr;
     uint8_t *      dest = (uint8_t *)buf;
@@ -25,7 +25,19 @@ extern "C" {
 #include <stdint.h>
 
 #ifdef FLASH_STM32_MOCKED
+/* Typical STM32F303 page erase and half-word program times, in microseconds */
+#    ifndef MOCK_FLASH_ERASE_TIME
+#        define MOCK_FLASH_ERASE_TIME 20000
+#    endif
+#    ifndef MOCK_FLASH_PROGRAM_TIME
+#        define MOCK_FLASH_PROGRAM_TIME 50
+#    endif
+
 extern uint8_t FlashBuf[MOCK_FLASH_SIZE];
+/* Flash operation counters, and the time the flash would have been busy for in microseconds */
+extern uint32_t FlashPagesErased;
+extern uint32_t FlashHalfWordsProgrammed;
+extern uint32_t FlashBusyTime;
 #endif
 
 typedef enum { FLASH_BUSY = 1, FLASH_ERROR_PG, FLASH_ERROR_WRP, FLASH_ERROR_OPT, FLASH_COMPLETE, FLASH_TIMEOUT, FLASH_BAD_ADDRESS } FLASH_Status;
@@ -37,7 +37,7 @@ typedef ioline_t pin_t;
 
 /* Operation of GPIO by port. */
 
-typedef uint16_t port_data_t;
+typedef ioportmask_t port_data_t;
 
 #define readPort(pin) palReadPort(PAL_PORT(pin))
 
@@ -48,3 +48,8 @@ typedef uint16_t port_data_t;
 
 #define writePortBitLow(pin, bit) palClearLine(PAL_LINE(PAL_PORT(pin), bit))
 #define writePortBitHigh(pin, bit) palSetLine(PAL_LINE(PAL_PORT(pin), bit))
+
+/* Grouping of pins by port. */
+
+#define isSamePort(pin_a, pin_b) (PAL_PORT(pin_a) == PAL_PORT(pin_b))
+#define getPortBit(pin) PAL_PAD(pin)
@@ -0,0 +1,23 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include "idle_wait.h"
+
+#define IDLE_WAIT_WAKEUP_EVENT EVENT_MASK(0)
+
+static thread_t *waiting_thread = NULL;
+
+void idle_wakeup_from_isr(void) {
+    osalSysLockFromISR();
+    if (waiting_thread != NULL) {
+        // Events are sticky, so a wakeup arriving just before the wait starts isn't lost
+        chEvtSignalI(waiting_thread, IDLE_WAIT_WAKEUP_EVENT);
+    }
+    osalSysUnlockFromISR();
+}
+
+void platform_idle_wait(uint32_t timeout_ms) {
+    waiting_thread = chThdGetSelfX();
+    chEvtWaitAnyTimeout(IDLE_WAIT_WAKEUP_EVENT, TIME_MS2I(timeout_ms));
+}
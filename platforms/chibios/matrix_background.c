@@ -0,0 +1,63 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include "matrix.h"
+
+#ifndef MATRIX_IO_DELAY
+#    define MATRIX_IO_DELAY 30
+#endif
+
+// The scan waits MATRIX_IO_DELAY after unselecting each row (or column, with ROW2COL diodes), so it can't run faster than that
+#if defined(DIRECT_PINS)
+#    define MATRIX_BACKGROUND_SCAN_MIN_US 0
+#elif defined(DIODE_DIRECTION) && (DIODE_DIRECTION == ROW2COL)
+#    define MATRIX_BACKGROUND_SCAN_MIN_US (MATRIX_COLS * MATRIX_IO_DELAY)
+#elif defined(SPLIT_KEYBOARD)
+#    define MATRIX_BACKGROUND_SCAN_MIN_US ((MATRIX_ROWS / 2) * MATRIX_IO_DELAY)
+#else
+#    define MATRIX_BACKGROUND_SCAN_MIN_US (MATRIX_ROWS * MATRIX_IO_DELAY)
+#endif
+
+// 8kHz by default, or a quarter more than the scan takes if that is longer, rounded up to the resolution of the system tick (CH_CFG_ST_FREQUENCY)
+#ifndef MATRIX_BACKGROUND_SCAN_INTERVAL_US
+#    if MATRIX_BACKGROUND_SCAN_MIN_US < 100
+#        define MATRIX_BACKGROUND_SCAN_INTERVAL_US 125
+#    else
+#        define MATRIX_BACKGROUND_SCAN_INTERVAL_US (MATRIX_BACKGROUND_SCAN_MIN_US + MATRIX_BACKGROUND_SCAN_MIN_US / 4)
+#    endif
+#endif
+
+#if MATRIX_BACKGROUND_SCAN_INTERVAL_US <= MATRIX_BACKGROUND_SCAN_MIN_US
+#    error MATRIX_BACKGROUND_SCAN_INTERVAL_US must be longer than the MATRIX_IO_DELAY waits of a whole scan, raise it or lower MATRIX_IO_DELAY
+#endif
+
+#ifndef MATRIX_BACKGROUND_SCAN_PRIORITY
+#    define MATRIX_BACKGROUND_SCAN_PRIORITY HIGHPRIO
+#endif
+
+static THD_WORKING_AREA(waMatrixScanThread, 256);
+
+static THD_FUNCTION(MatrixScanThread, arg) {
+    (void)arg;
+    chRegSetThreadName("matrix_scan");
+
+    systime_t prev = chVTGetSystemTime();
+    while (true) {
+        matrix_background_scan();
+
+        // Keeps to the fixed rate however long the scan took, rather than sleeping for the interval after it
+        systime_t next = chTimeAddX(prev, TIME_US2I(MATRIX_BACKGROUND_SCAN_INTERVAL_US));
+        systime_t now  = chVTGetSystemTime();
+        if (!chTimeIsInRangeX(now, prev, next)) {
+            // The window was missed, for example because the scan was preempted or an override of
+            // matrix_output_unselect_delay() waits longer. Start again from now instead of scanning
+            // back to back to catch up, which would also starve every lower priority thread.
+            prev = now;
+            next = chTimeAddX(now, TIME_US2I(MATRIX_BACKGROUND_SCAN_INTERVAL_US));
+        }
+        prev = chThdSleepUntilWindowed(prev, next);
+    }
+}
+
+void matrix_background_start(void) { chThdCreateStatic(waMatrixScanThread, sizeof(waMatrixScanThread), MATRIX_BACKGROUND_SCAN_PRIORITY, MatrixScanThread, NULL); }
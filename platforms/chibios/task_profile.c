@@ -0,0 +1,16 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include "platform_deps.h"
+#include "task_profile.h"
+
+#if (PORT_SUPPORTS_RT == TRUE) && defined(CPU_CLOCK)
+// The realtime counter runs at the core clock, e.g. the DWT cycle counter on ARMv7-M
+uint32_t task_profile_timer_read(void) { return (uint32_t)chSysGetRealtimeCounterX(); }
+uint32_t task_profile_timer_elapsed_us(uint32_t start) { return ((uint32_t)chSysGetRealtimeCounterX() - start) / (CPU_CLOCK / 1000000UL); }
+#else
+// Otherwise use the system tick, at CH_CFG_ST_FREQUENCY resolution
+uint32_t task_profile_timer_read(void) { return (uint32_t)chVTGetSystemTimeX(); }
+uint32_t task_profile_timer_elapsed_us(uint32_t start) { return TIME_I2US(chVTTimeElapsedSinceX((systime_t)start)); }
+#endif
@@ -0,0 +1,24 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// The host runs everything on a single thread, so there is nothing to protect against
+#define ATOMIC_BLOCK(type) for (uint8_t __ToDo = 1; __ToDo; __ToDo = 0)
+#define ATOMIC_BLOCK_RESTORESTATE ATOMIC_BLOCK(0)
+#define ATOMIC_BLOCK_FORCEON ATOMIC_BLOCK(0)
@@ -14,12 +14,20 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 extern "C" {
 #include "flash_stm32.h"
 #include "eeprom_stm32.h"
 #include "eeprom.h"
+
+void advance_time(uint32_t ms);
 }
 
 /* Mock Flash Parameters:
@@ -44,12 +52,31 @@ extern "C" {
  * [Unused | Compact |  Write Log  ]
  * [0......|512......|768......1023]
  *
+ * === Background Layout ===
+ * flash size: 65536
+ * page size: 2048
+ * density pages: 16, as two banks of 8
+ * Simulated EEPROM size: 8190
+ *
+ * FlashBuf Layout:
+ * [Unused | Header | Compact | Write Log | Header | Compact | Write Log  ]
+ * [0......|32768...|32772....|40962......|49152...|49156....|57346......65535]
+ *
  */
 
-#define EEPROM_SIZE (FEE_PAGE_SIZE * FEE_PAGE_COUNT / 2)
-#define LOG_SIZE EEPROM_SIZE
-#define LOG_BASE (MOCK_FLASH_SIZE - LOG_SIZE)
-#define EEPROM_BASE (LOG_BASE - EEPROM_SIZE)
+#ifdef FEE_BACKGROUND_COMPACTION
+#    define BANK_SIZE (FEE_PAGE_SIZE * FEE_PAGE_COUNT / 2)
+#    define BANK_BASE(bank) (MOCK_FLASH_SIZE - FEE_PAGE_SIZE * FEE_PAGE_COUNT + (bank)*BANK_SIZE)
+#    define EEPROM_SIZE ((BANK_SIZE - 4) / 2)
+#    define LOG_SIZE EEPROM_SIZE
+#    define EEPROM_BASE (BANK_BASE(0) + 4)
+#    define LOG_BASE (EEPROM_BASE + EEPROM_SIZE)
+#else
+#    define EEPROM_SIZE (FEE_PAGE_SIZE * FEE_PAGE_COUNT / 2)
+#    define LOG_SIZE EEPROM_SIZE
+#    define LOG_BASE (MOCK_FLASH_SIZE - LOG_SIZE)
+#    define EEPROM_BASE (LOG_BASE - EEPROM_SIZE)
+#endif
 
 /* Log encoding helpers */
 #define BYTE_VALUE(addr, value) (((addr) << 8) | (value))
@@ -65,6 +92,12 @@ class EepromStm32Test : public testing::Test {
    protected:
     void SetUp() override { EEPROM_Erase(); }
 
+    /* Simulates a restart, keeping only what made it to flash */
+    void reload() {
+        EEPROM_Flush();
+        EEPROM_Init();
+    }
+
     void TearDown() override {
 #ifdef EEPROM_DEBUG
         dumpEepromDataBuf();
@@ -131,6 +164,8 @@ TEST_F(EepromStm32Test, TestReadByte) {
     EXPECT_EQ(EEPROM_ReadDataByte(EEPROM_SIZE - 1), 0x9a);
 }
 
+/* Checks log entries as written; with write-behind these are only written later, and a whole word at a time */
+#ifndef FEE_WRITE_BEHIND_DELAY
 TEST_F(EepromStm32Test, TestWriteByte) {
     /* Direct compacted-area baseline: Address < 0x80 */
     EEPROM_WriteDataByte(2, 0xef);
@@ -148,6 +183,8 @@ TEST_F(EepromStm32Test, TestWriteByte) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 2], WORD_NEXT(EEPROM_SIZE - 1));
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 4], (uint16_t)~0x5678);
 }
+#endif
+
 
 TEST_F(EepromStm32Test, TestByteRoundTrip) {
     /* Direct compacted-area: Address < 0x80 */
@@ -158,7 +195,7 @@ TEST_F(EepromStm32Test, TestByteRoundTrip) {
     EEPROM_WriteDataByte(EEPROM_SIZE - 2, 0x78);
     EEPROM_WriteDataByte(EEPROM_SIZE - 1, 0x56);
     /* Check values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(EEPROM_ReadDataByte(0), 0xad);
     EXPECT_EQ(EEPROM_ReadDataByte(1), 0xde);
     EXPECT_EQ(EEPROM_ReadDataByte(2), 0xef);
@@ -169,7 +206,7 @@ TEST_F(EepromStm32Test, TestByteRoundTrip) {
     EEPROM_WriteDataByte(2, 0x80);
     EEPROM_WriteDataByte(EEPROM_SIZE - 2, 0x3c);
     /* Check values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(EEPROM_ReadDataByte(2), 0x80);
     EXPECT_EQ(EEPROM_ReadDataByte(3), 0xbe);
     EXPECT_EQ(EEPROM_ReadDataByte(EEPROM_SIZE - 2), 0x3c);
@@ -207,6 +244,7 @@ TEST_F(EepromStm32Test, TestReadWord) {
     EXPECT_EQ(EEPROM_ReadDataWord(EEPROM_SIZE - 2), 0x9abc);
 }
 
+#ifndef FEE_WRITE_BEHIND_DELAY
 TEST_F(EepromStm32Test, TestWriteWord) {
     /* Direct compacted-area: Address < 0x80 */
     EEPROM_WriteDataWord(0, 0xdead);  // Aligned
@@ -249,6 +287,8 @@ TEST_F(EepromStm32Test, TestWriteWord) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 16], WORD_NEXT(204));
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 18], (uint16_t)~0x00cd);
 }
+#endif
+
 
 TEST_F(EepromStm32Test, TestWordRoundTrip) {
     /* Direct compacted-area: Address < 0x80 */
@@ -260,7 +300,7 @@ TEST_F(EepromStm32Test, TestWordRoundTrip) {
     EEPROM_WriteDataWord(EEPROM_SIZE - 4, 0x1234);
     EEPROM_WriteDataWord(EEPROM_SIZE - 2, 0x5678);
     /* Check values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(EEPROM_ReadDataWord(0), 0xdead);
     EXPECT_EQ(EEPROM_ReadDataWord(3), 0xbeef);
     EXPECT_EQ(EEPROM_ReadDataWord(200), 0xabcd);
@@ -278,7 +318,7 @@ TEST_F(EepromStm32Test, TestWordRoundTrip) {
     EEPROM_WriteDataByte(202, 0x3c);    // Set neighboring byte
     EEPROM_WriteDataWord(203, 0xcdef);  // Unaligned
     /* Check values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(EEPROM_ReadDataWord(200), 0x4321);
     EXPECT_EQ(EEPROM_ReadDataByte(202), 0x3c);
     EXPECT_EQ(EEPROM_ReadDataWord(203), 0xcdef);
@@ -286,6 +326,7 @@ TEST_F(EepromStm32Test, TestWordRoundTrip) {
     EXPECT_EQ(EEPROM_ReadDataWord(EEPROM_SIZE - 2), 1);
 }
 
+#ifndef FEE_WRITE_BEHIND_DELAY
 TEST_F(EepromStm32Test, TestByteWordBoundary) {
     /* Direct compacted-area write */
     EEPROM_WriteDataWord(0x7e, 0xdead);
@@ -295,7 +336,7 @@ TEST_F(EepromStm32Test, TestByteWordBoundary) {
     /* Word log entry */
     EEPROM_WriteDataByte(0x80, 0x18);
     /* Check values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(EEPROM_ReadDataWord(0x7e), 0x3cad);
     EXPECT_EQ(EEPROM_ReadDataWord(0x80), 0xbe18);
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE], BYTE_VALUE(0x7f, 0x3c));
@@ -304,14 +345,14 @@ TEST_F(EepromStm32Test, TestByteWordBoundary) {
     /* Byte log entries */
     EEPROM_WriteDataWord(0x7e, 0xcafe);
     /* Check values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(EEPROM_ReadDataWord(0x7e), 0xcafe);
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 6], BYTE_VALUE(0x7e, 0xfe));
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 8], BYTE_VALUE(0x7f, 0xca));
     /* Byte and Word log entries */
     EEPROM_WriteDataWord(0x7f, 0xba5e);
     /* Check values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(EEPROM_ReadDataWord(0x7f), 0xba5e);
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 10], BYTE_VALUE(0x7f, 0x5e));
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 12], WORD_NEXT(0x80));
@@ -319,11 +360,13 @@ TEST_F(EepromStm32Test, TestByteWordBoundary) {
     /* Word log entry */
     EEPROM_WriteDataWord(0x80, 0xf00d);
     /* Check values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(EEPROM_ReadDataWord(0x80), 0xf00d);
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 16], WORD_NEXT(0x80));
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 18], (uint16_t)~0xf00d);
 }
+#endif
+
 
 TEST_F(EepromStm32Test, TestDWordRoundTrip) {
     /* Direct compacted-area: Address < 0x80 */
@@ -334,7 +377,7 @@ TEST_F(EepromStm32Test, TestDWordRoundTrip) {
     eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 4), 0xba5eba11);  // Aligned
     eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 9), 0xcafed00d);  // Unaligned
     /* Check direct values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdeadbeef);
     EXPECT_EQ(eeprom_read_dword((uint32_t*)9), 0x12345678);
     EXPECT_EQ(eeprom_read_dword((uint32_t*)200), 0xfacef00d);
@@ -349,7 +392,7 @@ TEST_F(EepromStm32Test, TestDWordRoundTrip) {
     eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 4), 0xdeadc0de);  // Aligned
     eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 9), 0x6789abcd);  // Unaligned
     /* Check log values */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdecafbad);
     EXPECT_EQ(eeprom_read_dword((uint32_t*)9), 0x87654321);
     EXPECT_EQ(eeprom_read_dword((uint32_t*)200), 1);
@@ -372,7 +415,7 @@ TEST_F(EepromStm32Test, TestBlockRoundTrip) {
     eeprom_write_block(src1, (void*)201, sizeof(src0) - 1);
 
     /* Check values */
-    EEPROM_Init();
+    reload();
 
     char  dstBuf[256] = {0};
     char* dst0a       = (char*)dstBuf;
@@ -401,6 +444,7 @@ TEST_F(EepromStm32Test, TestBlockRoundTrip) {
     EXPECT_EQ(strcmp((char*)src1, dst1d), 0);
 }
 
+#ifndef FEE_BACKGROUND_COMPACTION
 TEST_F(EepromStm32Test, TestCompaction) {
     /* Direct writes */
     eeprom_write_dword((uint32_t*)0, 0xdeadbeef);
@@ -417,7 +461,7 @@ TEST_F(EepromStm32Test, TestCompaction) {
         eeprom_write_dword((uint32_t*)200, val);
     }
     /* Check values pre-compaction */
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdeadbeef);
     EXPECT_EQ(eeprom_read_byte((uint8_t*)4), 0x3c);
     EXPECT_EQ(eeprom_read_word((uint16_t*)6), 0xd00d);
@@ -427,7 +471,7 @@ TEST_F(EepromStm32Test, TestCompaction) {
     EXPECT_NE(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 2], 0xFFFF);
     /* Run compaction */
     eeprom_write_byte((uint8_t*)4, 0x1f);
-    EEPROM_Init();
+    reload();
     EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xdeadbeef);
     EXPECT_EQ(eeprom_read_byte((uint8_t*)4), 0x1f);
     EXPECT_EQ(eeprom_read_word((uint16_t*)6), 0xd00d);
@@ -436,3 +480,141 @@ TEST_F(EepromStm32Test, TestCompaction) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE], 0xFFFF);
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 2], 0xFFFF);
 }
+#endif
+
+
+/* Writes a burst of settings, then lets the main loop run for a while, measuring how long each call keeps the flash busy */
+TEST_F(EepromStm32Test, TestWorstCaseStall) {
+    std::mt19937         rng(0x5eed);
+    std::vector<uint8_t> expected(EEPROM_SIZE, 0);
+    uint32_t             changed = 0;
+    uint32_t             stall   = 0;
+    uint32_t             erased  = FlashPagesErased;
+    uint32_t             written = FlashHalfWordsProgrammed;
+
+    auto measure = [&](std::function<void()> call) {
+        uint32_t start = FlashBusyTime;
+        call();
+        stall = std::max(stall, FlashBusyTime - start);
+    };
+
+    for (int burst = 0; burst < 200; ++burst) {
+        /* A handful of neighbouring settings, written over and over, like eeconfig or a dynamic keymap */
+        uint16_t base = std::uniform_int_distribution<uint16_t>(0, std::min(EEPROM_SIZE, 1024) - 32)(rng);
+        for (int i = 0; i < 64; ++i) {
+            uint16_t address = base + std::uniform_int_distribution<uint16_t>(0, 31)(rng);
+            uint8_t  value   = rng();
+            if (expected[address] != value) ++changed;
+            expected[address] = value;
+            measure([&] { eeprom_update_byte((uint8_t*)(uintptr_t)address, value); });
+            measure([&] { EEPROM_Task(); });
+        }
+        for (int i = 0; i < 200; ++i) {
+            advance_time(1);
+            measure([&] { EEPROM_Task(); });
+        }
+    }
+
+    double amplification = (FlashHalfWordsProgrammed - written) * 2.0 / changed;
+    std::cout << "[ BENCHMARK] worst case stall " << stall << "us, " << (FlashPagesErased - erased) << " pages erased, " << amplification << " bytes programmed per byte changed" << std::endl;
+
+#ifdef FEE_BACKGROUND_COMPACTION
+    /* Never more than a page erase, or a slice of copying plus the odd log entry */
+    EXPECT_LE(stall, MOCK_FLASH_ERASE_TIME + MOCK_FLASH_PROGRAM_TIME * 80);
+#endif
+
+    reload();
+    for (uint16_t address = 0; address < EEPROM_SIZE; ++address) {
+        ASSERT_EQ(EEPROM_ReadDataByte(address), expected[address]) << "address " << address;
+    }
+}
+
+#ifdef FEE_BACKGROUND_COMPACTION
+TEST_F(EepromStm32Test, TestBackgroundCompaction) {
+    eeprom_write_dword((uint32_t*)0, 0xdeadbeef);
+    eeprom_write_dword((uint32_t*)200, 0xcafef00d);
+    /* Fill the write log up to the threshold */
+    uint32_t val = 0xd8453c6b;
+    for (uint32_t i = 0; i < LOG_SIZE / 2 / 8 + 2; i++) {
+        val ^= 0x593ca5b3;
+        val += i;
+        eeprom_write_dword((uint32_t*)300, val);
+        EEPROM_Flush();
+    }
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[BANK_BASE(1)], 0xFFFF);
+
+    /* Compaction gets under way, with writes landing on both sides of what has been copied */
+    for (int i = 0; i < 8 + 8; ++i) {
+        EEPROM_Task();
+    }
+    EXPECT_NE(*(uint16_t*)&FlashBuf[BANK_BASE(1)], 0xFFFF);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[BANK_BASE(1) + 2], 0xFFFF);
+    eeprom_write_dword((uint32_t*)0, 0x12345678);
+    eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 4), 0x87654321);
+
+    /* Until it completes, the first bank is still used */
+    EEPROM_Flush();
+    EEPROM_Init();
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0x12345678);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)200), 0xcafef00d);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)300), val);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)(EEPROM_SIZE - 4)), 0x87654321);
+
+    /* Power was lost part way through, so compaction starts over */
+    for (int i = 0; i < 8 + 8; ++i) {
+        EEPROM_Task();
+    }
+    eeprom_write_dword((uint32_t*)0, 0xfeedface);
+    for (int i = 0; i < 8 + EEPROM_SIZE / 2 / 64 + 1; ++i) {
+        EEPROM_Task();
+    }
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[BANK_BASE(1) + 2], 0);
+    eeprom_write_dword((uint32_t*)(EEPROM_SIZE - 4), 0xba5eba11);
+
+    /* The second bank is in use, and holds everything */
+    reload();
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0), 0xfeedface);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)200), 0xcafef00d);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)300), val);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)(EEPROM_SIZE - 4)), 0xba5eba11);
+    EXPECT_NE(*(uint16_t*)&FlashBuf[BANK_BASE(1) + 4 + EEPROM_SIZE], 0xFFFF);
+}
+
+TEST_F(EepromStm32Test, TestCompactionWhenLogFills) {
+    eeprom_write_dword((uint32_t*)200, 0xcafef00d);
+    /* Without the main loop running, the log fills and compaction has to happen immediately */
+    uint32_t val = 0xd8453c6b;
+    for (uint32_t i = 0; i < LOG_SIZE / 8 + 16; i++) {
+        val ^= 0x593ca5b3;
+        val += i;
+        eeprom_write_dword((uint32_t*)300, val);
+        EEPROM_Flush();
+    }
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[BANK_BASE(1) + 2], 0);
+    reload();
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)200), 0xcafef00d);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)300), val);
+}
+#endif
+
+#ifdef FEE_WRITE_BEHIND_DELAY
+TEST_F(EepromStm32Test, TestWriteBehindCoalesces) {
+    uint32_t written = FlashHalfWordsProgrammed;
+    for (uint16_t i = 0; i < 100; ++i) {
+        eeprom_write_word((uint16_t*)200, 0x1000 + i);
+        EEPROM_Task();
+    }
+    EXPECT_EQ(FlashHalfWordsProgrammed, written);
+
+    advance_time(FEE_WRITE_BEHIND_DELAY - 1);
+    EEPROM_Task();
+    EXPECT_EQ(FlashHalfWordsProgrammed, written);
+
+    advance_time(1);
+    EEPROM_Task();
+    EXPECT_EQ(FlashHalfWordsProgrammed, written + 1);
+
+    EEPROM_Init();
+    EXPECT_EQ(eeprom_read_word((uint16_t*)200), 0x1000 + 99);
+}
+#endif
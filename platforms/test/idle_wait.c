@@ -0,0 +1,45 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "idle_wait.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+
+// Sleeping advances the simulated clock, stopping early at a pending simulated interrupt
+static bool     interrupt_pending = false;
+static uint32_t interrupt_time    = 0;
+
+void set_idle_interrupt(uint32_t time) {
+    interrupt_pending = true;
+    interrupt_time    = time;
+}
+
+void idle_wakeup_from_isr(void) { set_idle_interrupt(timer_read32()); }
+
+void platform_idle_wait(uint32_t timeout_ms) {
+    if (interrupt_pending) {
+        uint32_t until_interrupt = TIMER_DIFF_32(interrupt_time, timer_read32());
+        if ((int32_t)until_interrupt < 0) {
+            until_interrupt = 0;
+        }
+        if (until_interrupt <= timeout_ms) {
+            interrupt_pending = false;
+            timeout_ms        = until_interrupt;
+        }
+    }
+    advance_time(timeout_ms);
+}
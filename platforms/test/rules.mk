@@ -9,16 +9,41 @@ eeprom_stm32_large_DEFS := $(eeprom_stm32_DEFS) \
 	-DMOCK_FLASH_SIZE=65536 \
 	-DFEE_PAGE_SIZE=2048 \
 	-DFEE_PAGE_COUNT=16
+eeprom_stm32_background_DEFS := $(eeprom_stm32_DEFS) \
+	-DFEE_MCU_FLASH_SIZE=64 \
+	-DMOCK_FLASH_SIZE=65536 \
+	-DFEE_PAGE_SIZE=2048 \
+	-DFEE_PAGE_COUNT=16 \
+	-DFEE_BACKGROUND_COMPACTION
+eeprom_stm32_write_behind_DEFS := $(eeprom_stm32_background_DEFS) \
+	-DFEE_WRITE_BEHIND_DELAY=100
 
 eeprom_stm32_INC := \
 	$(PLATFORM_PATH)/chibios/
 eeprom_stm32_tiny_INC := $(eeprom_stm32_INC)
 eeprom_stm32_large_INC := $(eeprom_stm32_INC)
+eeprom_stm32_background_INC := $(eeprom_stm32_INC)
+eeprom_stm32_write_behind_INC := $(eeprom_stm32_INC)
 
 eeprom_stm32_SRC := \
 	$(TOP_DIR)/drivers/eeprom/eeprom_driver.c \
 	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_stm32_tests.cpp \
 	$(PLATFORM_PATH)/$(PLATFORM_KEY)/flash_stm32_mock.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
 	$(PLATFORM_PATH)/chibios/eeprom_stm32.c
 eeprom_stm32_tiny_SRC := $(eeprom_stm32_SRC)
 eeprom_stm32_large_SRC := $(eeprom_stm32_SRC)
+eeprom_stm32_background_SRC := $(eeprom_stm32_SRC)
+eeprom_stm32_write_behind_SRC := $(eeprom_stm32_SRC)
+
+ws2812_spi_INC := \
+	$(TOP_DIR)/drivers \
+	$(PLATFORM_PATH)/chibios/drivers
+ws2812_spi_rgbw_INC := $(ws2812_spi_INC)
+ws2812_spi_rgbw_DEFS := \
+	-DRGBW \
+	-DWS2812_BYTE_ORDER=WS2812_BYTE_ORDER_BGR
+
+ws2812_spi_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/ws2812_spi_tests.cpp
+ws2812_spi_rgbw_SRC := $(ws2812_spi_SRC)
@@ -0,0 +1,268 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "split_sim.h"
+#include "serial.h"
+#include "split_util.h"
+#include "transactions.h"
+#include "action_layer.h"
+#include "action_util.h"
+#ifdef WPM_ENABLE
+#    include "wpm.h"
+#endif
+#ifdef RGB_MATRIX_ENABLE
+#    include "rgb_matrix.h"
+#endif
+
+_Static_assert(NUM_TOTAL_TRANSACTIONS <= SPLIT_SIM_MAX_TRANSACTIONS, "Too many transactions for the statistics");
+
+// Stands in for the serial driver, with the slave half running in the same process. The slave gets its own copy of
+// the shared memory, swapped in for as long as it runs, and is_keyboard_master() tells the two halves apart.
+
+#ifndef SERIAL_USART_PUSH_QUEUE_SIZE
+#    define SERIAL_USART_PUSH_QUEUE_SIZE 4
+#endif
+
+typedef struct {
+    layer_state_t layer_state;
+    layer_state_t default_layer_state;
+    uint8_t       real_mods;
+    uint8_t       weak_mods;
+    uint8_t       oneshot_mods;
+    uint8_t       wpm;
+#ifdef RGB_MATRIX_ENABLE
+    rgb_config_t rgb_matrix_config;
+#endif
+} split_sim_globals_t;
+
+const split_sim_config_t split_sim_default_config = {
+    .baud          = 230400,
+    .bits_per_byte = 12,  // start bit, 8 data bits, parity and 2 stop bits
+    .turnaround_us = 0,
+    .timeout_us    = 20000,
+};
+
+static split_sim_config_t    config = split_sim_default_config;
+static split_sim_stats_t     stats;
+static uint32_t              random_state = 1;
+static split_shared_memory_t slave_memory;
+static split_sim_globals_t   slave_globals;
+static matrix_row_t          slave_master_rows[(MATRIX_ROWS) / 2];
+static bool                  in_slave = false;
+
+bool is_keyboard_master(void) { return !in_slave; }
+
+static void swap_memory(void) {
+    split_shared_memory_t master_memory;
+    memcpy(&master_memory, split_shmem, sizeof(master_memory));
+    memcpy(split_shmem, &slave_memory, sizeof(slave_memory));
+    memcpy(&slave_memory, &master_memory, sizeof(master_memory));
+}
+
+// The slave's handlers write to the same globals the master reads, so they get swapped as well
+static void swap_globals(void) {
+    split_sim_globals_t master_globals = {
+        .layer_state         = layer_state,
+        .default_layer_state = default_layer_state,
+        .real_mods           = get_mods(),
+        .weak_mods           = get_weak_mods(),
+#ifndef NO_ACTION_ONESHOT
+        .oneshot_mods = get_oneshot_mods(),
+#endif
+#ifdef WPM_ENABLE
+        .wpm = get_current_wpm(),
+#endif
+#ifdef RGB_MATRIX_ENABLE
+        .rgb_matrix_config = rgb_matrix_config,
+#endif
+    };
+    layer_state         = slave_globals.layer_state;
+    default_layer_state = slave_globals.default_layer_state;
+    set_mods(slave_globals.real_mods);
+    set_weak_mods(slave_globals.weak_mods);
+#ifndef NO_ACTION_ONESHOT
+    set_oneshot_mods(slave_globals.oneshot_mods);
+#endif
+#ifdef WPM_ENABLE
+    set_current_wpm(slave_globals.wpm);
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    rgb_matrix_config = slave_globals.rgb_matrix_config;
+#endif
+    slave_globals = master_globals;
+}
+
+static void enter_slave(void) {
+    swap_memory();
+    swap_globals();
+    in_slave = true;
+}
+
+static void leave_slave(void) {
+    in_slave = false;
+    swap_globals();
+    swap_memory();
+}
+
+static uint16_t next_random(void) {
+    // xorshift32
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state >> 16;
+}
+
+static bool chance(uint16_t rate) { return rate && next_random() < rate; }
+
+static void transfer(uint8_t *destination, const uint8_t *source, uint8_t size) {
+    memcpy(destination, source, size);
+    if (size && chance(config.corrupt_rate)) {
+        uint16_t bit = next_random() % (size * 8);
+        destination[bit / 8] ^= 1 << (bit % 8);
+        stats.corrupted++;
+    }
+}
+
+static void account(uint16_t bytes, uint8_t turnarounds) {
+    stats.bytes += bytes;
+    if (config.baud) {
+        stats.link_us += (uint64_t)bytes * config.bits_per_byte * 1000000 / config.baud;
+    }
+    stats.link_us += turnarounds * config.turnaround_us;
+}
+
+void split_sim_configure(const split_sim_config_t *new_config) {
+    config       = *new_config;
+    random_state = config.seed ? config.seed : 1;
+}
+
+void split_sim_get_stats(split_sim_stats_t *result) { *result = stats; }
+
+void split_sim_reset_stats(void) { memset(&stats, 0, sizeof(stats)); }
+
+void split_sim_slave_scan(const matrix_row_t slave_rows[]) {
+    matrix_row_t slave_matrix[(MATRIX_ROWS) / 2];
+    memcpy(slave_matrix, slave_rows, sizeof(slave_matrix));
+
+    stats.scans++;
+    enter_slave();
+    transport_slave(slave_master_rows, slave_matrix);
+    leave_slave();
+}
+
+const matrix_row_t *split_sim_slave_master_rows(void) { return slave_master_rows; }
+
+void split_sim_on_slave(void (*callback)(void)) {
+    enter_slave();
+    callback();
+    leave_slave();
+}
+
+void soft_serial_initiator_init(void) {}
+void soft_serial_target_init(void) {}
+
+int soft_serial_transaction(int index) {
+    if (index < 0 || index >= NUM_TOTAL_TRANSACTIONS || !split_transaction_table[index].status) {
+        return TRANSACTION_TYPE_ERROR;
+    }
+
+    split_transaction_desc_t *trans = &split_transaction_table[index];
+    stats.transactions++;
+    stats.per_transaction[index]++;
+
+    // Transaction id and handshake, then the buffers in either direction
+    account(2, 1);
+    if (config.disconnected || chance(config.drop_rate)) {
+        stats.failed++;
+        stats.link_us += config.timeout_us;
+        return TRANSACTION_NO_RESPONSE;
+    }
+
+    uint8_t *slave_initiator2target = (uint8_t *)&slave_memory + trans->initiator2target_offset;
+    uint8_t *slave_target2initiator = (uint8_t *)&slave_memory + trans->target2initiator_offset;
+
+    account(trans->initiator2target_buffer_size + trans->target2initiator_buffer_size, (trans->initiator2target_buffer_size ? 1 : 0) + (trans->target2initiator_buffer_size ? 1 : 0));
+    transfer(slave_initiator2target, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+
+    if (trans->slave_callback) {
+        enter_slave();
+        trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+        leave_slave();
+    }
+
+    // The answer may get lost after the slave already acted on the transaction
+    if (chance(config.drop_rate)) {
+        stats.failed++;
+        stats.link_us += config.timeout_us;
+        return TRANSACTION_NO_RESPONSE;
+    }
+
+    transfer(split_trans_target2initiator_buffer(trans), slave_target2initiator, trans->target2initiator_buffer_size);
+    return TRANSACTION_END;
+}
+
+#ifdef SERIAL_USART_SLAVE_PUSH
+
+static uint8_t push_queue[SERIAL_USART_PUSH_QUEUE_SIZE][sizeof(split_slave_push_t)];
+static uint8_t push_queue_head  = 0;
+static uint8_t push_queue_count = 0;
+static uint8_t last_push[sizeof(split_slave_push_t)];
+static bool    has_pushed = false;
+
+static void deliver_push(void) {
+    // Pushes go out on the slave's own line, so they don't hold up the master
+    stats.pushes++;
+    stats.bytes += 1 + sizeof(last_push);
+    if (config.disconnected || config.pushes_lost || chance(config.drop_rate)) {
+        return;
+    }
+
+    // A full queue has its newest entry overwritten, like the USART driver does
+    if (push_queue_count == SERIAL_USART_PUSH_QUEUE_SIZE) {
+        push_queue_count--;
+    }
+    transfer(push_queue[(push_queue_head + push_queue_count++) % SERIAL_USART_PUSH_QUEUE_SIZE], last_push, sizeof(last_push));
+}
+
+bool soft_serial_target_push(const void *data, size_t size) {
+    if (size != sizeof(last_push)) {
+        return false;
+    }
+    memcpy(last_push, data, size);
+    has_pushed = true;
+    deliver_push();
+    return true;
+}
+
+void soft_serial_target_repush(void) {
+    if (has_pushed) {
+        deliver_push();
+    }
+}
+
+bool soft_serial_initiator_receive_push(void *data, size_t size) {
+    if (size != sizeof(push_queue[0]) || !push_queue_count) {
+        return false;
+    }
+
+    memcpy(data, push_queue[push_queue_head], size);
+    push_queue_head = (push_queue_head + 1) % SERIAL_USART_PUSH_QUEUE_SIZE;
+    push_queue_count--;
+    return true;
+}
+
+#endif  // SERIAL_USART_SLAVE_PUSH
@@ -0,0 +1,75 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "matrix.h"
+
+// Transaction ids fit in 5 bits, see transaction_id_define.h
+#define SPLIT_SIM_MAX_TRANSACTIONS 32
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// How the simulated wire between the halves behaves
+typedef struct {
+    uint32_t baud;           // bits per second, 0 for a link that takes no time
+    uint8_t  bits_per_byte;  // including start, parity and stop bits
+    uint16_t turnaround_us;  // added whenever the direction of the transfer changes
+    uint32_t timeout_us;     // how long the master waits for an answer that doesn't come
+    uint16_t drop_rate;      // transactions and pushes lost, out of 65536
+    uint16_t corrupt_rate;   // buffers arriving with a flipped bit, out of 65536
+    bool     disconnected;   // the slave doesn't answer at all
+    bool     pushes_lost;    // the slave's pushes never arrive, while transactions still get through
+    uint32_t seed;           // for the drops and corruptions
+} split_sim_config_t;
+
+typedef struct {
+    uint32_t scans;
+    uint32_t transactions;
+    uint32_t failed;     // dropped, or not answered
+    uint32_t corrupted;  // buffers with a flipped bit
+    uint32_t pushes;     // sent by the slave on its own
+    uint32_t bytes;      // on the wire in both directions, including handshakes
+    uint32_t link_us;    // time the master spent waiting on the link
+    uint32_t per_transaction[SPLIT_SIM_MAX_TRANSACTIONS];
+} split_sim_stats_t;
+
+// Default configuration: the USART driver at SELECT_SOFT_SERIAL_SPEED 1, without any faults
+extern const split_sim_config_t split_sim_default_config;
+
+// Changes how the wire behaves from now on
+void split_sim_configure(const split_sim_config_t *config);
+
+// Statistics since they were last reset
+void split_sim_get_stats(split_sim_stats_t *stats);
+void split_sim_reset_stats(void);
+
+// Runs a scan of the slave half, with its own rows of the matrix as given
+void split_sim_slave_scan(const matrix_row_t slave_rows[]);
+
+// The master's half of the matrix as the slave knows it, with SPLIT_TRANSPORT_MIRROR
+const matrix_row_t *split_sim_slave_master_rows(void);
+
+// Runs `callback` as the slave, with its shared memory and globals in place, for example to look at what was synced
+void split_sim_on_slave(void (*callback)(void));
+
+#ifdef __cplusplus
+}
+#endif
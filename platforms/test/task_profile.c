@@ -0,0 +1,26 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "task_profile.h"
+#include "timer.h"
+
+// Simulated time spent inside tasks, on top of the simulated millisecond clock
+static uint32_t profile_time_us = 0;
+
+void advance_profile_time(uint32_t us) { profile_time_us += us; }
+
+uint32_t task_profile_timer_read(void) { return timer_read32() * 1000 + profile_time_us; }
+uint32_t task_profile_timer_elapsed_us(uint32_t start) { return task_profile_timer_read() - start; }
@@ -0,0 +1,127 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ws2812_spi.h"
+}
+
+// Turns the SPI bitstream back into the bytes the LEDs see, failing on anything that isn't a WS2812 bit
+static std::vector<uint8_t> decode(const uint8_t *spi, size_t length) {
+    std::vector<uint8_t> bytes;
+    uint8_t              byte = 0;
+    uint8_t              bits = 0;
+    for (size_t i = 0; i < length * 2; i++) {
+        uint8_t nibble = (i % 2 == 0) ? spi[i / 2] >> 4 : spi[i / 2] & 0xF;
+        EXPECT_TRUE(nibble == 0b1110 || nibble == 0b1000) << "nibble " << i << " is " << (int)nibble;
+        byte = (byte << 1) | (nibble == 0b1110);
+        if (++bits == 8) {
+            bytes.push_back(byte);
+            byte = 0;
+            bits = 0;
+        }
+    }
+    return bytes;
+}
+
+TEST(WS2812SPI, EncodesOnesAndZeros) {
+    uint8_t out[WS2812_SPI_BYTES_PER_CHANNEL];
+
+    ws2812_spi_encode_channel(out, 0xFF);
+    for (uint8_t i = 0; i < WS2812_SPI_BYTES_PER_CHANNEL; i++) EXPECT_EQ(out[i], 0xEE);
+
+    ws2812_spi_encode_channel(out, 0x00);
+    for (uint8_t i = 0; i < WS2812_SPI_BYTES_PER_CHANNEL; i++) EXPECT_EQ(out[i], 0x88);
+}
+
+TEST(WS2812SPI, SendsMostSignificantBitFirst) {
+    uint8_t out[WS2812_SPI_BYTES_PER_CHANNEL];
+
+    ws2812_spi_encode_channel(out, 0x80);
+    EXPECT_EQ(out[0], 0xE8);
+    EXPECT_EQ(out[1], 0x88);
+    EXPECT_EQ(out[2], 0x88);
+    EXPECT_EQ(out[3], 0x88);
+
+    ws2812_spi_encode_channel(out, 0x01);
+    EXPECT_EQ(out[0], 0x88);
+    EXPECT_EQ(out[3], 0x8E);
+}
+
+TEST(WS2812SPI, RoundTripsEveryByte) {
+    uint8_t out[WS2812_SPI_BYTES_PER_CHANNEL];
+    for (int value = 0; value < 256; value++) {
+        ws2812_spi_encode_channel(out, value);
+        auto bytes = decode(out, sizeof(out));
+        ASSERT_EQ(bytes.size(), 1u);
+        EXPECT_EQ(bytes[0], value);
+    }
+}
+
+TEST(WS2812SPI, EncodesChannelsInByteOrder) {
+    LED_TYPE led = {};
+    led.r        = 0x12;
+    led.g        = 0x34;
+    led.b        = 0x56;
+#ifdef RGBW
+    led.w = 0x78;
+#endif
+    uint8_t out[WS2812_SPI_BYTES_PER_LED];
+    ws2812_spi_encode_led(out, led);
+    auto bytes = decode(out, sizeof(out));
+
+#if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
+    std::vector<uint8_t> expected = {0x34, 0x12, 0x56};
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_RGB)
+    std::vector<uint8_t> expected = {0x12, 0x34, 0x56};
+#elif (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_BGR)
+    std::vector<uint8_t> expected = {0x56, 0x34, 0x12};
+#endif
+#ifdef RGBW
+    expected.push_back(0x78);
+#endif
+    EXPECT_EQ(bytes, expected);
+}
+
+TEST(WS2812SPI, FrameKeepsPreambleAndReset) {
+    const uint16_t       leds = 3;
+    std::vector<uint8_t> frame(WS2812_SPI_FRAME_SIZE(leds), 0);
+    LED_TYPE             ledarray[leds];
+    for (uint16_t i = 0; i < leds; i++) {
+        ledarray[i]   = {};
+        ledarray[i].r = i;
+        ledarray[i].g = 0x80 | i;
+        ledarray[i].b = 0xFF - i;
+#ifdef RGBW
+        ledarray[i].w = 0x40 + i;
+#endif
+    }
+    ws2812_spi_encode_frame(frame.data(), ledarray, leds);
+
+    for (uint8_t i = 0; i < WS2812_SPI_PREAMBLE_SIZE; i++) EXPECT_EQ(frame[i], 0) << "preamble byte " << (int)i;
+    for (size_t i = WS2812_SPI_PREAMBLE_SIZE + leds * WS2812_SPI_BYTES_PER_LED; i < frame.size(); i++) EXPECT_EQ(frame[i], 0) << "reset byte " << i;
+    EXPECT_EQ(frame.size() - WS2812_SPI_PREAMBLE_SIZE - leds * WS2812_SPI_BYTES_PER_LED, (size_t)WS2812_SPI_RESET_SIZE);
+
+    for (uint16_t i = 0; i < leds; i++) {
+        uint8_t expected[WS2812_SPI_BYTES_PER_LED];
+        ws2812_spi_encode_led(expected, ledarray[i]);
+        EXPECT_EQ(0, memcmp(&frame[WS2812_SPI_PREAMBLE_SIZE + i * WS2812_SPI_BYTES_PER_LED], expected, sizeof(expected))) << "led " << i;
+    }
+}
@@ -3,6 +3,9 @@
 #include "action.h"
 #include "util.h"
 #include "action_layer.h"
+#ifdef LAYER_LOOKUP_CACHE
+#    include "matrix.h"
+#endif
 
 #ifdef DEBUG_ACTION
 #    include "debug.h"
@@ -246,6 +249,26 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+/** \brief layer lookup cache
+ *
+ * Resolved layer for each key, valid for the layer state it was resolved against
+ */
+static layer_state_t layer_lookup_cache_state = 0;
+static uint8_t       layer_lookup_cache[MATRIX_ROWS][MATRIX_COLS];
+static matrix_row_t  layer_lookup_cache_valid[MATRIX_ROWS];
+
+/** \brief invalidate layer lookup cache
+ *
+ * Forgets every resolved layer. Needs to be called whenever the keymap itself changes.
+ */
+void layer_lookup_cache_invalidate(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        layer_lookup_cache_valid[row] = 0;
+    }
+}
+#endif
+
 /** \brief Layer switch get layer
  *
  * Gets the layer based on key info
@@ -256,16 +279,40 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     action.code = ACTION_TRANSPARENT;
 
     layer_state_t layers = layer_state | default_layer_state;
+#    ifdef LAYER_LOOKUP_CACHE
+    /* the cache only holds layers resolved against the current layer state */
+    if (layers != layer_lookup_cache_state) {
+        layer_lookup_cache_invalidate();
+        layer_lookup_cache_state = layers;
+    }
+
+    matrix_row_t col_mask = (matrix_row_t)1 << key.col;
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS && (layer_lookup_cache_valid[key.row] & col_mask)) {
+        return layer_lookup_cache[key.row][key.col];
+    }
+#    endif
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
             action = action_for_key(i, key);
             if (action.code != ACTION_TRANSPARENT) {
+#    ifdef LAYER_LOOKUP_CACHE
+                if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+                    layer_lookup_cache[key.row][key.col] = i;
+                    layer_lookup_cache_valid[key.row] |= col_mask;
+                }
+#    endif
                 return i;
             }
         }
     }
     /* fall back to layer 0 */
+#    ifdef LAYER_LOOKUP_CACHE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        layer_lookup_cache[key.row][key.col] = 0;
+        layer_lookup_cache_valid[key.row] |= col_mask;
+    }
+#    endif
     return 0;
 #else
     return get_highest_layer(default_layer_state);
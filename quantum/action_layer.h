@@ -132,6 +132,11 @@ layer_state_t layer_state_set_kb(layer_state_t state);
 #    define layer_state_set_user(state) (void)state
 #endif
 
+/* resolved layer cache */
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+void layer_lookup_cache_invalidate(void);
+#endif
+
 /* pressed actions cache */
 #if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
 
@@ -106,6 +106,19 @@ RGB hsv_to_rgb(HSV hsv) {
 
 RGB hsv_to_rgb_nocie(HSV hsv) { return hsv_to_rgb_impl(hsv, false); }
 
+void hsv_to_rgb_buffer(const HSV *hsv, RGB *rgb, uint16_t count, RGB (*convert)(HSV)) {
+    // Neighbouring LEDs very often share a color (solid effects, or a
+    // gradient that only moves every few LEDs), so only convert a color
+    // when it differs from the one before
+    for (uint16_t i = 0; i < count; i++) {
+        if (i > 0 && hsv[i].h == hsv[i - 1].h && hsv[i].s == hsv[i - 1].s && hsv[i].v == hsv[i - 1].v) {
+            rgb[i] = rgb[i - 1];
+        } else {
+            rgb[i] = convert(hsv[i]);
+        }
+    }
+}
+
 #ifdef RGBW
 #    ifndef MIN
 #        define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -145,6 +145,8 @@ typedef struct PACKED {
 
 RGB hsv_to_rgb(HSV hsv);
 RGB hsv_to_rgb_nocie(HSV hsv);
+// Converts count colors with convert, once for each run of LEDs of the same color
+void hsv_to_rgb_buffer(const HSV *hsv, RGB *rgb, uint16_t count, RGB (*convert)(HSV));
 #ifdef RGBW
 void convert_rgb_to_rgbw(LED_TYPE *led);
 #endif
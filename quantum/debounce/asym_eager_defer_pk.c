@@ -44,6 +44,8 @@ When no state changes have occured for DEBOUNCE milliseconds, we push the state.
 #endif
 
 #define ROW_SHIFTER ((matrix_row_t)1)
+// matrix_row_t can be wider than the matrix, and a bit past the last column has no counter of its own
+#define COL_MASK ((matrix_row_t)((1ULL << MATRIX_COLS) - 1))
 
 typedef struct {
     bool    pressed : 1;
@@ -52,6 +54,7 @@ typedef struct {
 
 #if DEBOUNCE > 0
 static debounce_counter_t *debounce_counters;
+static matrix_row_t        debouncing_keys[MATRIX_ROWS];  // keys whose counter is running
 static fast_timer_t        last_time;
 static bool                counters_need_update;
 static bool                matrix_need_update;
@@ -63,12 +66,13 @@ static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], ui
 
 // we use num_rows rather than MATRIX_ROWS to support split keyboards
 void debounce_init(uint8_t num_rows) {
-    debounce_counters = malloc(num_rows * MATRIX_COLS * sizeof(debounce_counter_t));
+    debounce_counters = (debounce_counter_t *)malloc(num_rows * MATRIX_COLS * sizeof(debounce_counter_t));
     int i             = 0;
     for (uint8_t r = 0; r < num_rows; r++) {
         for (uint8_t c = 0; c < MATRIX_COLS; c++) {
             debounce_counters[i++].time = DEBOUNCE_ELAPSED;
         }
+        debouncing_keys[r] = 0;
     }
 }
 
@@ -104,63 +108,63 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
     }
 }
 
+// Only visits the keys that are debouncing, stopping after the last one in each row
 static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
-
     counters_need_update = false;
     matrix_need_update   = false;
 
     for (uint8_t row = 0; row < num_rows; row++) {
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            matrix_row_t col_mask = (ROW_SHIFTER << col);
-
-            if (debounce_pointer->time != DEBOUNCE_ELAPSED) {
-                if (debounce_pointer->time <= elapsed_time) {
-                    debounce_pointer->time = DEBOUNCE_ELAPSED;
-
-                    if (debounce_pointer->pressed) {
-                        // key-down: eager
-                        matrix_need_update = true;
-                    } else {
-                        // key-up: defer
-                        cooked[row] = (cooked[row] & ~col_mask) | (raw[row] & col_mask);
-                    }
+        debounce_counter_t *debounce_pointer = debounce_counters + row * MATRIX_COLS;
+        matrix_row_t        keys             = debouncing_keys[row];
+        for (matrix_row_t col_mask = ROW_SHIFTER; keys; col_mask <<= 1, debounce_pointer++) {
+            if (!(keys & col_mask)) continue;
+            keys &= ~col_mask;
+
+            if (debounce_pointer->time <= elapsed_time) {
+                debounce_pointer->time = DEBOUNCE_ELAPSED;
+                debouncing_keys[row] &= ~col_mask;
+
+                if (debounce_pointer->pressed) {
+                    // key-down: eager
+                    matrix_need_update = true;
                 } else {
-                    debounce_pointer->time -= elapsed_time;
-                    counters_need_update = true;
+                    // key-up: defer
+                    cooked[row] = (cooked[row] & ~col_mask) | (raw[row] & col_mask);
                 }
+            } else {
+                debounce_pointer->time -= elapsed_time;
+                counters_need_update = true;
             }
-            debounce_pointer++;
         }
     }
 }
 
+// Only visits the keys that start or stop debouncing
 static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
-
     for (uint8_t row = 0; row < num_rows; row++) {
-        matrix_row_t delta = raw[row] ^ cooked[row];
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            matrix_row_t col_mask = (ROW_SHIFTER << col);
+        matrix_row_t delta = (raw[row] ^ cooked[row]) & COL_MASK;
+        matrix_row_t keys  = delta ^ debouncing_keys[row];
+
+        debounce_counter_t *debounce_pointer = debounce_counters + row * MATRIX_COLS;
+        for (matrix_row_t col_mask = ROW_SHIFTER; keys; col_mask <<= 1, debounce_pointer++) {
+            if (!(keys & col_mask)) continue;
+            keys &= ~col_mask;
 
             if (delta & col_mask) {
-                if (debounce_pointer->time == DEBOUNCE_ELAPSED) {
-                    debounce_pointer->pressed = (raw[row] & col_mask);
-                    debounce_pointer->time    = DEBOUNCE;
-                    counters_need_update      = true;
-
-                    if (debounce_pointer->pressed) {
-                        // key-down: eager
-                        cooked[row] ^= col_mask;
-                    }
-                }
-            } else if (debounce_pointer->time != DEBOUNCE_ELAPSED) {
-                if (!debounce_pointer->pressed) {
-                    // key-up: defer
-                    debounce_pointer->time = DEBOUNCE_ELAPSED;
+                debounce_pointer->pressed = (raw[row] & col_mask);
+                debounce_pointer->time    = DEBOUNCE;
+                counters_need_update      = true;
+                debouncing_keys[row] |= col_mask;
+
+                if (debounce_pointer->pressed) {
+                    // key-down: eager
+                    cooked[row] ^= col_mask;
                 }
+            } else if (!debounce_pointer->pressed) {
+                // key-up: defer
+                debounce_pointer->time = DEBOUNCE_ELAPSED;
+                debouncing_keys[row] &= ~col_mask;
             }
-            debounce_pointer++;
         }
     }
 }
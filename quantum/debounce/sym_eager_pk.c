@@ -41,11 +41,14 @@ No further inputs are accepted until DEBOUNCE milliseconds have occurred.
 #endif
 
 #define ROW_SHIFTER ((matrix_row_t)1)
+// matrix_row_t can be wider than the matrix, and a bit past the last column has no counter of its own
+#define COL_MASK ((matrix_row_t)((1ULL << MATRIX_COLS) - 1))
 
 typedef uint8_t debounce_counter_t;
 
 #if DEBOUNCE > 0
 static debounce_counter_t *debounce_counters;
+static matrix_row_t        debouncing_keys[MATRIX_ROWS];  // keys whose counter is running
 static fast_timer_t        last_time;
 static bool                counters_need_update;
 static bool                matrix_need_update;
@@ -63,6 +66,7 @@ void debounce_init(uint8_t num_rows) {
         for (uint8_t c = 0; c < MATRIX_COLS; c++) {
             debounce_counters[i++] = DEBOUNCE_ELAPSED;
         }
+        debouncing_keys[r] = 0;
     }
 }
 
@@ -99,44 +103,46 @@ void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 }
 
 // If the current time is > debounce counter, set the counter to enable input.
+// Only visits the keys that are debouncing, stopping after the last one in each row.
 static void update_debounce_counters(uint8_t num_rows, uint8_t elapsed_time) {
-    counters_need_update                 = false;
-    matrix_need_update                   = false;
-    debounce_counter_t *debounce_pointer = debounce_counters;
+    counters_need_update = false;
+    matrix_need_update   = false;
     for (uint8_t row = 0; row < num_rows; row++) {
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            if (*debounce_pointer != DEBOUNCE_ELAPSED) {
-                if (*debounce_pointer <= elapsed_time) {
-                    *debounce_pointer  = DEBOUNCE_ELAPSED;
-                    matrix_need_update = true;
-                } else {
-                    *debounce_pointer -= elapsed_time;
-                    counters_need_update = true;
-                }
+        debounce_counter_t *debounce_pointer = debounce_counters + row * MATRIX_COLS;
+        matrix_row_t        keys             = debouncing_keys[row];
+        for (matrix_row_t col_mask = ROW_SHIFTER; keys; col_mask <<= 1, debounce_pointer++) {
+            if (!(keys & col_mask)) continue;
+            keys &= ~col_mask;
+
+            if (*debounce_pointer <= elapsed_time) {
+                *debounce_pointer = DEBOUNCE_ELAPSED;
+                debouncing_keys[row] &= ~col_mask;
+                matrix_need_update = true;
+            } else {
+                *debounce_pointer -= elapsed_time;
+                counters_need_update = true;
             }
-            debounce_pointer++;
         }
     }
 }
 
 // upload from raw_matrix to final matrix;
 static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
     for (uint8_t row = 0; row < num_rows; row++) {
-        matrix_row_t delta        = raw[row] ^ cooked[row];
-        matrix_row_t existing_row = cooked[row];
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            matrix_row_t col_mask = (ROW_SHIFTER << col);
-            if (delta & col_mask) {
-                if (*debounce_pointer == DEBOUNCE_ELAPSED) {
-                    *debounce_pointer    = DEBOUNCE;
-                    counters_need_update = true;
-                    existing_row ^= col_mask;  // flip the bit.
-                }
-            }
-            debounce_pointer++;
+        matrix_row_t flip = (raw[row] ^ cooked[row]) & COL_MASK & ~debouncing_keys[row];
+        if (!flip) continue;
+
+        counters_need_update = true;
+        debouncing_keys[row] |= flip;
+        cooked[row] ^= flip;
+
+        debounce_counter_t *debounce_pointer = debounce_counters + row * MATRIX_COLS;
+        for (matrix_row_t col_mask = ROW_SHIFTER; flip; col_mask <<= 1, debounce_pointer++) {
+            if (!(flip & col_mask)) continue;
+            flip &= ~col_mask;
+
+            *debounce_pointer = DEBOUNCE;
         }
-        cooked[row] = existing_row;
     }
 }
 
@@ -0,0 +1,161 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "quantum.h"
+#include "timer.h"
+#include "debounce/vertical_counter.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// Every algorithm in the same binary, each in its own namespace
+namespace sym_defer_g {
+#include "debounce/sym_defer_g.c"
+}
+namespace sym_defer_pk {
+#include "debounce/sym_defer_pk.c"
+}
+namespace sym_eager_pk {
+#include "debounce/sym_eager_pk.c"
+}
+namespace sym_eager_pr {
+#include "debounce/sym_eager_pr.c"
+}
+namespace asym_eager_defer_pk {
+#include "debounce/asym_eager_defer_pk.c"
+}
+namespace sym_defer_vc {
+#include "debounce/sym_defer_vc.c"
+}
+namespace sym_eager_vc {
+#include "debounce/sym_eager_vc.c"
+}
+
+#define BENCHMARK_MS 20000
+#define BENCHMARK_SCANS_PER_MS 4
+#define BENCHMARK_ROUNDS 5
+
+struct Algorithm {
+    const char *name;
+    void (*init)(uint8_t num_rows);
+    void (*debounce)(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+    void (*free)(void);
+};
+
+#define ALGORITHM(name) \
+    { #name, name::debounce_init, name::debounce, name::debounce_free }
+
+static const Algorithm algorithms[] = {
+    ALGORITHM(sym_defer_g), ALGORITHM(sym_defer_pk), ALGORITHM(sym_defer_vc), ALGORITHM(sym_eager_pk), ALGORITHM(sym_eager_vc), ALGORITHM(sym_eager_pr), ALGORITHM(asym_eager_defer_pk),
+};
+
+struct Scan {
+    uint32_t     time;
+    matrix_row_t raw[MATRIX_ROWS];
+};
+
+// Keys change state every key_interval ms, and bounce on every scan for bounce_ms after that
+static std::vector<Scan> bouncing_trace(uint32_t key_interval, uint32_t bounce_ms) {
+    std::vector<Scan> trace;
+    matrix_row_t      settled[MATRIX_ROWS] = {0};
+    std::vector<std::pair<uint32_t, uint8_t>> bouncing;  // until, key
+
+    srand(1);
+    for (uint32_t ms = 0; ms < BENCHMARK_MS; ms++) {
+        if (ms % key_interval == 0) {
+            uint8_t key = rand() % (MATRIX_ROWS * MATRIX_COLS);
+            settled[key / MATRIX_COLS] ^= (matrix_row_t)1 << (key % MATRIX_COLS);
+            bouncing.emplace_back(ms + bounce_ms, key);
+        }
+        for (auto it = bouncing.begin(); it != bouncing.end();) {
+            it = (it->first <= ms) ? bouncing.erase(it) : it + 1;
+        }
+        for (uint8_t i = 0; i < BENCHMARK_SCANS_PER_MS; i++) {
+            Scan scan = {ms, {0}};
+            std::copy(std::begin(settled), std::end(settled), std::begin(scan.raw));
+            for (auto &[until, key] : bouncing) {
+                if (rand() & 1) scan.raw[key / MATRIX_COLS] ^= (matrix_row_t)1 << (key % MATRIX_COLS);
+            }
+            trace.push_back(scan);
+        }
+    }
+    return trace;
+}
+
+// Runs a trace through an algorithm, returning the debounced matrix after every scan
+static std::vector<matrix_row_t> run(const Algorithm &algorithm, std::vector<Scan> &trace, double *ns_per_scan) {
+    std::vector<matrix_row_t> output(trace.size() * MATRIX_ROWS);
+    double                    best = 0;
+
+    for (int round = 0; round < BENCHMARK_ROUNDS; round++) {
+        matrix_row_t cooked[MATRIX_ROWS] = {0};
+        matrix_row_t *previous           = cooked;
+
+        algorithm.init(MATRIX_ROWS);
+        set_time(7777);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < trace.size(); i++) {
+            set_time(7777 + trace[i].time);
+            bool changed = memcmp(previous, trace[i].raw, sizeof(trace[i].raw)) != 0;
+            algorithm.debounce(trace[i].raw, cooked, MATRIX_ROWS, changed);
+            previous = trace[i].raw;
+            std::copy(std::begin(cooked), std::end(cooked), output.begin() + i * MATRIX_ROWS);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        algorithm.free();
+
+        double ns = elapsed.count() / trace.size();
+        if (round == 0 || ns < best) best = ns;
+    }
+    *ns_per_scan = best;
+    return output;
+}
+
+// The vertical counter algorithms must give exactly the same result as the per-key ones they replace
+static void benchmark(const std::string &scenario, std::vector<Scan> trace) {
+    std::vector<matrix_row_t> outputs[sizeof(algorithms) / sizeof(algorithms[0])];
+    std::string               line = "[ BENCHMARK] " + scenario + ", " + std::to_string(MATRIX_ROWS * MATRIX_COLS) + " keys:";
+
+    for (size_t i = 0; i < sizeof(algorithms) / sizeof(algorithms[0]); i++) {
+        double ns;
+        outputs[i] = run(algorithms[i], trace, &ns);
+        line += " " + std::string(algorithms[i].name) + " " + std::to_string((int)(ns + 0.5)) + "ns";
+    }
+    std::cout << line << "/scan" << std::endl;
+
+    EXPECT_EQ(outputs[1], outputs[2]) << "sym_defer_vc differs from sym_defer_pk";
+    EXPECT_EQ(outputs[3], outputs[4]) << "sym_eager_vc differs from sym_eager_pk";
+}
+
+TEST(DebounceBenchmark, Typing) {
+    // A key every 20ms, bouncing for 2ms
+    benchmark("typing", bouncing_trace(20, 2));
+}
+
+TEST(DebounceBenchmark, Chatter) {
+    // A key every ms, bouncing for 8ms, so the counters never get a rest
+    benchmark("chatter", bouncing_trace(1, 8));
+}
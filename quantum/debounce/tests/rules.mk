@@ -42,3 +42,26 @@ debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+debounce_sym_defer_vc_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp
+
+debounce_sym_eager_vc_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_tests.cpp
+
+debounce_vertical_counter_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCE=200
+debounce_vertical_counter_INC := $(QUANTUM_PATH)/debounce
+debounce_vertical_counter_SRC := $(QUANTUM_PATH)/debounce/tests/vertical_counter_tests.cpp
+
+# Every algorithm against the same key traces, at 100 and 200 keys
+debounce_benchmark_100_DEFS := -DMATRIX_ROWS=10 -DMATRIX_COLS=10 -DDEBOUNCE=5
+debounce_benchmark_100_SRC := $(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/debounce/tests/debounce_benchmark.cpp
+
+debounce_benchmark_200_DEFS := -DMATRIX_ROWS=10 -DMATRIX_COLS=20 -DDEBOUNCE=5
+debounce_benchmark_200_SRC := $(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/debounce/tests/debounce_benchmark.cpp
@@ -238,3 +238,15 @@ TEST_F(DebounceTest, OneKeyDelayedScan4) {
     time_jumps_ = true;
     runEvents();
 }
+
+TEST_F(DebounceTest, ColumnsPastTheMatrixAreIgnored) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        /* matrix_row_t has bits to spare past the last column, a stray one never reaches the cooked matrix */
+        {0, {{0, 1, DOWN}, {3, MATRIX_COLS, DOWN}, {3, 15, DOWN}}, {}},
+        {5, {}, {{0, 1, DOWN}}},
+        {10, {{0, 1, UP}, {3, MATRIX_COLS, UP}}, {}},
+        {15, {}, {{0, 1, UP}}},
+    });
+    runEvents();
+}
@@ -3,4 +3,9 @@ TEST_LIST += \
 	debounce_sym_defer_pk \
 	debounce_sym_eager_pk \
 	debounce_sym_eager_pr \
-	debounce_asym_eager_defer_pk
+	debounce_asym_eager_defer_pk \
+	debounce_sym_defer_vc \
+	debounce_sym_eager_vc \
+	debounce_vertical_counter \
+	debounce_benchmark_100 \
+	debounce_benchmark_200
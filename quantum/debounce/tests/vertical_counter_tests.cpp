@@ -0,0 +1,76 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "quantum.h"
+#include "vertical_counter.h"
+}
+
+static void set_counter(debounce_vc_row_t counters, uint8_t col, uint8_t value) {
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        counters[b] = (counters[b] & ~((matrix_row_t)1 << col)) | ((matrix_row_t)((value >> b) & 1) << col);
+    }
+}
+
+static uint8_t get_counter(const debounce_vc_row_t counters, uint8_t col) {
+    uint8_t value = 0;
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        value |= ((counters[b] >> col) & 1) << b;
+    }
+    return value;
+}
+
+TEST(VerticalCounter, StartAndClear) {
+    debounce_vc_row_t counters = {0};
+
+    vc_start(counters, 0b1010);
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        EXPECT_EQ(get_counter(counters, col), (col == 1 || col == 3) ? DEBOUNCE : 0) << "col " << (int)col;
+    }
+    EXPECT_EQ(vc_active(counters), 0b1010);
+
+    vc_clear(counters, 0b0010);
+    EXPECT_EQ(vc_active(counters), 0b1000);
+    EXPECT_EQ(get_counter(counters, 3), DEBOUNCE);
+}
+
+// Every counter value against every elapsed time, with each key of the row at a different value
+TEST(VerticalCounter, ElapseMatchesPerKeyCounters) {
+    for (uint16_t first = 0; first <= DEBOUNCE; first++) {
+        for (uint16_t elapsed = 1; elapsed <= DEBOUNCE; elapsed++) {
+            debounce_vc_row_t counters = {0};
+            uint8_t           values[MATRIX_COLS];
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                values[col] = (first + col * 7) % (DEBOUNCE + 1);
+                set_counter(counters, col, values[col]);
+            }
+
+            matrix_row_t active  = vc_active(counters);
+            matrix_row_t expired = vc_elapse(counters, active, elapsed);
+
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                bool    running         = values[col] != 0;
+                bool    expect_expired  = running && values[col] <= elapsed;
+                uint8_t expect_value    = (running && !expect_expired) ? values[col] - elapsed : 0;
+                ASSERT_EQ(!!(active & ((matrix_row_t)1 << col)), running) << "value " << (int)values[col];
+                ASSERT_EQ(!!(expired & ((matrix_row_t)1 << col)), expect_expired) << "value " << (int)values[col] << " elapsed " << elapsed;
+                ASSERT_EQ(get_counter(counters, col), expect_value) << "value " << (int)values[col] << " elapsed " << elapsed;
+            }
+        }
+    }
+}
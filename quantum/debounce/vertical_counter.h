@@ -0,0 +1,92 @@
+/*
+Copyright 2022 QMK
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Vertical counters for the *_vc debounce algorithms.
+Rather than a byte per key, the counters of a row are stored one bit per
+matrix_row_t: plane b holds bit b of the counter of every key in the row,
+so a whole row of counters is loaded, cleared or counted down with a few
+bitwise operations per plane, however many keys are bouncing.
+*/
+
+#pragma once
+
+#include "matrix.h"
+
+// Enough planes to hold DEBOUNCE
+#if DEBOUNCE < 2
+#    define DEBOUNCE_VC_BITS 1
+#elif DEBOUNCE < 4
+#    define DEBOUNCE_VC_BITS 2
+#elif DEBOUNCE < 8
+#    define DEBOUNCE_VC_BITS 3
+#elif DEBOUNCE < 16
+#    define DEBOUNCE_VC_BITS 4
+#elif DEBOUNCE < 32
+#    define DEBOUNCE_VC_BITS 5
+#elif DEBOUNCE < 64
+#    define DEBOUNCE_VC_BITS 6
+#elif DEBOUNCE < 128
+#    define DEBOUNCE_VC_BITS 7
+#else
+#    define DEBOUNCE_VC_BITS 8
+#endif
+
+typedef matrix_row_t debounce_vc_row_t[DEBOUNCE_VC_BITS];
+
+// keys whose counter is running
+static inline matrix_row_t vc_active(const debounce_vc_row_t counters) {
+    matrix_row_t active = 0;
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        active |= counters[b];
+    }
+    return active;
+}
+
+// set the counters of the keys in mask to DEBOUNCE
+static inline void vc_start(debounce_vc_row_t counters, matrix_row_t mask) {
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        if ((DEBOUNCE >> b) & 1) {
+            counters[b] |= mask;
+        } else {
+            counters[b] &= ~mask;
+        }
+    }
+}
+
+// stop the counters of the keys in mask
+static inline void vc_clear(debounce_vc_row_t counters, matrix_row_t mask) {
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        counters[b] &= ~mask;
+    }
+}
+
+// Count the running counters down by elapsed_time (at most DEBOUNCE), a bit at a time as in long subtraction.
+// Returns the keys whose counter ran out, which are stopped, like the other keys that weren't running.
+static inline matrix_row_t vc_elapse(debounce_vc_row_t counters, matrix_row_t active, uint8_t elapsed_time) {
+    matrix_row_t borrow  = 0;
+    matrix_row_t nonzero = 0;
+    for (uint8_t b = 0; b < DEBOUNCE_VC_BITS; b++) {
+        matrix_row_t count    = counters[b];
+        matrix_row_t subtract = ((elapsed_time >> b) & 1) ? (matrix_row_t)~0 : 0;
+        counters[b]           = count ^ subtract ^ borrow;
+        borrow                = (~count & (subtract | borrow)) | (count & subtract & borrow);
+        nonzero |= counters[b];
+    }
+
+    // a borrow out of the top plane means the counter went below zero
+    matrix_row_t expired = active & (borrow | ~nonzero);
+    vc_clear(counters, ~active | expired);
+    return expired;
+}
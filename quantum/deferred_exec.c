@@ -4,44 +4,151 @@
 #include <stddef.h>
 #include <timer.h>
 #include <deferred_exec.h>
+#ifdef IDLE_WAIT_ENABLE
+#    include <idle_wait.h>
+#endif
 
 #ifndef MAX_DEFERRED_EXECUTORS
 #    define MAX_DEFERRED_EXECUTORS 8
 #endif
 
+#if MAX_DEFERRED_EXECUTORS > 1024
+#    error "MAX_DEFERRED_EXECUTORS is limited to 1024"
+#endif
+
+#if MAX_DEFERRED_EXECUTORS < 255
+typedef uint8_t executor_index_t;
+#    define EXECUTOR_NOT_QUEUED UINT8_MAX
+#else
+typedef uint16_t executor_index_t;
+#    define EXECUTOR_NOT_QUEUED UINT16_MAX
+#endif
+
+// Tokens are slot-indexed: (token - 1) % MAX_DEFERRED_EXECUTORS is the slot that owns it. Each time a slot is reused it
+// hands out the next token in its sequence, so stale tokens for the same slot no longer match and are rejected.
+#define DEFERRED_TOKEN_SPAN ((deferred_token)((((deferred_token)-1) / MAX_DEFERRED_EXECUTORS) * MAX_DEFERRED_EXECUTORS))
+
 typedef struct deferred_executor_t {
     deferred_token         token;
     uint32_t               trigger_time;
     deferred_exec_callback callback;
     void *                 cb_arg;
+    executor_index_t       heap_index;
 } deferred_executor_t;
 
-static deferred_token      current_token                     = 0;
 static uint32_t            last_deferred_exec_check          = 0;
 static deferred_executor_t executors[MAX_DEFERRED_EXECUTORS] = {0};
 
-static inline bool token_can_be_used(deferred_token token) {
-    if (token == INVALID_DEFERRED_TOKEN) {
-        return false;
+// Min-heap of slot indices, ordered by trigger time -- the next executor to fire is always at the root
+static executor_index_t heap[MAX_DEFERRED_EXECUTORS];
+static executor_index_t heap_count = 0;
+
+// Ring of unused slot indices -- handed out oldest first, so each slot cycles through its tokens as slowly as possible
+static executor_index_t free_slots[MAX_DEFERRED_EXECUTORS];
+static executor_index_t free_head   = 0;
+static executor_index_t free_count  = 0;
+static bool             initialized = false;
+
+static inline void deferred_exec_init(void) {
+    for (executor_index_t i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
+        executors[i].token      = i + 1;
+        executors[i].heap_index = EXECUTOR_NOT_QUEUED;
+        free_slots[i]           = i;
+    }
+    free_count  = MAX_DEFERRED_EXECUTORS;
+    initialized = true;
+}
+
+static inline deferred_executor_t *find_executor(deferred_token token) {
+    if (token == INVALID_DEFERRED_TOKEN || token > DEFERRED_TOKEN_SPAN) {
+        return NULL;
     }
-    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-        if (executors[i].token == token) {
-            return false;
+    deferred_executor_t *entry = &executors[(token - 1) % MAX_DEFERRED_EXECUTORS];
+    if (entry->token != token || !entry->callback) {
+        return NULL;
+    }
+    return entry;
+}
+
+static inline void release_executor(deferred_executor_t *entry) {
+    // Move the slot on to its next token, so that the one just released can no longer be used
+    entry->token        = (entry->token > DEFERRED_TOKEN_SPAN - MAX_DEFERRED_EXECUTORS) ? entry->token + MAX_DEFERRED_EXECUTORS - DEFERRED_TOKEN_SPAN : entry->token + MAX_DEFERRED_EXECUTORS;
+    entry->trigger_time = 0;
+    entry->callback     = NULL;
+    entry->cb_arg       = NULL;
+
+    uint16_t tail = (uint16_t)free_head + free_count++;
+    if (tail >= MAX_DEFERRED_EXECUTORS) tail -= MAX_DEFERRED_EXECUTORS;
+    free_slots[tail] = (executor_index_t)(entry - executors);
+}
+
+static inline bool heap_less(executor_index_t a, executor_index_t b) {
+    // Wraparound-safe comparison of trigger times
+    return ((int32_t)TIMER_DIFF_32(executors[heap[a]].trigger_time, executors[heap[b]].trigger_time)) < 0;
+}
+
+static inline void heap_swap(executor_index_t a, executor_index_t b) {
+    executor_index_t tmp = heap[a];
+    heap[a]              = heap[b];
+    heap[b]              = tmp;
+
+    executors[heap[a]].heap_index = a;
+    executors[heap[b]].heap_index = b;
+}
+
+static void heap_sift_up(executor_index_t i) {
+    while (i > 0) {
+        executor_index_t parent = (i - 1) / 2;
+        if (!heap_less(i, parent)) {
+            break;
         }
+        heap_swap(i, parent);
+        i = parent;
     }
-    return true;
 }
 
-static inline deferred_token allocate_token(void) {
-    deferred_token first = ++current_token;
-    while (!token_can_be_used(current_token)) {
-        ++current_token;
-        if (current_token == first) {
-            // If we've looped back around to the first, everything is already allocated (yikes!). Need to exit with a failure.
-            return INVALID_DEFERRED_TOKEN;
+static void heap_sift_down(executor_index_t i) {
+    while (true) {
+        executor_index_t smallest = i;
+        uint16_t         left     = 2 * (uint16_t)i + 1;
+        uint16_t         right    = left + 1;
+        if (left < heap_count && heap_less(left, smallest)) {
+            smallest = left;
+        }
+        if (right < heap_count && heap_less(right, smallest)) {
+            smallest = right;
         }
+        if (smallest == i) {
+            break;
+        }
+        heap_swap(i, smallest);
+        i = smallest;
+    }
+}
+
+static void heap_insert(deferred_executor_t *entry) {
+    executor_index_t i = heap_count++;
+    heap[i]            = (executor_index_t)(entry - executors);
+    entry->heap_index  = i;
+    heap_sift_up(i);
+}
+
+static void heap_remove(deferred_executor_t *entry) {
+    executor_index_t i = entry->heap_index;
+    entry->heap_index  = EXECUTOR_NOT_QUEUED;
+    if (i != --heap_count) {
+        heap[i]                       = heap[heap_count];
+        executors[heap[i]].heap_index = i;
+        // The moved entry may need to go either way
+        heap_sift_up(i);
+        heap_sift_down(executors[heap[i]].heap_index);
     }
-    return current_token;
+}
+
+static void heap_reschedule(deferred_executor_t *entry) {
+    executor_index_t i = entry->heap_index;
+    heap_sift_up(i);
+    heap_sift_down(entry->heap_index);
 }
 
 deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
@@ -50,70 +157,66 @@ deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, vo
         return INVALID_DEFERRED_TOKEN;
     }
 
-    // Find an unused slot and claim it
-    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-        deferred_executor_t *entry = &executors[i];
-        if (entry->token == INVALID_DEFERRED_TOKEN) {
-            // Work out the new token value, dropping out if none were available
-            deferred_token token = allocate_token();
-            if (token == INVALID_DEFERRED_TOKEN) {
-                return false;
-            }
-
-            // Set up the executor table entry
-            entry->token        = current_token;
-            entry->trigger_time = timer_read32() + delay_ms;
-            entry->callback     = callback;
-            entry->cb_arg       = cb_arg;
-            return current_token;
-        }
+    if (!initialized) {
+        deferred_exec_init();
     }
 
     // None available
-    return INVALID_DEFERRED_TOKEN;
+    if (free_count == 0) {
+        return INVALID_DEFERRED_TOKEN;
+    }
+
+    // Claim an unused slot and set up the executor table entry
+    deferred_executor_t *entry = &executors[free_slots[free_head]];
+    if (++free_head == MAX_DEFERRED_EXECUTORS) free_head = 0;
+    --free_count;
+
+    entry->trigger_time = timer_read32() + delay_ms;
+    entry->callback     = callback;
+    entry->cb_arg       = cb_arg;
+    heap_insert(entry);
+#ifdef IDLE_WAIT_ENABLE
+    idle_wakeup_at(entry->trigger_time);
+#endif
+    return entry->token;
 }
 
 bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
     // Ignore queueing if it's a zero-time delay, or the token is not valid
-    if (delay_ms == 0 || token == INVALID_DEFERRED_TOKEN) {
+    if (delay_ms == 0) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-        deferred_executor_t *entry = &executors[i];
-        if (entry->token == token) {
-            // Found it, extend the delay
-            entry->trigger_time = timer_read32() + delay_ms;
-            return true;
-        }
+    deferred_executor_t *entry = find_executor(token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, extend the delay -- if it's currently executing it gets requeued once the callback returns
+    entry->trigger_time = timer_read32() + delay_ms;
+    if (entry->heap_index != EXECUTOR_NOT_QUEUED) {
+        heap_reschedule(entry);
+    }
+#ifdef IDLE_WAIT_ENABLE
+    idle_wakeup_at(entry->trigger_time);
+#endif
+    return true;
 }
 
 bool cancel_deferred_exec(deferred_token token) {
-    // Ignore request if the token is not valid
-    if (token == INVALID_DEFERRED_TOKEN) {
+    // Find the entry corresponding to the token
+    deferred_executor_t *entry = find_executor(token);
+    if (!entry) {
         return false;
     }
 
-    // Find the entry corresponding to the token
-    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-        deferred_executor_t *entry = &executors[i];
-        if (entry->token == token) {
-            // Found it, cancel and clear the table entry
-            entry->token        = INVALID_DEFERRED_TOKEN;
-            entry->trigger_time = 0;
-            entry->callback     = NULL;
-            entry->cb_arg       = NULL;
-            return true;
-        }
+    // Found it, cancel and clear the table entry
+    if (entry->heap_index != EXECUTOR_NOT_QUEUED) {
+        heap_remove(entry);
     }
-
-    // Not found
-    return false;
+    release_executor(entry);
+    return true;
 }
 
 void deferred_exec_task(void) {
@@ -123,30 +226,47 @@ void deferred_exec_task(void) {
     if (((int32_t)TIMER_DIFF_32(now, last_deferred_exec_check)) > 0) {
         last_deferred_exec_check = now;
 
-        // Run through each of the executors
-        for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-            deferred_executor_t *entry = &executors[i];
+        // Run through the executors which are due, earliest first. Invocations per pass are bounded by the number queued at
+        // the start, so a repeating executor that has fallen behind can't monopolise the pass catching up.
+        for (executor_index_t budget = heap_count; budget > 0 && heap_count > 0; --budget) {
+            deferred_executor_t *entry = &executors[heap[0]];
 
             // Check if we're supposed to execute this entry
-            if (entry->token != INVALID_DEFERRED_TOKEN && ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
-                // Invoke the callback and work work out if we should be requeued
-                uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
-
-                // Update the trigger time if we have to repeat, otherwise clear it out
-                if (delay_ms > 0) {
-                    // Intentionally add just the delay to the existing trigger time -- this ensures the next
-                    // invocation is with respect to the previous trigger, rather than when it got to execution. Under
-                    // normal circumstances this won't cause issue, but if another executor is invoked that takes a
-                    // considerable length of time, then this ensures best-effort timing between invocations.
-                    entry->trigger_time += delay_ms;
-                } else {
-                    // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
-                    entry->token        = INVALID_DEFERRED_TOKEN;
-                    entry->trigger_time = 0;
-                    entry->callback     = NULL;
-                    entry->cb_arg       = NULL;
-                }
+            if (((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) > 0) {
+                break;
+            }
+
+            // Dequeue it while the callback runs, so that the callback is free to extend or cancel itself
+            heap_remove(entry);
+
+            // Invoke the callback and work work out if we should be requeued
+            deferred_token token    = entry->token;
+            uint32_t       delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
+
+            // The callback cancelled itself
+            if (entry->token != token || !entry->callback) {
+                continue;
+            }
+
+            // Update the trigger time if we have to repeat, otherwise clear it out
+            if (delay_ms > 0) {
+                // Intentionally add just the delay to the existing trigger time -- this ensures the next
+                // invocation is with respect to the previous trigger, rather than when it got to execution. Under
+                // normal circumstances this won't cause issue, but if another executor is invoked that takes a
+                // considerable length of time, then this ensures best-effort timing between invocations.
+                entry->trigger_time += delay_ms;
+                heap_insert(entry);
+            } else {
+                // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
+                release_executor(entry);
             }
         }
     }
+
+#ifdef IDLE_WAIT_ENABLE
+    // Make sure the main loop is awake for the next executor
+    if (heap_count > 0) {
+        idle_wakeup_at(executors[heap[0]].trigger_time);
+    }
+#endif
 }
@@ -7,7 +7,7 @@
 #include <stdint.h>
 
 // A token that can be used to cancel an existing deferred execution.
-typedef uint8_t deferred_token;
+typedef uint16_t deferred_token;
 #define INVALID_DEFERRED_TOKEN 0
 
 // Callback to execute.
@@ -21,6 +21,12 @@
 #include "quantum.h"  // for send_string()
 #include "dynamic_keymap.h"
 #include "via.h"  // for default VIA_EEPROM_ADDR_END
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+#    include "timer.h"
+#endif
+#ifdef IDLE_WAIT_ENABLE
+#    include "idle_wait.h"
+#endif
 
 #ifndef DYNAMIC_KEYMAP_LAYER_COUNT
 #    define DYNAMIC_KEYMAP_LAYER_COUNT 4
@@ -81,6 +87,144 @@
 #    define DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE (DYNAMIC_KEYMAP_EEPROM_MAX_ADDR - DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + 1)
 #endif
 
+#define DYNAMIC_KEYMAP_EEPROM_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+// How long EEPROM writes are held back after the last change, so that a burst of writes from the host is coalesced
+#    ifndef DYNAMIC_KEYMAP_WRITE_BACK_DELAY
+#        define DYNAMIC_KEYMAP_WRITE_BACK_DELAY 1000
+#    endif
+
+// Maximum number of bytes written back to EEPROM per call of dynamic_keymap_task()
+#    ifndef DYNAMIC_KEYMAP_WRITE_BACK_CHUNK
+#        define DYNAMIC_KEYMAP_WRITE_BACK_CHUNK 32
+#    endif
+
+// A copy of an EEPROM region held in RAM, along with the range which has changed since it was last written back
+typedef struct {
+    uint8_t *mirror;
+    void *   eeprom;
+    uint16_t size;
+    uint16_t dirty_start;
+    uint16_t dirty_end;
+} dynamic_keymap_region_t;
+
+static uint8_t keymap_mirror[DYNAMIC_KEYMAP_EEPROM_SIZE];
+static uint8_t macro_mirror[DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE];
+
+static dynamic_keymap_region_t keymap_region = {keymap_mirror, (void *)DYNAMIC_KEYMAP_EEPROM_ADDR, DYNAMIC_KEYMAP_EEPROM_SIZE, 0, 0};
+static dynamic_keymap_region_t macro_region  = {macro_mirror, (void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR, DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE, 0, 0};
+
+static bool     mirror_loaded   = false;
+static uint32_t last_write_time = 0;
+
+static void dynamic_keymap_mirror_load(void) {
+    eeprom_read_block(keymap_mirror, keymap_region.eeprom, sizeof(keymap_mirror));
+    eeprom_read_block(macro_mirror, macro_region.eeprom, sizeof(macro_mirror));
+    mirror_loaded = true;
+}
+
+static inline uint8_t region_read_byte(dynamic_keymap_region_t *region, uint16_t offset) {
+    if (!mirror_loaded) {
+        dynamic_keymap_mirror_load();
+    }
+    return region->mirror[offset];
+}
+
+static void region_write_byte(dynamic_keymap_region_t *region, uint16_t offset, uint8_t value) {
+    if (!mirror_loaded) {
+        dynamic_keymap_mirror_load();
+    }
+    if (region->mirror[offset] == value) {
+        return;
+    }
+    region->mirror[offset] = value;
+
+    // Grow the dirty range to cover the change
+    if (region->dirty_start == region->dirty_end) {
+        region->dirty_start = offset;
+        region->dirty_end   = offset + 1;
+    } else if (offset < region->dirty_start) {
+        region->dirty_start = offset;
+    } else if (offset >= region->dirty_end) {
+        region->dirty_end = offset + 1;
+    }
+    last_write_time = timer_read32();
+#    ifdef IDLE_WAIT_ENABLE
+    idle_wakeup_at(last_write_time + DYNAMIC_KEYMAP_WRITE_BACK_DELAY);
+#    endif
+}
+
+// Marks the whole region to be written back, whatever the mirror already holds. Resets use this, as the
+// EEPROM may have been erased since the mirror was loaded, and the defaults would then match the stale mirror.
+static void region_mark_dirty(dynamic_keymap_region_t *region) {
+    region->dirty_start = 0;
+    region->dirty_end   = region->size;
+    last_write_time     = timer_read32();
+#    ifdef IDLE_WAIT_ENABLE
+    idle_wakeup_at(last_write_time + DYNAMIC_KEYMAP_WRITE_BACK_DELAY);
+#    endif
+}
+
+// Writes back up to limit bytes from the start of the dirty range, returns the number of bytes written
+static uint16_t region_flush(dynamic_keymap_region_t *region, uint16_t limit) {
+    uint16_t start = region->dirty_start;
+    uint16_t end   = region->dirty_end;
+    if (start == end) {
+        return 0;
+    }
+    if (end - start > limit) {
+        end = start + limit;
+    } else if (end == region->size && end - start > 1 && region == &macro_region) {
+        // The last byte of the macro buffer marks it as valid, so it always goes out after the rest of the buffer
+        end--;
+    }
+    eeprom_update_block(region->mirror + start, region->eeprom + start, end - start);
+    region->dirty_start = end;
+    if (region->dirty_start == region->dirty_end) {
+        region->dirty_start = region->dirty_end = 0;
+    }
+    return end - start;
+}
+
+void dynamic_keymap_task(void) {
+    if (keymap_region.dirty_start == keymap_region.dirty_end && macro_region.dirty_start == macro_region.dirty_end) {
+        return;
+    }
+    if (timer_elapsed32(last_write_time) < DYNAMIC_KEYMAP_WRITE_BACK_DELAY) {
+        return;
+    }
+
+    uint16_t written = region_flush(&keymap_region, DYNAMIC_KEYMAP_WRITE_BACK_CHUNK);
+    if (written < DYNAMIC_KEYMAP_WRITE_BACK_CHUNK) {
+        region_flush(&macro_region, DYNAMIC_KEYMAP_WRITE_BACK_CHUNK - written);
+    }
+#    ifdef IDLE_WAIT_ENABLE
+    // Keep going on the next pass if there is more to write back
+    if (keymap_region.dirty_start != keymap_region.dirty_end || macro_region.dirty_start != macro_region.dirty_end) {
+        idle_wakeup_in(0);
+    }
+#    endif
+}
+
+void dynamic_keymap_flush(void) {
+    while (region_flush(&keymap_region, DYNAMIC_KEYMAP_EEPROM_SIZE) > 0) {
+    }
+    while (region_flush(&macro_region, DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) > 0) {
+    }
+}
+
+#    define keymap_read_byte(offset) region_read_byte(&keymap_region, offset)
+#    define keymap_write_byte(offset, value) region_write_byte(&keymap_region, offset, value)
+#    define macro_read_byte(offset) region_read_byte(&macro_region, offset)
+#    define macro_write_byte(offset, value) region_write_byte(&macro_region, offset, value)
+#else
+#    define keymap_read_byte(offset) eeprom_read_byte((void *)DYNAMIC_KEYMAP_EEPROM_ADDR + (offset))
+#    define keymap_write_byte(offset, value) eeprom_update_byte((void *)DYNAMIC_KEYMAP_EEPROM_ADDR + (offset), value)
+#    define macro_read_byte(offset) eeprom_read_byte((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + (offset))
+#    define macro_write_byte(offset, value) eeprom_update_byte((void *)DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + (offset), value)
+#endif
+
 uint8_t dynamic_keymap_get_layer_count(void) { return DYNAMIC_KEYMAP_LAYER_COUNT; }
 
 void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t column) {
@@ -88,19 +232,24 @@ void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t c
     return ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2);
 }
 
+static inline uint16_t dynamic_keymap_key_to_offset(uint8_t layer, uint8_t row, uint8_t column) { return (layer * MATRIX_ROWS * MATRIX_COLS * 2) + (row * MATRIX_COLS * 2) + (column * 2); }
+
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
-    void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
+    uint16_t offset = dynamic_keymap_key_to_offset(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    uint16_t keycode = eeprom_read_byte(address) << 8;
-    keycode |= eeprom_read_byte(address + 1);
+    uint16_t keycode = keymap_read_byte(offset) << 8;
+    keycode |= keymap_read_byte(offset + 1);
     return keycode;
 }
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
-    void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
+    uint16_t offset = dynamic_keymap_key_to_offset(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    eeprom_update_byte(address, (uint8_t)(keycode >> 8));
-    eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+    keymap_write_byte(offset, (uint8_t)(keycode >> 8));
+    keymap_write_byte(offset + 1, (uint8_t)(keycode & 0xFF));
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_invalidate();
+#endif
 }
 
 void dynamic_keymap_reset(void) {
@@ -114,34 +263,34 @@ void dynamic_keymap_reset(void) {
             }
         }
     }
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    region_mark_dirty(&keymap_region);
+#endif
 }
 
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *target                     = data;
+    uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
-            *target = eeprom_read_byte(source);
+        if (offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE) {
+            *target = keymap_read_byte(offset + i);
         } else {
             *target = 0x00;
         }
-        source++;
         target++;
     }
 }
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
-    uint8_t *source                     = data;
+    uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
-        if (offset + i < dynamic_keymap_eeprom_size) {
-            eeprom_update_byte(target, *source);
+        if (offset + i < DYNAMIC_KEYMAP_EEPROM_SIZE) {
+            keymap_write_byte(offset + i, *source);
         }
         source++;
-        target++;
     }
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_invalidate();
+#endif
 }
 
 // This overrides the one in quantum/keymap_common.c
@@ -158,40 +307,41 @@ uint8_t dynamic_keymap_macro_get_count(void) { return DYNAMIC_KEYMAP_MACRO_COUNT
 uint16_t dynamic_keymap_macro_get_buffer_size(void) { return DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE; }
 
 void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   source = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
-            *target = eeprom_read_byte(source);
+            *target = macro_read_byte(offset + i);
         } else {
             *target = 0x00;
         }
-        source++;
         target++;
     }
 }
 
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   target = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
-            eeprom_update_byte(target, *source);
+            macro_write_byte(offset + i, *source);
         }
         source++;
-        target++;
     }
 }
 
 void dynamic_keymap_macro_reset(void) {
-    void *p   = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
-    void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
-    while (p != end) {
-        eeprom_update_byte(p, 0);
-        ++p;
+    for (uint16_t i = 0; i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE; i++) {
+        macro_write_byte(i, 0);
     }
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    region_mark_dirty(&macro_region);
+#endif
 }
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+// The macro is read while it's typed, and may be rewritten meanwhile, so stop at the end of the buffer
+static uint8_t dynamic_keymap_macro_read(uint16_t offset) { return offset < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE ? macro_read_byte(offset) : 0; }
+
+#endif
 void dynamic_keymap_macro_send(uint8_t id) {
     if (id >= DYNAMIC_KEYMAP_MACRO_COUNT) {
         return;
@@ -201,35 +351,37 @@ void dynamic_keymap_macro_send(uint8_t id) {
     // If it's not zero, then we are in the middle
     // of buffer writing, possibly an aborted buffer
     // write. So do nothing.
-    void *p = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - 1);
-    if (eeprom_read_byte(p) != 0) {
+    if (macro_read_byte(DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - 1) != 0) {
         return;
     }
 
     // Skip N null characters
     // p will then point to the Nth macro
-    p         = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
-    void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
+    uint16_t p = 0;
     while (id > 0) {
         // If we are past the end of the buffer, then the buffer
         // contents are garbage, i.e. there were not DYNAMIC_KEYMAP_MACRO_COUNT
         // nulls in the buffer.
-        if (p == end) {
+        if (p == DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
             return;
         }
-        if (eeprom_read_byte(p) == 0) {
+        if (macro_read_byte(p) == 0) {
             --id;
         }
         ++p;
     }
 
+#ifdef SEND_STRING_ASYNC_ENABLE
+    // Typed from the main loop, reading the macro as it goes
+    send_string_async_reader(dynamic_keymap_macro_read, p);
+#else
     // Send the macro string one or three chars at a time
     // by making temporary 1 or 3 char strings
     char data[4] = {0, 0, 0, 0};
     // We already checked there was a null at the end of
     // the buffer, so this cannot go past the end
     while (1) {
-        data[0] = eeprom_read_byte(p++);
+        data[0] = macro_read_byte(p++);
         data[1] = 0;
         // Stop at the null terminator of this macro string
         if (data[0] == 0) {
@@ -240,11 +392,12 @@ void dynamic_keymap_macro_send(uint8_t id) {
         if (data[0] == SS_TAP_CODE || data[0] == SS_DOWN_CODE || data[0] == SS_UP_CODE) {
             data[1] = data[0];
             data[0] = SS_QMK_PREFIX;
-            data[2] = eeprom_read_byte(p++);
+            data[2] = macro_read_byte(p++);
             if (data[2] == 0) {
                 break;
             }
         }
         send_string(data);
     }
+#endif
 }
@@ -58,3 +58,12 @@ void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t
 void     dynamic_keymap_macro_reset(void);
 
 void dynamic_keymap_macro_send(uint8_t id);
+
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+// With DYNAMIC_KEYMAP_RAM_MIRROR, all of the above are served from a copy of the keymaps
+// and macros in RAM. Changes are written back to EEPROM by dynamic_keymap_task()
+// once writes have stopped for DYNAMIC_KEYMAP_WRITE_BACK_DELAY milliseconds, or
+// immediately by dynamic_keymap_flush().
+void dynamic_keymap_task(void);
+void dynamic_keymap_flush(void);
+#endif
@@ -0,0 +1,37 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <timer.h>
+#include <idle_wait.h>
+
+static bool     wakeup_requested = false;
+static uint32_t wakeup_time      = 0;
+
+void idle_wakeup_at(uint32_t time) {
+    // Keep whichever wakeup comes first
+    if (!wakeup_requested || ((int32_t)TIMER_DIFF_32(time, wakeup_time)) < 0) {
+        wakeup_requested = true;
+        wakeup_time      = time;
+    }
+}
+
+void idle_wakeup_in(uint32_t delay_ms) { idle_wakeup_at(timer_read32() + delay_ms); }
+
+// Platforms without a way to sleep keep polling as fast as possible
+__attribute__((weak)) void idle_wakeup_from_isr(void) {}
+__attribute__((weak)) void platform_idle_wait(uint32_t timeout_ms) {}
+
+void idle_wait_task(void) {
+    uint32_t now       = timer_read32();
+    int32_t  remaining = wakeup_requested ? (int32_t)TIMER_DIFF_32(wakeup_time, now) : IDLE_WAIT_MAX_MS;
+
+    // Everything has to publish its next deadline again on the next iteration
+    wakeup_requested = false;
+
+    if (remaining > IDLE_WAIT_MAX_MS) {
+        remaining = IDLE_WAIT_MAX_MS;
+    }
+    if (remaining > 0) {
+        platform_idle_wait(remaining);
+    }
+}
@@ -0,0 +1,35 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// The longest the main loop will ever sleep for, even if nothing requested an earlier wakeup.
+#ifndef IDLE_WAIT_MAX_MS
+#    define IDLE_WAIT_MAX_MS 100
+#endif
+
+// How often the matrix is polled while the main loop is otherwise idle.
+#ifndef IDLE_WAIT_MATRIX_SCAN_INTERVAL
+#    define IDLE_WAIT_MATRIX_SCAN_INTERVAL 1
+#endif
+
+// Requests that the main loop runs again no later than the supplied time.
+//  -- Parameter time: the time to wake up at -- equivalent time-space as timer_read32()
+void idle_wakeup_at(uint32_t time);
+
+// Requests that the main loop runs again no later than the supplied number of milliseconds from now.
+//  -- Parameter delay_ms: the number of milliseconds to wake up after, zero prevents the next iteration from sleeping at all
+void idle_wakeup_in(uint32_t delay_ms);
+
+// Wakes the main loop early if it's currently sleeping. Safe to invoke from interrupt handlers.
+void idle_wakeup_from_isr(void);
+
+// Platform-specific wait for the main loop, returning after the timeout or as soon as idle_wakeup_from_isr() is invoked.
+//  -- Parameter timeout_ms: the maximum number of milliseconds to wait for
+void platform_idle_wait(uint32_t timeout_ms);
+
+// Forward declaration for the main loop in order to sleep until the earliest requested wakeup. Should not be invoked by keyboard/user code.
+void idle_wait_task(void);
@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "task_profile.h"
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -100,6 +101,19 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef SLEEP_LED_ENABLE
 #    include "sleep_led.h"
 #endif
+#ifdef IDLE_WAIT_ENABLE
+#    include "idle_wait.h"
+#endif
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_MIRROR)
+#    include "dynamic_keymap.h"
+#endif
+#ifdef SEND_STRING_ASYNC_ENABLE
+#    include "send_string.h"
+#endif
+#if defined(SPLIT_KEYBOARD) && (defined(SERIAL_USART_SLAVE_PUSH) || defined(MATRIX_BACKGROUND_SCAN_ENABLE))
+#    include "split_util.h"
+#    include "transactions.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) { return last_input_modification_time; }
@@ -363,102 +377,200 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
 #endif
 }
 
-/** \brief Keyboard task: Do keyboard routine jobs
+#ifndef QMK_KEYS_PER_SCAN
+#    define QMK_KEYS_PER_SCAN 16
+#endif
+#ifndef QMK_KEYS_PER_SCAN_BUDGET
+#    define QMK_KEYS_PER_SCAN_BUDGET 0
+#endif
+
+/** \brief matrix_task
  *
- * Do routine keyboard jobs:
+ * Scans the matrix and dispatches every changed key to the action layer in a single pass.
  *
- * * scan matrix
- * * handle mouse movements
- * * handle midi commands
- * * light LEDs
+ * Changed keys are first collected in row-major order into a queue of up to QMK_KEYS_PER_SCAN
+ * events, all stamped with the same scan time, and then dispatched in order. Keys that do not
+ * fit in the queue, or that are left over once QMK_KEYS_PER_SCAN_BUDGET milliseconds have been
+ * spent dispatching, stay pending in matrix_prev and are picked up on the next pass. The next
+ * pass starts at the first row that was left pending, so a busy row cannot starve the rows
+ * after it.
  *
- * This is repeatedly called as fast as possible.
+ * Returns true if the matrix changed.
  */
-void keyboard_task(void) {
+static bool matrix_task(void) {
     static matrix_row_t matrix_prev[MATRIX_ROWS];
-    static uint8_t      led_status    = 0;
-    matrix_row_t        matrix_row    = 0;
-    matrix_row_t        matrix_change = 0;
-#ifdef QMK_KEYS_PER_SCAN
-    uint8_t keys_processed = 0;
-#endif
-#ifdef ENCODER_ENABLE
-    bool encoders_changed = false;
-#endif
+    static uint8_t      start_row = 0;
+    keyevent_t          events[QMK_KEYS_PER_SCAN];
+    uint8_t             events_count = 0;
 
+    TASK_PROFILE_BEGIN(TASK_PROFILE_MATRIX_SCAN);
     uint8_t matrix_changed = matrix_scan();
+    TASK_PROFILE_END(TASK_PROFILE_MATRIX_SCAN);
     if (matrix_changed) last_matrix_activity_trigger();
 
-    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
-        matrix_row    = matrix_get_row(r);
-        matrix_change = matrix_row ^ matrix_prev[r];
-        if (matrix_change) {
+#if QMK_KEYS_PER_SCAN_BUDGET > 0
+    const uint16_t budget_start = timer_read();
+    const uint16_t scan_time    = budget_start | 1; /* time should not be 0 */
+#else
+    const uint16_t scan_time = timer_read() | 1; /* time should not be 0 */
+#endif
+#if (defined(SPLIT_KEYBOARD) && defined(SERIAL_USART_SLAVE_PUSH)) || defined(MATRIX_BACKGROUND_SCAN_ENABLE)
+    static uint16_t last_event_time = 0;
+#endif
+
+    uint8_t pending_row = MATRIX_ROWS;
+    for (uint8_t i = 0; i < MATRIX_ROWS && pending_row == MATRIX_ROWS; i++) {
+        uint8_t r = start_row + i;
+        if (r >= MATRIX_ROWS) r -= MATRIX_ROWS;
+
+        matrix_row_t matrix_row    = matrix_get_row(r);
+        matrix_row_t matrix_change = matrix_row ^ matrix_prev[r];
+        if (!matrix_change) continue;
 #ifdef MATRIX_HAS_GHOST
-            if (has_ghost_in_row(r, matrix_row)) {
-                continue;
-            }
+        if (has_ghost_in_row(r, matrix_row)) continue;
 #endif
-            if (debug_matrix) matrix_print();
-            matrix_row_t col_mask = 1;
-            for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
-                if (matrix_change & col_mask) {
-                    if (should_process_keypress()) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
-                    }
-                    // record a processed key
-                    matrix_prev[r] ^= col_mask;
-
-                    switch_events(r, c, (matrix_row & col_mask));
-
-#ifdef QMK_KEYS_PER_SCAN
-                    // only jump out if we have processed "enough" keys.
-                    if (++keys_processed >= QMK_KEYS_PER_SCAN)
-#endif
-                        // process a key per task call
-                        goto MATRIX_LOOP_END;
+        uint16_t event_time = scan_time;
+#if (defined(SPLIT_KEYBOARD) && defined(SERIAL_USART_SLAVE_PUSH)) || defined(MATRIX_BACKGROUND_SCAN_ENABLE)
+        const uint16_t not_before = events_count ? events[events_count - 1].time : last_event_time;
+#endif
+#ifdef MATRIX_BACKGROUND_SCAN_ENABLE
+        // Keys on this half carry the time the background scan saw them change, without going back before the events ahead of them
+#    ifdef SPLIT_KEYBOARD
+        if ((r < MATRIX_ROWS / 2) == isLeftHand)
+#    endif
+            event_time = matrix_event_time(r, not_before, scan_time);
+#endif
+#if defined(SPLIT_KEYBOARD) && defined(SERIAL_USART_SLAVE_PUSH)
+        // Keys on the other half carry the time the slave saw them change, without going back before the events ahead of them
+        if ((r < MATRIX_ROWS / 2) != isLeftHand) event_time = transactions_slave_event_time(not_before, scan_time);
+#endif
+        matrix_row_t col_mask = 1;
+        for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
+            if (matrix_change & col_mask) {
+                if (events_count >= QMK_KEYS_PER_SCAN) {
+                    // queue is full, the rest of the changes stay pending
+                    pending_row = r;
+                    break;
                 }
+                events[events_count++] = (keyevent_t){.key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = event_time};
             }
         }
     }
-    // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
-    // we can get here with some keys processed now.
-    if (!keys_processed)
+
+#ifdef IDLE_WAIT_ENABLE
+    idle_wakeup_in(IDLE_WAIT_MATRIX_SCAN_INTERVAL);
 #endif
+
+    if (events_count == 0) {
+        // call with pseudo tick event when no real key event.
+        TASK_PROFILE_BEGIN(TASK_PROFILE_ACTION_EXEC);
         action_exec(TICK);
+        TASK_PROFILE_END(TASK_PROFILE_ACTION_EXEC);
+        return matrix_changed;
+    }
+
+    if (debug_matrix) matrix_print();
 
-MATRIX_LOOP_END:
+    const bool process_keypress = should_process_keypress();
+    uint8_t    dispatched       = 0;
+    while (dispatched < events_count) {
+        keyevent_t event = events[dispatched++];
+#if (defined(SPLIT_KEYBOARD) && defined(SERIAL_USART_SLAVE_PUSH)) || defined(MATRIX_BACKGROUND_SCAN_ENABLE)
+        last_event_time = event.time;
+#endif
+        if (process_keypress) {
+            TASK_PROFILE_BEGIN(TASK_PROFILE_ACTION_EXEC);
+            action_exec(event);
+            TASK_PROFILE_END(TASK_PROFILE_ACTION_EXEC);
+        }
+        // record a processed key
+        matrix_prev[event.key.row] ^= ((matrix_row_t)1 << event.key.col);
+
+        switch_events(event.key.row, event.key.col, event.pressed);
+
+#if QMK_KEYS_PER_SCAN_BUDGET > 0
+        // leave the remaining keys pending once dispatch has used up its time budget
+        if (timer_elapsed(budget_start) >= QMK_KEYS_PER_SCAN_BUDGET) break;
+#endif
+    }
+
+    // resume from the first row with pending changes, so busy rows cannot starve the ones after them
+    if (dispatched < events_count) {
+        start_row = events[dispatched].key.row;
+    } else if (pending_row < MATRIX_ROWS) {
+        start_row = pending_row;
+    } else {
+        start_row = 0;
+    }
+
+#ifdef IDLE_WAIT_ENABLE
+    // don't sleep while there are keys left to process
+    if (dispatched < events_count || pending_row < MATRIX_ROWS) idle_wakeup_in(0);
+#endif
+
+    return matrix_changed;
+}
+
+/** \brief Keyboard task: Do keyboard routine jobs
+ *
+ * Do routine keyboard jobs:
+ *
+ * * scan matrix
+ * * handle mouse movements
+ * * handle midi commands
+ * * light LEDs
+ *
+ * This is repeatedly called as fast as possible.
+ */
+void keyboard_task(void) {
+    static uint8_t led_status = 0;
+#ifdef ENCODER_ENABLE
+    bool encoders_changed = false;
+#endif
+    TASK_PROFILE_BEGIN(TASK_PROFILE_KEYBOARD_TASK);
+
+    __attribute__((unused)) bool matrix_changed = matrix_task();
 
 #ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_scan_perf_task();
 #endif
 
 #if defined(RGBLIGHT_ENABLE)
+    TASK_PROFILE_BEGIN(TASK_PROFILE_RGBLIGHT);
     rgblight_task();
+    TASK_PROFILE_END(TASK_PROFILE_RGBLIGHT);
 #endif
 
 #ifdef LED_MATRIX_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_LED_MATRIX);
     led_matrix_task();
+    TASK_PROFILE_END(TASK_PROFILE_LED_MATRIX);
 #endif
 #ifdef RGB_MATRIX_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_RGB_MATRIX);
     rgb_matrix_task();
+    TASK_PROFILE_END(TASK_PROFILE_RGB_MATRIX);
 #endif
 
 #if defined(BACKLIGHT_ENABLE)
 #    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
+    TASK_PROFILE_BEGIN(TASK_PROFILE_BACKLIGHT);
     backlight_task();
+    TASK_PROFILE_END(TASK_PROFILE_BACKLIGHT);
 #    endif
 #endif
 
 #ifdef ENCODER_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_ENCODER);
     encoders_changed = encoder_read();
+    TASK_PROFILE_END(TASK_PROFILE_ENCODER);
     if (encoders_changed) last_encoder_activity_trigger();
 #endif
 
 #ifdef OLED_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_OLED);
     oled_task();
+    TASK_PROFILE_END(TASK_PROFILE_OLED);
 #    if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
 #        ifdef ENCODER_ENABLE
@@ -470,7 +582,9 @@ MATRIX_LOOP_END:
 #endif
 
 #ifdef ST7565_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_ST7565);
     st7565_task();
+    TASK_PROFILE_END(TASK_PROFILE_ST7565);
 #    if ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
 #        ifdef ENCODER_ENABLE
@@ -483,19 +597,27 @@ MATRIX_LOOP_END:
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
+    TASK_PROFILE_BEGIN(TASK_PROFILE_MOUSEKEY);
     mousekey_task();
+    TASK_PROFILE_END(TASK_PROFILE_MOUSEKEY);
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_PS2_MOUSE);
     ps2_mouse_task();
+    TASK_PROFILE_END(TASK_PROFILE_PS2_MOUSE);
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_POINTING_DEVICE);
     pointing_device_task();
+    TASK_PROFILE_END(TASK_PROFILE_POINTING_DEVICE);
 #endif
 
 #ifdef MIDI_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_MIDI);
     midi_task();
+    TASK_PROFILE_END(TASK_PROFILE_MIDI);
 #endif
 
 #ifdef VELOCIKEY_ENABLE
@@ -505,22 +627,45 @@ MATRIX_LOOP_END:
 #endif
 
 #ifdef JOYSTICK_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_JOYSTICK);
     joystick_task();
+    TASK_PROFILE_END(TASK_PROFILE_JOYSTICK);
 #endif
 
 #ifdef DIGITIZER_ENABLE
+    TASK_PROFILE_BEGIN(TASK_PROFILE_DIGITIZER);
     digitizer_task();
+    TASK_PROFILE_END(TASK_PROFILE_DIGITIZER);
 #endif
 
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
     programmable_button_send();
 #endif
 
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_MIRROR)
+    dynamic_keymap_task();
+#endif
+
+#ifdef SEND_STRING_ASYNC_ENABLE
+    send_string_async_task();
+#endif
+
+#ifdef EEPROM_DRIVER
+    TASK_PROFILE_BEGIN(TASK_PROFILE_EEPROM);
+    eeprom_driver_task();
+    TASK_PROFILE_END(TASK_PROFILE_EEPROM);
+#endif
+
     // update LED
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+
+    TASK_PROFILE_END(TASK_PROFILE_KEYBOARD_TASK);
+#ifdef TASK_PROFILE_ENABLE
+    task_profile_task();
+#endif
 }
 
 /** \brief keyboard set leds
@@ -96,6 +96,10 @@ uint8_t g_led_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif  // LED_MATRIX_KEYREACTIVE_ENABLED
+uint8_t g_led_center_distance[DRIVER_LED_TOTAL];
+#ifdef LED_MATRIX_LED_DISTANCE_TABLE
+uint8_t g_led_led_distance[LED_MATRIX_LED_DISTANCE_TABLE_SIZE];
+#endif  // LED_MATRIX_LED_DISTANCE_TABLE
 
 // internals
 static bool            suspend_state     = false;
@@ -375,6 +379,16 @@ void led_matrix_task(void) {
             led_task_sync();
             break;
     }
+
+#ifdef IDLE_WAIT_ENABLE
+    // Frames are rendered over several iterations, only sleep while waiting for the next one to be due
+    if (led_task_state == SYNCING) {
+        uint32_t elapsed = sync_timer_elapsed32(g_led_timer);
+        idle_wakeup_in(elapsed < LED_MATRIX_LED_FLUSH_LIMIT ? LED_MATRIX_LED_FLUSH_LIMIT - elapsed : 0);
+    } else {
+        idle_wakeup_in(0);
+    }
+#endif  // IDLE_WAIT_ENABLE
 }
 
 void led_matrix_indicators(void) {
@@ -408,8 +422,26 @@ __attribute__((weak)) void led_matrix_indicators_advanced_kb(uint8_t led_min, ui
 
 __attribute__((weak)) void led_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {}
 
+static uint8_t led_matrix_point_distance(led_point_t a, led_point_t b) {
+    int16_t dx = a.x - b.x;
+    int16_t dy = a.y - b.y;
+    return sqrt16(dx * dx + dy * dy);
+}
+
+void led_matrix_update_geometry(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        g_led_center_distance[i] = led_matrix_point_distance(g_led_config.point[i], k_led_matrix_center);
+#ifdef LED_MATRIX_LED_DISTANCE_TABLE
+        for (uint8_t j = 0; j < i; j++) {
+            g_led_led_distance[LED_MATRIX_LED_DISTANCE_INDEX(i, j)] = led_matrix_point_distance(g_led_config.point[i], g_led_config.point[j]);
+        }
+#endif  // LED_MATRIX_LED_DISTANCE_TABLE
+    }
+}
+
 void led_matrix_init(void) {
     led_matrix_driver.init();
+    led_matrix_update_geometry();
 
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
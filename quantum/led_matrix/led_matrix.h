@@ -121,6 +121,8 @@ void led_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max);
 void led_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max);
 
 void led_matrix_init(void);
+// Works out the LED distances again, for keyboards that change g_led_config after init
+void led_matrix_update_geometry(void);
 
 void        led_matrix_set_suspend_state(bool state);
 bool        led_matrix_get_suspend_state(void);
@@ -191,3 +193,18 @@ extern last_hit_t g_last_hit_tracker;
 #ifdef LED_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_led_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
+
+// Distance of each LED from the center, worked out from g_led_config by led_matrix_update_geometry()
+extern uint8_t g_led_center_distance[DRIVER_LED_TOTAL];
+
+#ifdef LED_MATRIX_LED_DISTANCE_TABLE
+// Distance between each pair of LEDs, only one of each pair is kept, read it with led_matrix_led_distance()
+#    define LED_MATRIX_LED_DISTANCE_TABLE_SIZE (DRIVER_LED_TOTAL * (DRIVER_LED_TOTAL - 1) / 2)
+#    define LED_MATRIX_LED_DISTANCE_INDEX(a, b) ((uint16_t)(a) * ((a)-1) / 2 + (b))
+extern uint8_t g_led_led_distance[LED_MATRIX_LED_DISTANCE_TABLE_SIZE];
+
+static inline uint8_t led_matrix_led_distance(uint8_t a, uint8_t b) {
+    if (a == b) return 0;
+    return a > b ? g_led_led_distance[LED_MATRIX_LED_DISTANCE_INDEX(a, b)] : g_led_led_distance[LED_MATRIX_LED_DISTANCE_INDEX(b, a)];
+}
+#endif
@@ -15,6 +15,7 @@
  */
 
 #include "keyboard.h"
+#include "task_profile.h"
 
 void platform_setup(void);
 
@@ -47,6 +48,10 @@ void protocol_task(void) {
 void deferred_exec_task(void);
 #endif  // DEFERRED_EXEC_ENABLE
 
+#ifdef IDLE_WAIT_ENABLE
+void idle_wait_task(void);
+#endif  // IDLE_WAIT_ENABLE
+
 /** \brief Main
  *
  * FIXME: Needs doc
@@ -65,9 +70,18 @@ int main(void) {
 
 #ifdef DEFERRED_EXEC_ENABLE
         // Run deferred executions
+        TASK_PROFILE_BEGIN(TASK_PROFILE_DEFERRED_EXEC);
         deferred_exec_task();
+        TASK_PROFILE_END(TASK_PROFILE_DEFERRED_EXEC);
 #endif  // DEFERRED_EXEC_ENABLE
 
+        TASK_PROFILE_BEGIN(TASK_PROFILE_HOUSEKEEPING);
         housekeeping_task();
+        TASK_PROFILE_END(TASK_PROFILE_HOUSEKEEPING);
+
+#ifdef IDLE_WAIT_ENABLE
+        // Sleep until something needs the main loop again
+        idle_wait_task();
+#endif  // IDLE_WAIT_ENABLE
     }
 }
@@ -57,6 +57,19 @@ static SPLIT_MUTABLE_COL pin_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
 #    endif  // MATRIX_COL_PINS
 #endif
 
+// Read the pins of a matrix scan by port rather than one at a time, where the platform allows it
+#if !defined(DIRECT_PINS) && defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS) && defined(isSamePort) && !defined(MATRIX_READ_PER_PIN)
+#    if (DIODE_DIRECTION == COL2ROW) && MATRIX_COLS <= 32
+#        define MATRIX_READ_BY_PORT
+#        define MATRIX_INPUTS MATRIX_COLS
+#        define MATRIX_INPUT_PINS col_pins
+#    elif (DIODE_DIRECTION == ROW2COL) && ROWS_PER_HAND <= 32
+#        define MATRIX_READ_BY_PORT
+#        define MATRIX_INPUTS ROWS_PER_HAND
+#        define MATRIX_INPUT_PINS row_pins
+#    endif
+#endif
+
 /* matrix state(1:on, 0:off) */
 extern matrix_row_t raw_matrix[MATRIX_ROWS];  // raw values
 extern matrix_row_t matrix[MATRIX_ROWS];      // debounced values
@@ -94,6 +107,75 @@ static inline uint8_t readMatrixPin(pin_t pin) {
     }
 }
 
+#ifdef MATRIX_READ_BY_PORT
+#    if MATRIX_INPUTS <= 8
+typedef uint8_t matrix_inputs_t;
+#    elif MATRIX_INPUTS <= 16
+typedef uint16_t matrix_inputs_t;
+#    else
+typedef uint32_t matrix_inputs_t;
+#    endif
+
+// Inputs that are next to each other in the matrix, and on the same port in the same order
+typedef struct {
+    uint8_t     port;    // index into read_ports
+    uint8_t     bit;     // of the first input on the port
+    uint8_t     offset;  // first input in the matrix
+    uint8_t     length;
+    port_data_t mask;  // one bit per input
+} matrix_read_run_t;
+
+static pin_t             read_ports[MATRIX_INPUTS];  // a pin on each port with inputs, to read the port by
+static uint8_t           read_port_count;
+static matrix_read_run_t read_runs[MATRIX_INPUTS];
+static uint8_t           read_run_count;
+
+static void matrix_plan_reads(void) {
+    read_port_count = 0;
+    read_run_count  = 0;
+    for (uint8_t i = 0; i < MATRIX_INPUTS; i++) {
+        pin_t pin = MATRIX_INPUT_PINS[i];
+        if (pin == NO_PIN) {
+            continue;
+        }
+
+        uint8_t port = 0;
+        while (port < read_port_count && !isSamePort(read_ports[port], pin)) {
+            port++;
+        }
+        if (port == read_port_count) {
+            read_ports[read_port_count++] = pin;
+        }
+
+        uint8_t bit = getPortBit(pin);
+        if (read_run_count > 0) {
+            matrix_read_run_t *run = &read_runs[read_run_count - 1];
+            if (run->port == port && run->offset + run->length == i && run->bit + run->length == bit) {
+                run->length++;
+                run->mask = (run->mask << 1) | 1;
+                continue;
+            }
+        }
+        read_runs[read_run_count++] = (matrix_read_run_t){.port = port, .bit = bit, .offset = i, .length = 1, .mask = 1};
+    }
+}
+
+// Reads each port once, and returns a bit for each input, set if the input is low
+static matrix_inputs_t matrix_read_inputs(void) {
+    port_data_t low[MATRIX_INPUTS];
+    for (uint8_t port = 0; port < read_port_count; port++) {
+        low[port] = ~readPort(read_ports[port]);
+    }
+
+    matrix_inputs_t inputs = 0;
+    for (uint8_t i = 0; i < read_run_count; i++) {
+        const matrix_read_run_t *run = &read_runs[i];
+        inputs |= (matrix_inputs_t)((low[run->port] >> run->bit) & run->mask) << run->offset;
+    }
+    return inputs;
+}
+#endif  // MATRIX_READ_BY_PORT
+
 // matrix code
 
 #ifdef DIRECT_PINS
@@ -169,6 +251,9 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
+#            ifdef MATRIX_READ_BY_PORT
+    current_row_value = (matrix_row_t)matrix_read_inputs();
+#            else
     // For each col...
     matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
     for (uint8_t col_index = 0; col_index < MATRIX_COLS; col_index++, row_shifter <<= 1) {
@@ -177,6 +262,7 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
         // Populate the matrix row with the state of the col pin
         current_row_value |= pin_state ? 0 : row_shifter;
     }
+#            endif
 
     // Unselect row
     unselect_row(current_row);
@@ -228,10 +314,18 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
     }
     matrix_output_select_delay();
 
+#            ifdef MATRIX_READ_BY_PORT
+    matrix_inputs_t rows_low = matrix_read_inputs();
+#            endif
+
     // For each row...
     for (uint8_t row_index = 0; row_index < ROWS_PER_HAND; row_index++) {
         // Check row pin state
+#            ifdef MATRIX_READ_BY_PORT
+        if (rows_low & ((matrix_inputs_t)1 << row_index)) {
+#            else
         if (readMatrixPin(row_pins[row_index]) == 0) {
+#            endif
             // Pin LO, set col bit
             current_matrix[row_index] |= row_shifter;
             key_pressed = true;
@@ -254,6 +348,67 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
 #    error DIODE_DIRECTION is not defined!
 #endif
 
+static void matrix_read(matrix_row_t curr_matrix[]) {
+#if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
+    // Set row, read cols
+    for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
+        matrix_read_cols_on_row(curr_matrix, current_row);
+    }
+#elif (DIODE_DIRECTION == ROW2COL)
+    // Set col, read rows
+    matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
+    for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++, row_shifter <<= 1) {
+        matrix_read_rows_on_col(curr_matrix, current_col, row_shifter);
+    }
+#endif
+}
+
+#ifdef MATRIX_BACKGROUND_SCAN_ENABLE
+#    ifndef MATRIX_BACKGROUND_SCAN_QUEUE_SIZE
+#        define MATRIX_BACKGROUND_SCAN_QUEUE_SIZE 16
+#    endif
+#    if (MATRIX_BACKGROUND_SCAN_QUEUE_SIZE & (MATRIX_BACKGROUND_SCAN_QUEUE_SIZE - 1)) || MATRIX_BACKGROUND_SCAN_QUEUE_SIZE > 128
+#        error MATRIX_BACKGROUND_SCAN_QUEUE_SIZE must be a power of two, up to 128
+#    endif
+
+typedef struct {
+    uint16_t     time;
+    matrix_row_t rows[ROWS_PER_HAND];
+} matrix_snapshot_t;
+
+// Single producer (the background scan) and single consumer (matrix_scan), so the indices need no lock
+static matrix_snapshot_t scan_queue[MATRIX_BACKGROUND_SCAN_QUEUE_SIZE];
+static uint8_t           scan_queue_head = 0;  // only written by the background scan
+static uint8_t           scan_queue_tail = 0;  // only written by matrix_scan
+static matrix_row_t      scan_last[ROWS_PER_HAND];
+static uint16_t          scan_row_time[ROWS_PER_HAND];  // when the background scan saw each row change
+
+void matrix_background_scan(void) {
+    matrix_row_t curr_matrix[ROWS_PER_HAND] = {0};
+    matrix_read(curr_matrix);
+    if (memcmp(scan_last, curr_matrix, sizeof(curr_matrix)) == 0) return;
+
+    uint8_t head = __atomic_load_n(&scan_queue_head, __ATOMIC_RELAXED);
+    uint8_t next = (head + 1) & (MATRIX_BACKGROUND_SCAN_QUEUE_SIZE - 1);
+    // when full, leave the change to be picked up again once matrix_scan has caught up
+    if (next == __atomic_load_n(&scan_queue_tail, __ATOMIC_ACQUIRE)) return;
+
+    scan_queue[head].time = timer_read();
+    memcpy(scan_queue[head].rows, curr_matrix, sizeof(curr_matrix));
+    memcpy(scan_last, curr_matrix, sizeof(curr_matrix));
+    __atomic_store_n(&scan_queue_head, next, __ATOMIC_RELEASE);
+}
+
+uint16_t matrix_event_time(uint8_t row, uint16_t not_before, uint16_t not_after) {
+#    ifdef SPLIT_KEYBOARD
+    row -= thisHand;
+#    endif
+    uint16_t age   = TIMER_DIFF_16(not_after, scan_row_time[row]);
+    uint16_t limit = TIMER_DIFF_16(not_after, not_before);
+    return (uint16_t)(not_after - (age < limit ? age : limit)) | 1;
+}
+#endif
+
 void matrix_init(void) {
 #ifdef SPLIT_KEYBOARD
     split_pre_init();
@@ -286,6 +441,10 @@ void matrix_init(void) {
     thatHand = ROWS_PER_HAND - thisHand;
 #endif
 
+#ifdef MATRIX_READ_BY_PORT
+    matrix_plan_reads();
+#endif
+
     // initialize key pins
     matrix_init_pins();
 
@@ -295,6 +454,10 @@ void matrix_init(void) {
 
     debounce_init(ROWS_PER_HAND);
 
+#ifdef MATRIX_BACKGROUND_SCAN_ENABLE
+    matrix_background_start();
+#endif
+
     matrix_init_quantum();
 
 #ifdef SPLIT_KEYBOARD
@@ -342,17 +505,34 @@ bool matrix_post_scan(void) {
 uint8_t matrix_scan(void) {
     matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
 
-#if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
-    // Set row, read cols
-    for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
-        matrix_read_cols_on_row(curr_matrix, current_row);
-    }
-#elif (DIODE_DIRECTION == ROW2COL)
-    // Set col, read rows
-    matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
-    for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++, row_shifter <<= 1) {
-        matrix_read_rows_on_col(curr_matrix, current_col, row_shifter);
+#ifdef MATRIX_BACKGROUND_SCAN_ENABLE
+    // Take the states the background scan queued up, oldest first, for as long as each changes rows the ones before it
+    // didn't. A row that changes again is left for the next scan, so short taps are never merged away and every row
+    // keeps the time of its one change.
+    memcpy(curr_matrix, raw_matrix, sizeof(curr_matrix));
+    bool    row_taken[ROWS_PER_HAND] = {false};
+    uint8_t tail                     = __atomic_load_n(&scan_queue_tail, __ATOMIC_RELAXED);
+    uint8_t head                     = __atomic_load_n(&scan_queue_head, __ATOMIC_ACQUIRE);
+    for (; tail != head; tail = (tail + 1) & (MATRIX_BACKGROUND_SCAN_QUEUE_SIZE - 1)) {
+        const matrix_snapshot_t *snapshot = &scan_queue[tail];
+
+        bool retaken = false;
+        for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+            retaken |= row_taken[row] && snapshot->rows[row] != curr_matrix[row];
+        }
+        if (retaken) break;
+
+        for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+            if (snapshot->rows[row] != curr_matrix[row]) {
+                curr_matrix[row]   = snapshot->rows[row];
+                scan_row_time[row] = snapshot->time;
+                row_taken[row]     = true;
+            }
+        }
     }
+    __atomic_store_n(&scan_queue_tail, tail, __ATOMIC_RELEASE);
+#else
+    matrix_read(curr_matrix);
 #endif
 
     bool changed = memcmp(raw_matrix, curr_matrix, sizeof(curr_matrix)) != 0;
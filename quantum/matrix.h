@@ -74,6 +74,15 @@ void matrix_scan_kb(void);
 void matrix_init_user(void);
 void matrix_scan_user(void);
 
+#ifdef MATRIX_BACKGROUND_SCAN_ENABLE
+/* strobe the matrix and queue up any change, called by the platform at a fixed rate */
+void matrix_background_scan(void);
+/* start calling matrix_background_scan, implemented by the platform */
+void matrix_background_start(void);
+/* time the background scan saw the row change in the states taken by matrix_scan, kept within the given bounds */
+uint16_t matrix_event_time(uint8_t row, uint16_t not_before, uint16_t not_after);
+#endif
+
 #ifdef SPLIT_KEYBOARD
 void matrix_slave_scan_kb(void);
 void matrix_slave_scan_user(void);
@@ -0,0 +1,41 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// The board matrix.c is built for by the tests. Pins are numbered eight to a port (see gpio.h), so that whichever
+// pins are the inputs, they cross from one port to the next, skip a NO_PIN, run backwards, and come back to a
+// port they have been on before.
+#ifdef SPLIT_KEYBOARD
+#    define MATRIX_ROWS 10
+#else
+#    define MATRIX_ROWS 5
+#endif
+#define MATRIX_COLS 10
+
+#ifndef DIODE_DIRECTION
+#    define DIODE_DIRECTION COL2ROW
+#endif
+#define MATRIX_ROW_PINS \
+    { 15, 16, 24, 17, NO_PIN }
+#define MATRIX_COL_PINS \
+    { 6, 7, 8, 9, NO_PIN, 12, 11, 10, 20, 21 }
+
+// The right half is wired the other way around
+#define MATRIX_ROW_PINS_RIGHT \
+    { 24, 17, 16, 15, NO_PIN }
+#define MATRIX_COL_PINS_RIGHT \
+    { 21, 20, 10, 11, 12, NO_PIN, 9, 8, 7, 6 }
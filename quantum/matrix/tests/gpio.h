@@ -0,0 +1,47 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Eight pins to a port, so pin 10 is bit 2 of port 1
+typedef uint8_t pin_t;
+typedef uint8_t port_data_t;
+
+#include "pin_defs.h"
+
+#define setPinInput(pin) mock_set_pin_input(pin)
+#define setPinInputHigh(pin) mock_set_pin_input(pin)
+#define setPinInputLow(pin) mock_set_pin_input(pin)
+#define setPinOutput(pin) mock_set_pin_output(pin)
+
+#define writePinHigh(pin) mock_write_pin(pin, true)
+#define writePinLow(pin) mock_write_pin(pin, false)
+#define writePin(pin, level) mock_write_pin(pin, level)
+
+#define readPin(pin) mock_read_pin(pin)
+#define readPort(pin) mock_read_port(pin)
+
+#define isSamePort(pin_a, pin_b) (((pin_a) >> 3) == ((pin_b) >> 3))
+#define getPortBit(pin) ((pin)&7)
+
+void        mock_set_pin_input(pin_t pin);
+void        mock_set_pin_output(pin_t pin);
+void        mock_write_pin(pin_t pin, bool level);
+bool        mock_read_pin(pin_t pin);
+port_data_t mock_read_port(pin_t pin);
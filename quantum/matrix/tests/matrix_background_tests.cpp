@@ -0,0 +1,160 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix_mock.h"
+#include "timer.h"
+
+extern matrix_row_t matrix[MATRIX_ROWS];
+
+void set_time(uint32_t t);
+}
+
+class MatrixBackground : public testing::Test {
+   protected:
+    uint8_t hand = 0;  // first row of this half in matrix[]
+
+    void SetUp() override {
+        mock_reset();
+#ifdef SPLIT_KEYBOARD
+        // The right half, so rows have to be found at an offset
+        mock_set_left_hand(false);
+        hand = ROWS_PER_HAND;
+#endif
+        matrix_init();
+
+        // Whatever an earlier test left pressed is released and taken
+        set_time(1000);
+        matrix_background_scan();
+        matrix_scan();
+    }
+
+    void scan_at(uint32_t time) {
+        set_time(time);
+        matrix_background_scan();
+    }
+
+    matrix_row_t row(uint8_t r) { return matrix[hand + r]; }
+
+    uint16_t event_time(uint8_t r, uint16_t not_before, uint16_t not_after) { return matrix_event_time(hand + r, not_before, not_after); }
+};
+
+TEST_F(MatrixBackground, TakesChangesToDifferentRowsTogether) {
+    mock_press(0, 0);
+    scan_at(1101);
+    mock_press(2, 3);
+    scan_at(1103);
+    mock_press(3, 9);
+    scan_at(1107);
+
+    set_time(1110);
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(row(0), 1 << 0);
+    EXPECT_EQ(row(2), 1 << 3);
+    EXPECT_EQ(row(3), 1 << 9);
+    EXPECT_EQ(event_time(0, 1000, 1110), 1101);
+    EXPECT_EQ(event_time(2, 1000, 1110), 1103);
+    EXPECT_EQ(event_time(3, 1000, 1110), 1107);
+
+    EXPECT_FALSE(matrix_scan());
+}
+
+TEST_F(MatrixBackground, ShortTapIsNotMergedAway) {
+    mock_press(1, 2);
+    scan_at(1101);
+    mock_release(1, 2);
+    scan_at(1103);
+
+    set_time(1110);
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(row(1), 1 << 2);
+    EXPECT_EQ(event_time(1, 1000, 1110), 1101);
+
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(row(1), 0);
+    EXPECT_EQ(event_time(1, 1101, 1110), 1103);
+
+    EXPECT_FALSE(matrix_scan());
+}
+
+TEST_F(MatrixBackground, RowChangingAgainHoldsBackLaterChanges) {
+    mock_press(0, 0);
+    scan_at(1101);
+    mock_press(0, 1);
+    scan_at(1103);
+    mock_press(3, 0);
+    scan_at(1105);
+
+    // The second change to row 0 ends the scan, and the change to row 3 after it waits as well so the order is kept
+    set_time(1110);
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(row(0), 1 << 0);
+    EXPECT_EQ(row(3), 0);
+    EXPECT_EQ(event_time(0, 1000, 1110), 1101);
+
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(row(0), (1 << 0) | (1 << 1));
+    EXPECT_EQ(row(3), 1 << 0);
+    EXPECT_EQ(event_time(0, 1101, 1110), 1103);
+    EXPECT_EQ(event_time(3, 1101, 1110), 1105);
+}
+
+TEST_F(MatrixBackground, EventTimeIsKeptWithinBounds) {
+    mock_press(1, 0);
+    scan_at(1100);
+    set_time(1110);
+    matrix_scan();
+
+    // Never 0, which stands for no time at all
+    EXPECT_EQ(event_time(1, 1000, 1110), 1101);
+    // and never before the events already taken
+    EXPECT_EQ(event_time(1, 1105, 1110), 1105);
+
+    // across the wrap of the timer
+    mock_release(1, 0);
+    scan_at(0xFFFD);
+    set_time(0x10004);
+    matrix_scan();
+    EXPECT_EQ(event_time(1, 0xFFF0, 0x0004), 0xFFFD);
+}
+
+TEST_F(MatrixBackground, FullQueueCatchesUpWithLatestState) {
+    // Far more changes than the queue holds, ending released
+    for (uint8_t i = 0; i < 20; i++) {
+        if (i % 2) {
+            mock_release(2, 6);
+        } else {
+            mock_press(2, 6);
+        }
+        scan_at(1101 + i * 2);
+    }
+
+    set_time(1200);
+    uint8_t taken = 0;
+    while (matrix_scan()) {
+        taken++;
+    }
+    EXPECT_EQ(taken, 15);
+    EXPECT_EQ(row(2), 1 << 6);
+
+    // The changes that didn't fit are lost, but not the state the keys are in now
+    scan_at(1201);
+    EXPECT_TRUE(matrix_scan());
+    EXPECT_EQ(row(2), 0);
+    EXPECT_EQ(event_time(2, 1000, 1210), 1201);
+}
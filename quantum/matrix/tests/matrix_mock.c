@@ -0,0 +1,153 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "matrix_mock.h"
+#include "config_common.h"
+#include "debounce.h"
+#include "gpio.h"
+#ifdef SPLIT_KEYBOARD
+#    include "split_common/split_util.h"
+#    include "split_common/transport.h"
+#endif
+
+matrix_row_t raw_matrix[MATRIX_ROWS];
+matrix_row_t matrix[MATRIX_ROWS];
+
+static const pin_t row_pins_left[MATRIX_ROWS] = MATRIX_ROW_PINS;
+static const pin_t col_pins_left[MATRIX_COLS] = MATRIX_COL_PINS;
+#ifdef MATRIX_ROW_PINS_RIGHT
+static const pin_t row_pins_right[MATRIX_ROWS] = MATRIX_ROW_PINS_RIGHT;
+#else
+#    define row_pins_right row_pins_left
+#endif
+#ifdef MATRIX_COL_PINS_RIGHT
+static const pin_t col_pins_right[MATRIX_COLS] = MATRIX_COL_PINS_RIGHT;
+#else
+#    define col_pins_right col_pins_left
+#endif
+
+static bool         pin_is_output[256];
+static bool         pin_level[256];
+static matrix_row_t pressed[ROWS_PER_HAND];
+
+uint16_t mock_pin_reads;
+uint16_t mock_port_reads;
+uint16_t mock_strobes;
+
+#ifdef SPLIT_KEYBOARD
+volatile bool isLeftHand = true;
+
+void mock_set_left_hand(bool left) { isLeftHand = left; }
+#else
+static const bool isLeftHand = true;
+#endif
+
+static pin_t row_pin(uint8_t row) { return isLeftHand ? row_pins_left[row] : row_pins_right[row]; }
+static pin_t col_pin(uint8_t col) { return isLeftHand ? col_pins_left[col] : col_pins_right[col]; }
+
+void mock_reset(void) {
+    memset(pin_is_output, 0, sizeof(pin_is_output));
+    memset(pin_level, 0, sizeof(pin_level));
+    memset(pressed, 0, sizeof(pressed));
+    mock_pin_reads  = 0;
+    mock_port_reads = 0;
+    mock_strobes    = 0;
+#ifdef SPLIT_KEYBOARD
+    isLeftHand = true;
+#endif
+}
+
+void mock_press(uint8_t row, uint8_t col) { pressed[row] |= (matrix_row_t)1 << col; }
+void mock_release(uint8_t row, uint8_t col) { pressed[row] &= ~((matrix_row_t)1 << col); }
+
+void mock_expected(matrix_row_t expected[]) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        expected[row] = 0;
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (row_pin(row) != NO_PIN && col_pin(col) != NO_PIN && (pressed[row] & ((matrix_row_t)1 << col))) {
+                expected[row] |= (matrix_row_t)1 << col;
+            }
+        }
+    }
+}
+
+void mock_set_pin_input(pin_t pin) { pin_is_output[pin] = false; }
+void mock_set_pin_output(pin_t pin) { pin_is_output[pin] = true; }
+void mock_write_pin(pin_t pin, bool level) {
+    pin_level[pin] = level;
+    if (!level) mock_strobes++;
+}
+
+// An input is pulled high, unless a pressed key connects it to an output driven low on the other side of the diode
+static bool pin_state(pin_t pin) {
+    if (pin_is_output[pin]) {
+        return pin_level[pin];
+    }
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (!(pressed[row] & ((matrix_row_t)1 << col)) || row_pin(row) == NO_PIN || col_pin(col) == NO_PIN) {
+                continue;
+            }
+#if (DIODE_DIRECTION == COL2ROW)
+            pin_t input = col_pin(col), output = row_pin(row);
+#else
+            pin_t input = row_pin(row), output = col_pin(col);
+#endif
+            if (pin == input && pin_is_output[output] && !pin_level[output]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool mock_read_pin(pin_t pin) {
+    mock_pin_reads++;
+    return pin_state(pin);
+}
+
+port_data_t mock_read_port(pin_t pin) {
+    mock_port_reads++;
+    port_data_t data = 0;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        data |= (port_data_t)pin_state((pin & ~7) | bit) << bit;
+    }
+    return data;
+}
+
+// What matrix.c needs from the rest of the firmware
+void matrix_init_quantum(void) {}
+void matrix_scan_quantum(void) {}
+void matrix_output_select_delay(void) {}
+void matrix_output_unselect_delay(uint8_t line, bool key_pressed) {}
+
+void debounce_init(uint8_t num_rows) {}
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    if (changed) memcpy(cooked, raw, sizeof(matrix_row_t) * num_rows);
+}
+
+#ifdef MATRIX_BACKGROUND_SCAN_ENABLE
+void matrix_background_start(void) {}
+#endif
+
+#ifdef SPLIT_KEYBOARD
+void split_pre_init(void) {}
+void split_post_init(void) {}
+bool is_keyboard_master(void) { return true; }
+bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) { return true; }
+void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {}
+#endif
@@ -0,0 +1,42 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "matrix.h"
+
+#ifdef SPLIT_KEYBOARD
+#    define ROWS_PER_HAND (MATRIX_ROWS / 2)
+#else
+#    define ROWS_PER_HAND (MATRIX_ROWS)
+#endif
+
+// Keys are pressed by their position on this half, and connect their row and column pins until released
+void mock_reset(void);
+void mock_press(uint8_t row, uint8_t col);
+void mock_release(uint8_t row, uint8_t col);
+
+// What the pins of the pressed keys should read as, with the keys on NO_PIN rows or columns left out
+void mock_expected(matrix_row_t expected[]);
+
+// How often the matrix was read, and how many times an output was driven low to read it
+extern uint16_t mock_pin_reads;
+extern uint16_t mock_port_reads;
+extern uint16_t mock_strobes;
+
+#ifdef SPLIT_KEYBOARD
+void mock_set_left_hand(bool left);
+#endif
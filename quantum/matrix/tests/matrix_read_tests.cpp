@@ -0,0 +1,102 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "matrix_mock.h"
+
+extern matrix_row_t matrix[MATRIX_ROWS];
+}
+
+class MatrixRead : public testing::Test {
+   protected:
+    uint8_t hand = 0;  // first row of this half in matrix[]
+
+    void SetUp() override {
+        mock_reset();
+#ifdef SPLIT_KEYBOARD
+        // The right half, which has pins of its own
+        mock_set_left_hand(false);
+        hand = ROWS_PER_HAND;
+#endif
+        matrix_init();
+    }
+
+    // Scans, and checks the matrix against what the pins of the pressed keys read as one at a time
+    void expect_read() {
+        matrix_row_t expected[ROWS_PER_HAND];
+        mock_expected(expected);
+        matrix_scan();
+        for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+            EXPECT_EQ(matrix[hand + row], expected[row]) << "row " << (int)row;
+        }
+    }
+};
+
+TEST_F(MatrixRead, EachKeyAlone) {
+    uint8_t seen = 0;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            mock_press(row, col);
+            expect_read();
+            seen += matrix[hand + row] != 0;
+            mock_release(row, col);
+        }
+    }
+    expect_read();
+
+    // all but the keys on the NO_PIN row and column
+    EXPECT_EQ(seen, (ROWS_PER_HAND - 1) * (MATRIX_COLS - 1));
+}
+
+TEST_F(MatrixRead, EveryKeyTogether) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            mock_press(row, col);
+        }
+    }
+    expect_read();
+}
+
+TEST_F(MatrixRead, RandomKeys) {
+    uint32_t seed = 1;
+    for (uint16_t i = 0; i < 500; i++) {
+        for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                seed = seed * 1103515245 + 12345;
+                if ((seed >> 16) & 3) {
+                    mock_release(row, col);
+                } else {
+                    mock_press(row, col);
+                }
+            }
+        }
+        expect_read();
+    }
+}
+
+#ifndef MATRIX_READ_PER_PIN
+TEST_F(MatrixRead, ReadsEachPortOncePerStrobe) {
+    mock_press(0, 0);
+    matrix_scan();
+
+    // The inputs of both halves are spread over three ports
+    EXPECT_GT(mock_strobes, 0);
+    EXPECT_EQ(mock_port_reads, mock_strobes * 3);
+    EXPECT_EQ(mock_pin_reads, 0);
+}
+#endif
@@ -0,0 +1,50 @@
+MATRIX_MOCK_INC := \
+	$(QUANTUM_PATH)/matrix/tests
+MATRIX_MOCK_SRC := \
+	$(QUANTUM_PATH)/matrix/tests/matrix_mock.c \
+	$(QUANTUM_PATH)/matrix.c \
+	$(PLATFORM_PATH)/test/timer.c
+
+matrix_background_INC := $(MATRIX_MOCK_INC)
+matrix_background_CONFIG := $(QUANTUM_PATH)/matrix/tests/config.h
+matrix_background_DEFS := -DNO_DEBUG -DMATRIX_BACKGROUND_SCAN_ENABLE
+matrix_background_SRC := \
+	$(MATRIX_MOCK_SRC) \
+	$(QUANTUM_PATH)/matrix/tests/matrix_background_tests.cpp
+
+matrix_background_split_INC := $(MATRIX_MOCK_INC)
+matrix_background_split_CONFIG := $(matrix_background_CONFIG)
+matrix_background_split_DEFS := $(matrix_background_DEFS) -DSPLIT_KEYBOARD
+matrix_background_split_SRC := $(matrix_background_SRC)
+
+matrix_read_col2row_INC := $(MATRIX_MOCK_INC)
+matrix_read_col2row_CONFIG := $(QUANTUM_PATH)/matrix/tests/config.h
+matrix_read_col2row_DEFS := -DNO_DEBUG -DDIODE_DIRECTION=COL2ROW
+matrix_read_col2row_SRC := \
+	$(MATRIX_MOCK_SRC) \
+	$(QUANTUM_PATH)/matrix/tests/matrix_read_tests.cpp
+
+matrix_read_col2row_per_pin_INC := $(MATRIX_MOCK_INC)
+matrix_read_col2row_per_pin_CONFIG := $(matrix_read_col2row_CONFIG)
+matrix_read_col2row_per_pin_DEFS := $(matrix_read_col2row_DEFS) -DMATRIX_READ_PER_PIN
+matrix_read_col2row_per_pin_SRC := $(matrix_read_col2row_SRC)
+
+matrix_read_col2row_split_INC := $(MATRIX_MOCK_INC)
+matrix_read_col2row_split_CONFIG := $(matrix_read_col2row_CONFIG)
+matrix_read_col2row_split_DEFS := $(matrix_read_col2row_DEFS) -DSPLIT_KEYBOARD
+matrix_read_col2row_split_SRC := $(matrix_read_col2row_SRC)
+
+matrix_read_row2col_INC := $(MATRIX_MOCK_INC)
+matrix_read_row2col_CONFIG := $(matrix_read_col2row_CONFIG)
+matrix_read_row2col_DEFS := -DNO_DEBUG -DDIODE_DIRECTION=ROW2COL
+matrix_read_row2col_SRC := $(matrix_read_col2row_SRC)
+
+matrix_read_row2col_per_pin_INC := $(MATRIX_MOCK_INC)
+matrix_read_row2col_per_pin_CONFIG := $(matrix_read_col2row_CONFIG)
+matrix_read_row2col_per_pin_DEFS := $(matrix_read_row2col_DEFS) -DMATRIX_READ_PER_PIN
+matrix_read_row2col_per_pin_SRC := $(matrix_read_col2row_SRC)
+
+matrix_read_row2col_split_INC := $(MATRIX_MOCK_INC)
+matrix_read_row2col_split_CONFIG := $(matrix_read_col2row_CONFIG)
+matrix_read_row2col_split_DEFS := $(matrix_read_row2col_DEFS) -DSPLIT_KEYBOARD
+matrix_read_row2col_split_SRC := $(matrix_read_col2row_SRC)
@@ -0,0 +1,9 @@
+TEST_LIST += \
+	matrix_background \
+	matrix_background_split \
+	matrix_read_col2row \
+	matrix_read_col2row_per_pin \
+	matrix_read_col2row_split \
+	matrix_read_row2col \
+	matrix_read_row2col_per_pin \
+	matrix_read_row2col_split
@@ -67,6 +67,81 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
 
 #define INCREMENT_MOD(i) i = (i + 1) % COMBO_BUFFER_LENGTH
 
+#ifdef COMBO_KEY_INDEX_SIZE
+#    ifndef COMBO_TOUCHED_LENGTH
+#        define COMBO_TOUCHED_LENGTH 32
+#    endif
+
+/* Every key of every combo as (keycode << 16 | combo index), sorted, so that the combos a keycode is part of can be
+ * found with a binary search -- in combo order, as they would be by looping over them all. */
+static uint32_t combo_key_index[COMBO_KEY_INDEX_SIZE];
+static uint16_t combo_key_index_count = 0;
+static bool     combo_key_index_built = false;
+static bool     combo_key_index_valid = false;
+
+/* Combos which may have state to clear, so that clearing doesn't have to look at every combo. If more are touched
+ * than fit, all of them are cleared instead. */
+static uint16_t combo_touched[COMBO_TOUCHED_LENGTH];
+static uint8_t  combo_touched_count    = 0;
+static bool     combo_touched_overflow = false;
+
+static void build_combo_key_index(void) {
+    combo_key_index_built = true;
+    combo_key_index_count = 0;
+
+    for (uint16_t combo_index = 0; combo_index < COMBO_LEN; ++combo_index) {
+        const uint16_t *keys = key_combos[combo_index].keys;
+        uint16_t        key;
+        for (uint8_t i = 0; (key = pgm_read_word(&keys[i])) != COMBO_END; ++i) {
+            if (combo_key_index_count == COMBO_KEY_INDEX_SIZE) {
+                dprintf("COMBO_KEY_INDEX_SIZE is too small for the combos, not using it\n");
+                combo_key_index_valid = false;
+                return;
+            }
+            combo_key_index[combo_key_index_count++] = ((uint32_t)key << 16) | combo_index;
+        }
+    }
+
+    // Shell sort -- this only runs once, and the entries are unique so it doesn't need to be stable
+    static const uint16_t gaps[] = {701, 301, 132, 57, 23, 10, 4, 1};
+    for (uint8_t g = 0; g < sizeof(gaps) / sizeof(gaps[0]); ++g) {
+        uint16_t gap = gaps[g];
+        for (uint16_t i = gap; i < combo_key_index_count; ++i) {
+            uint32_t entry = combo_key_index[i];
+            uint16_t j     = i;
+            for (; j >= gap && combo_key_index[j - gap] > entry; j -= gap) {
+                combo_key_index[j] = combo_key_index[j - gap];
+            }
+            combo_key_index[j] = entry;
+        }
+    }
+    combo_key_index_valid = true;
+}
+
+/* Returns the position of the first entry for keycode, or the end of the index if there are none. */
+static uint16_t find_combo_key_index(uint16_t keycode) {
+    uint16_t low  = 0;
+    uint16_t high = combo_key_index_count;
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        if ((uint16_t)(combo_key_index[mid] >> 16) < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static inline void touch_combo(uint16_t combo_index) {
+    if (combo_touched_count < COMBO_TOUCHED_LENGTH) {
+        combo_touched[combo_touched_count++] = combo_index;
+    } else {
+        combo_touched_overflow = true;
+    }
+}
+#endif
+
 #define COMBO_KEY_POS ((keypos_t){.col = 254, .row = 254})
 
 #ifndef EXTRA_SHORT_COMBOS
@@ -174,11 +249,34 @@ static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
 void clear_combos(void) {
     uint16_t index = 0;
     longest_term   = 0;
+#ifdef COMBO_KEY_INDEX_SIZE
+    if (combo_key_index_valid && !combo_touched_overflow) {
+        // Active combos keep their state, so they stay on the list to be cleared once they are released
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < combo_touched_count; ++i) {
+            combo_t *combo = &key_combos[combo_touched[i]];
+            if (COMBO_ACTIVE(combo)) {
+                combo_touched[kept++] = combo_touched[i];
+            } else {
+                RESET_COMBO_STATE(combo);
+            }
+        }
+        combo_touched_count = kept;
+        return;
+    }
+    combo_touched_count    = 0;
+    combo_touched_overflow = false;
+#endif
     for (index = 0; index < COMBO_LEN; ++index) {
         combo_t *combo = &key_combos[index];
         if (!COMBO_ACTIVE(combo)) {
             RESET_COMBO_STATE(combo);
         }
+#ifdef COMBO_KEY_INDEX_SIZE
+        else {
+            touch_combo(index);
+        }
+#endif
     }
 }
 
@@ -365,6 +463,11 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     if (record->event.pressed && key_is_part_of_combo) {
         uint16_t time = _get_combo_term(combo_index, combo);
         if (!COMBO_ACTIVE(combo)) {
+#ifdef COMBO_KEY_INDEX_SIZE
+            if (combo_key_index_valid && NO_COMBO_KEYS_ARE_DOWN && !COMBO_DISABLED(combo)) {
+                touch_combo(combo_index);
+            }
+#endif
             KEY_STATE_DOWN(combo->state, key_index);
             if (longest_term < time) {
                 longest_term = time;
@@ -464,8 +567,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
 }
 
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    bool is_combo_key          = false;
-    bool no_combo_keys_pressed = true;
+    bool is_combo_key = false;
 
     if (keycode == CMB_ON && record->event.pressed) {
         combo_enable();
@@ -487,10 +589,23 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     keycode = keymap_key_to_keycode(COMBO_ONLY_FROM_LAYER, record->event.key);
 #endif
 
-    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
-        combo_t *combo = &key_combos[idx];
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEY_INDEX_SIZE
+    if (!combo_key_index_built) {
+        build_combo_key_index();
+    }
+    if (combo_key_index_valid) {
+        // Only the combos the key is part of can be affected by it
+        for (uint16_t i = find_combo_key_index(keycode); i < combo_key_index_count && (uint16_t)(combo_key_index[i] >> 16) == keycode; ++i) {
+            uint16_t idx = (uint16_t)combo_key_index[i];
+            is_combo_key |= process_single_combo(&key_combos[idx], keycode, record, idx);
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+            combo_t *combo = &key_combos[idx];
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
@@ -37,6 +37,10 @@
 #    include "haptic.h"
 #endif
 
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -116,6 +120,12 @@ __attribute__((weak)) void post_process_record_user(uint16_t keycode, keyrecord_
 
 void reset_keyboard(void) {
     clear_keyboard();
+#if defined(DYNAMIC_KEYMAP_ENABLE) && defined(DYNAMIC_KEYMAP_RAM_MIRROR)
+    dynamic_keymap_flush();
+#endif
+#ifdef EEPROM_DRIVER
+    eeprom_driver_flush();
+#endif
 #if defined(MIDI_ENABLE) && defined(MIDI_BASIC)
     process_midi_all_notes_off();
 #endif
@@ -190,6 +200,10 @@ void post_process_record_quantum(keyrecord_t *record) {
     post_process_record_kb(keycode, record);
 }
 
+/* Handlers that only act on keycodes within a range are only called for those, so that every other keycode skips
+ * straight past them. The range can be wider than the keycodes the handler acts on, as long as it covers all of them. */
+#define PROCESS_KEYCODE_RANGE(first, last, handler) (keycode < (first) || keycode > (last) || handler(keycode, record))
+
 /* Core keycode function, hands off handling to other functions,
     then processes internal quantum keycodes, and then processes
     ACTIONs.                                                      */
@@ -236,23 +250,23 @@ bool process_record_quantum(keyrecord_t *record) {
             process_haptic(keycode, record) &&
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(FN_MO13, MACRO15, process_record_via) &&
 #endif
             process_record_kb(keycode, record) &&
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(SQ_ON, SEQUENCER_TRACK_MAX, process_sequencer) &&
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(MIDI_TONE_MIN, MI_BENDU, process_midi) &&
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(AU_ON, MUV_DE, process_audio) &&
 #endif
 #if defined(BACKLIGHT_ENABLE) || defined(LED_MATRIX_ENABLE)
-            process_backlight(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(BL_ON, BL_BRTG, process_backlight) &&
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(QK_STENO, QK_STENO_MAX, process_steno) &&
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
             process_music(keycode, record) &&
@@ -276,7 +290,7 @@ bool process_record_quantum(keyrecord_t *record) {
             process_auto_shift(keycode, record) &&
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(DT_PRNT, DT_DOWN, process_dynamic_tapping_term) &&
 #endif
 #ifdef TERMINAL_ENABLE
             process_terminal(keycode, record) &&
@@ -285,19 +299,19 @@ bool process_record_quantum(keyrecord_t *record) {
             process_space_cadet(keycode, record) &&
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(MAGIC_SWAP_CONTROL_CAPSLOCK, MAGIC_TOGGLE_GUI, process_magic) &&
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(GRAVE_ESC, GRAVE_ESC, process_grave_esc) &&
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(RGB_TOG, RGB_MODE_TWINKLE, process_rgb) &&
 #endif
 #ifdef JOYSTICK_ENABLE
             process_joystick(keycode, record) &&
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+            PROCESS_KEYCODE_RANGE(PROGRAMMABLE_BUTTON_MIN, PROGRAMMABLE_BUTTON_MAX, process_programmable_button) &&
 #endif
             true)) {
         return false;
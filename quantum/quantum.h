@@ -51,6 +51,7 @@
 #include "print.h"
 #include "send_string.h"
 #include "suspend.h"
+#include "task_profile.h"
 #include <stddef.h>
 #include <stdlib.h>
 
@@ -58,6 +59,10 @@
 #    include "deferred_exec.h"
 #endif
 
+#ifdef IDLE_WAIT_ENABLE
+#    include "idle_wait.h"
+#endif
+
 extern layer_state_t default_layer_state;
 
 #ifndef NO_ACTION_LAYER
@@ -0,0 +1,103 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifdef ENABLE_RGB_MATRIX_PLAYBACK
+RGB_MATRIX_EFFECT(PLAYBACK)
+#    ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+
+/* Each frame of the animation data is a series of runs, each starting with an op byte:
+ *   0x00-0x7F: the next (op + 1) LEDs keep their colour from the previous frame
+ *   0x80-0xBF: the next (op - 0x7F) LEDs are set to the R, G, B bytes that follow
+ *   0xC0-0xFF: the next (op - 0xBF) LEDs are each set to their own R, G, B bytes, which follow
+ * until led_count LEDs are covered. The first frame doesn't keep any LEDs, so playback can start over from there.
+ */
+#        define PLAYBACK_OP_FILL 0x80
+#        define PLAYBACK_OP_LITERAL 0xC0
+
+static const rgb_matrix_animation_t *playback_animation = NULL;
+static uint8_t                       playback_leds[DRIVER_LED_TOTAL][3];
+static uint16_t                      playback_frame;
+static uint32_t                      playback_offset;
+static uint32_t                      playback_start;
+
+void rgb_matrix_playback_set(const rgb_matrix_animation_t *animation) {
+    playback_animation = animation;
+    playback_offset    = 0;
+    playback_frame     = UINT16_MAX;
+    playback_start     = g_rgb_timer;
+}
+
+static void playback_set_led(uint8_t led, const uint8_t *rgb) {
+    if (led < DRIVER_LED_TOTAL) {
+        playback_leds[led][0] = pgm_read_byte(rgb);
+        playback_leds[led][1] = pgm_read_byte(rgb + 1);
+        playback_leds[led][2] = pgm_read_byte(rgb + 2);
+    }
+}
+
+static void playback_decode_frame(void) {
+    const uint8_t *data = playback_animation->data + playback_offset;
+    uint8_t        led  = 0;
+    while (led < playback_animation->led_count) {
+        uint8_t op = pgm_read_byte(data++);
+        if (op < PLAYBACK_OP_FILL) {
+            led += op + 1;
+        } else if (op < PLAYBACK_OP_LITERAL) {
+            for (uint8_t count = op - PLAYBACK_OP_FILL + 1; count > 0; count--) {
+                playback_set_led(led++, data);
+            }
+            data += 3;
+        } else {
+            for (uint8_t count = op - PLAYBACK_OP_LITERAL + 1; count > 0; count--) {
+                playback_set_led(led++, data);
+                data += 3;
+            }
+        }
+    }
+    playback_offset = data - playback_animation->data;
+    playback_frame++;
+}
+
+// Decodes frames until the one due at the current time, starting over from the first frame when the animation loops
+static void playback_seek(void) {
+    uint16_t frame_ms = playback_animation->frame_ms ? playback_animation->frame_ms : 1;
+    uint16_t target   = ((g_rgb_timer - playback_start) / frame_ms) % playback_animation->frame_count;
+    if (playback_frame == UINT16_MAX || target < playback_frame) {
+        playback_offset = 0;
+        playback_frame  = UINT16_MAX;
+    }
+    while (playback_frame == UINT16_MAX || playback_frame < target) {
+        playback_decode_frame();
+    }
+}
+
+bool PLAYBACK(effect_params_t* params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    if (params->init) {
+        memset(playback_leds, 0, sizeof(playback_leds));
+        playback_frame = UINT16_MAX;
+        playback_start = g_rgb_timer;
+    }
+    if (params->iter == 0 && playback_animation && playback_animation->frame_count > 0) {
+        playback_seek();
+    }
+
+    // The decoded frame is kept as it is for the next one, so scale a copy of it
+    uint8_t scaled[RGB_MATRIX_BATCH_SIZE][3];
+    for (uint8_t start = led_min, count; start < led_max; start += count) {
+        count = led_max - start;
+        if (count > RGB_MATRIX_BATCH_SIZE) count = RGB_MATRIX_BATCH_SIZE;
+        memcpy(scaled, playback_leds[start], count * 3);
+        scale8_buffer(&scaled[0][0], count * 3, rgb_matrix_config.hsv.v);
+        for (uint8_t j = 0; j < count; j++) {
+            if (HAS_ANY_FLAGS(g_led_config.flags[start + j], params->flags)) {
+                rgb_matrix_set_color(start + j, scaled[j][0], scaled[j][1], scaled[j][2]);
+            }
+        }
+    }
+    return rgb_matrix_check_finished_leds(led_max);
+}
+
+#    endif  // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#endif      // ENABLE_RGB_MATRIX_PLAYBACK
@@ -0,0 +1,30 @@
+#pragma once
+
+#ifndef RGB_MATRIX_BATCH_SIZE
+#    define RGB_MATRIX_BATCH_SIZE 16
+#endif
+
+// The runners collect the colors of up to RGB_MATRIX_BATCH_SIZE LEDs here,
+// and convert them to RGB together rather than one LED at a time
+typedef struct {
+    uint8_t count;
+    uint8_t index[RGB_MATRIX_BATCH_SIZE];
+    HSV     hsv[RGB_MATRIX_BATCH_SIZE];
+} rgb_matrix_batch_t;
+
+static void rgb_matrix_batch_flush(rgb_matrix_batch_t* batch) {
+    RGB rgb[RGB_MATRIX_BATCH_SIZE];
+    rgb_matrix_hsv_to_rgb_buffer(batch->hsv, rgb, batch->count);
+    for (uint8_t j = 0; j < batch->count; j++) {
+        rgb_matrix_set_color(batch->index[j], rgb[j].r, rgb[j].g, rgb[j].b);
+    }
+    batch->count = 0;
+}
+
+static inline void rgb_matrix_batch_add(rgb_matrix_batch_t* batch, uint8_t i, HSV hsv) {
+    batch->index[batch->count] = i;
+    batch->hsv[batch->count]   = hsv;
+    if (++batch->count == RGB_MATRIX_BATCH_SIZE) {
+        rgb_matrix_batch_flush(batch);
+    }
+}
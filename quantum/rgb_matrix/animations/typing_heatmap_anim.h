@@ -36,8 +36,13 @@ static bool decrease_heatmap_values;
 
 bool TYPING_HEATMAP(effect_params_t* params) {
     // Modified version of RGB_MATRIX_USE_LIMITS to work off of matrix row / col size
+#        ifdef RGB_MATRIX_LED_CHUNK
+    uint8_t led_min = RGB_MATRIX_LED_CHUNK * params->iter;
+    uint8_t led_max = led_min + RGB_MATRIX_LED_CHUNK;
+#        else
     uint8_t led_min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;
     uint8_t led_max = led_min + RGB_MATRIX_LED_PROCESS_LIMIT;
+#        endif
     if (led_max > sizeof(g_rgb_frame_buffer)) led_max = sizeof(g_rgb_frame_buffer);
 
     if (params->init) {
@@ -33,6 +33,9 @@ const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 
 __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv); }
 
+// Used by the effect runners, which convert several LEDs at once. Goes through rgb_matrix_hsv_to_rgb(), so replacing that is enough.
+__attribute__((weak)) void rgb_matrix_hsv_to_rgb_buffer(const HSV *hsv, RGB *rgb, uint8_t count) { hsv_to_rgb_buffer(hsv, rgb, count, rgb_matrix_hsv_to_rgb); }
+
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
@@ -83,6 +86,16 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv
 #    define RGB_MATRIX_SPD_STEP 16
 #endif
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+#    include "task_profile.h"
+#    if RGB_MATRIX_RENDER_BUDGET_US < 1
+#        error "RGB_MATRIX_RENDER_BUDGET_US must be at least 1"
+#    endif
+#    ifndef RGB_MATRIX_RENDER_STATS_INTERVAL
+#        define RGB_MATRIX_RENDER_STATS_INTERVAL 5000
+#    endif
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
+
 #if !defined(RGB_MATRIX_STARTUP_MODE)
 #    ifdef ENABLE_RGB_MATRIX_CYCLE_LEFT_RIGHT
 #        define RGB_MATRIX_STARTUP_MODE RGB_MATRIX_CYCLE_LEFT_RIGHT
@@ -117,6 +130,29 @@ uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 last_hit_t g_last_hit_tracker;
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
+uint8_t g_rgb_center_distance[DRIVER_LED_TOTAL];
+#ifdef RGB_MATRIX_LED_DISTANCE_TABLE
+uint8_t g_rgb_led_distance[RGB_MATRIX_LED_DISTANCE_TABLE_SIZE];
+#endif  // RGB_MATRIX_LED_DISTANCE_TABLE
+
+#ifdef RGB_MATRIX_COMPOSITE
+// Layers of the framebuffer, from the bottom up
+enum rgb_composite_layers {
+    RGB_COMPOSITE_EFFECT,
+    RGB_COMPOSITE_OVERLAY,
+    RGB_COMPOSITE_INDICATORS,
+    RGB_COMPOSITE_LAYERS,
+};
+#    define RGB_COMPOSITE_MASK_SIZE ((DRIVER_LED_TOTAL + 7) / 8)
+static RGB rgb_composite_layer[RGB_COMPOSITE_LAYERS][DRIVER_LED_TOTAL];
+// LEDs that have been set in the layers above the effect, which covers every LED
+static uint8_t rgb_composite_mask[RGB_COMPOSITE_LAYERS - 1][RGB_COMPOSITE_MASK_SIZE];
+// what the driver was last given, valid once it has been given every LED
+static RGB     rgb_composite_flushed[DRIVER_LED_TOTAL];
+static bool    rgb_composite_valid   = false;
+static bool    rgb_composite_overlay = false;
+static uint8_t rgb_composite_target  = RGB_COMPOSITE_EFFECT;
+#endif  // RGB_MATRIX_COMPOSITE
 
 // internals
 static bool            suspend_state     = false;
@@ -128,6 +164,20 @@ static rgb_task_states rgb_task_state    = SYNCING;
 static uint32_t rgb_anykey_timer;
 #endif  // RGB_DISABLE_TIMEOUT > 0
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+#    if RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+uint8_t g_rgb_led_process_limit = RGB_MATRIX_LED_PROCESS_LIMIT;
+#    else
+uint8_t g_rgb_led_process_limit = DRIVER_LED_TOTAL;
+#    endif
+static uint32_t rgb_frame_render_us = 0;
+// render statistics of the current effect, for the console
+static uint32_t rgb_stats_timer     = 0;
+static uint16_t rgb_stats_frames    = 0;
+static uint32_t rgb_stats_render_us = 0;
+static uint16_t rgb_stats_max_us    = 0;
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
+
 // double buffers
 static uint32_t rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -176,12 +226,66 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
     return led_count;
 }
 
-void rgb_matrix_update_pwm_buffers(void) { rgb_matrix_driver.flush(); }
+#ifdef RGB_MATRIX_COMPOSITE
+static void rgb_composite_set(uint8_t layer, int index, uint8_t red, uint8_t green, uint8_t blue) {
+    if (index < 0 || index >= DRIVER_LED_TOTAL) return;
+    RGB *led = &rgb_composite_layer[layer][index];
+    led->r   = red;
+    led->g   = green;
+    led->b   = blue;
+    if (layer != RGB_COMPOSITE_EFFECT) {
+        rgb_composite_mask[layer - 1][index / 8] |= 1 << (index % 8);
+    }
+}
+
+// Hands the LEDs whose composited color has changed since the last flush to the driver
+static void rgb_composite_update(void) {
+    uint8_t top = rgb_composite_overlay ? RGB_COMPOSITE_LAYERS - 1 : RGB_COMPOSITE_EFFECT;
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        const RGB *color = &rgb_composite_layer[RGB_COMPOSITE_EFFECT][i];
+        for (uint8_t layer = top; layer > RGB_COMPOSITE_EFFECT; layer--) {
+            if (rgb_composite_mask[layer - 1][i / 8] & (1 << (i % 8))) {
+                color = &rgb_composite_layer[layer][i];
+                break;
+            }
+        }
+        RGB *flushed = &rgb_composite_flushed[i];
+        if (!rgb_composite_valid || flushed->r != color->r || flushed->g != color->g || flushed->b != color->b) {
+            *flushed = *color;
+            rgb_matrix_driver.set_color(i, color->r, color->g, color->b);
+        }
+    }
+    rgb_composite_valid = true;
+}
+
+void rgb_matrix_set_overlay_color(int index, uint8_t red, uint8_t green, uint8_t blue) { rgb_composite_set(RGB_COMPOSITE_OVERLAY, index, red, green, blue); }
 
-void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) { rgb_matrix_driver.set_color(index, red, green, blue); }
+void rgb_matrix_clear_overlay(int index) {
+    if (index < 0 || index >= DRIVER_LED_TOTAL) return;
+    rgb_composite_mask[RGB_COMPOSITE_OVERLAY - 1][index / 8] &= ~(1 << (index % 8));
+}
+
+void rgb_matrix_clear_overlay_all(void) { memset(rgb_composite_mask[RGB_COMPOSITE_OVERLAY - 1], 0, RGB_COMPOSITE_MASK_SIZE); }
+#endif  // RGB_MATRIX_COMPOSITE
+
+void rgb_matrix_update_pwm_buffers(void) {
+#ifdef RGB_MATRIX_COMPOSITE
+    rgb_composite_update();
+#endif  // RGB_MATRIX_COMPOSITE
+    // Still flushed when nothing changed, so drivers can retry writes that failed
+    rgb_matrix_driver.flush();
+}
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef RGB_MATRIX_COMPOSITE
+    rgb_composite_set(rgb_composite_target, index, red, green, blue);
+#else
+    rgb_matrix_driver.set_color(index, red, green, blue);
+#endif  // RGB_MATRIX_COMPOSITE
+}
 
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
-#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+#if (defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)) || defined(RGB_MATRIX_COMPOSITE)
     for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) rgb_matrix_set_color(i, red, green, blue);
 #else
     rgb_matrix_driver.set_color_all(red, green, blue);
@@ -308,6 +412,10 @@ static void rgb_task_start(void) {
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker = last_hit_buffer;
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
+#ifdef RGB_MATRIX_COMPOSITE
+    // the indicators are set again for each frame
+    memset(rgb_composite_mask[RGB_COMPOSITE_INDICATORS - 1], 0, RGB_COMPOSITE_MASK_SIZE);
+#endif  // RGB_MATRIX_COMPOSITE
 
     // next task
     rgb_task_state = RENDERING;
@@ -373,11 +481,70 @@ static void rgb_task_render(uint8_t effect) {
     }
 }
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+static void rgb_render_budget_record(uint32_t elapsed_us) {
+    rgb_frame_render_us += elapsed_us;
+    if (elapsed_us > rgb_stats_max_us) rgb_stats_max_us = elapsed_us > UINT16_MAX ? UINT16_MAX : elapsed_us;
+}
+
+static void rgb_render_budget_adapt(uint8_t effect) {
+    if (effect != rgb_last_effect) {
+        rgb_stats_timer     = timer_read32();
+        rgb_stats_frames    = 0;
+        rgb_stats_render_us = 0;
+        rgb_stats_max_us    = 0;
+    }
+
+    // Work out how many LEDs would have fit into the budget at what this frame cost, and move halfway there. Frames that
+    // initialise an effect usually cost more than the ones after them, so they are left out.
+    if (!rgb_effect_params.init) {
+        uint32_t target = DRIVER_LED_TOTAL;
+        if (rgb_frame_render_us > 0) {
+            target = (uint32_t)RGB_MATRIX_RENDER_BUDGET_US * DRIVER_LED_TOTAL / rgb_frame_render_us;
+        }
+        if (target > DRIVER_LED_TOTAL) target = DRIVER_LED_TOTAL;
+        if (target < 1) target = 1;
+        // rounded towards the target, so that it's reached from either side
+        if (target > g_rgb_led_process_limit) {
+            g_rgb_led_process_limit = (g_rgb_led_process_limit + target + 1) / 2;
+        } else {
+            g_rgb_led_process_limit = (g_rgb_led_process_limit + target) / 2;
+        }
+    }
+
+    if (rgb_stats_frames < UINT16_MAX) {
+        rgb_stats_frames++;
+        rgb_stats_render_us += rgb_frame_render_us;
+    }
+    rgb_frame_render_us = 0;
+
+#    if defined(CONSOLE_ENABLE) && RGB_MATRIX_RENDER_STATS_INTERVAL > 0
+    uint32_t elapsed = timer_elapsed32(rgb_stats_timer);
+    if (elapsed >= RGB_MATRIX_RENDER_STATS_INTERVAL) {
+        dprintf("rgb matrix effect %u: %lu fps, %lu us per frame, %u us per run at most, %u leds per run\n", effect, (unsigned long)rgb_stats_frames * 1000 / elapsed, (unsigned long)(rgb_stats_render_us / rgb_stats_frames), rgb_stats_max_us, g_rgb_led_process_limit);
+        rgb_stats_timer     = timer_read32();
+        rgb_stats_frames    = 0;
+        rgb_stats_render_us = 0;
+        rgb_stats_max_us    = 0;
+    }
+#    endif
+}
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
+
 static void rgb_task_flush(uint8_t effect) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_render_budget_adapt(effect);
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
+
     // update last trackers after the first full render so we can init over several frames
     rgb_last_effect = effect;
     rgb_last_enable = rgb_matrix_config.enable;
 
+#ifdef RGB_MATRIX_COMPOSITE
+    // the overlay and indicators are only shown on top of an effect, not while the LEDs are off
+    rgb_composite_overlay = effect != RGB_MATRIX_NONE;
+#endif  // RGB_MATRIX_COMPOSITE
+
     // update pwm buffers
     rgb_matrix_update_pwm_buffers();
 
@@ -402,13 +569,29 @@ void rgb_matrix_task(void) {
         case STARTING:
             rgb_task_start();
             break;
-        case RENDERING:
+        case RENDERING: {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+            uint32_t render_start = task_profile_timer_read();
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
             rgb_task_render(effect);
             if (effect) {
+#ifdef RGB_MATRIX_COMPOSITE
+                // The indicators have a layer of their own, which the effect can't paint over, so the ones that aren't
+                // given a range of LEDs only need to run once per frame
+                rgb_composite_target = RGB_COMPOSITE_INDICATORS;
+                if (rgb_effect_params.iter <= 1) rgb_matrix_indicators();
+                rgb_matrix_indicators_advanced(&rgb_effect_params);
+                rgb_composite_target = RGB_COMPOSITE_EFFECT;
+#else
                 rgb_matrix_indicators();
                 rgb_matrix_indicators_advanced(&rgb_effect_params);
+#endif  // RGB_MATRIX_COMPOSITE
             }
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+            rgb_render_budget_record(task_profile_timer_elapsed_us(render_start));
+#endif  // RGB_MATRIX_RENDER_BUDGET_US
             break;
+        }
         case FLUSHING:
             rgb_task_flush(effect);
             break;
@@ -416,6 +599,16 @@ void rgb_matrix_task(void) {
             rgb_task_sync();
             break;
     }
+
+#ifdef IDLE_WAIT_ENABLE
+    // Frames are rendered over several iterations, only sleep while waiting for the next one to be due
+    if (rgb_task_state == SYNCING) {
+        uint32_t elapsed = sync_timer_elapsed32(g_rgb_timer);
+        idle_wakeup_in(elapsed < RGB_MATRIX_LED_FLUSH_LIMIT ? RGB_MATRIX_LED_FLUSH_LIMIT - elapsed : 0);
+    } else {
+        idle_wakeup_in(0);
+    }
+#endif  // IDLE_WAIT_ENABLE
 }
 
 void rgb_matrix_indicators(void) {
@@ -433,9 +626,9 @@ void rgb_matrix_indicators_advanced(effect_params_t *params) {
      * and not sure which would be better. Otherwise, this should be called from
      * rgb_task_render, right before the iter++ line.
      */
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
-    uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * (params->iter - 1);
-    uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;
+#if defined(RGB_MATRIX_LED_CHUNK)
+    uint8_t min = RGB_MATRIX_LED_CHUNK * (params->iter - 1);
+    uint8_t max = min + RGB_MATRIX_LED_CHUNK;
     if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
 #else
     uint8_t min = 0;
@@ -449,8 +642,29 @@ __attribute__((weak)) void rgb_matrix_indicators_advanced_kb(uint8_t led_min, ui
 
 __attribute__((weak)) void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {}
 
+static uint8_t rgb_matrix_point_distance(led_point_t a, led_point_t b) {
+    int16_t dx = a.x - b.x;
+    int16_t dy = a.y - b.y;
+    return sqrt16(dx * dx + dy * dy);
+}
+
+void rgb_matrix_update_geometry(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        g_rgb_center_distance[i] = rgb_matrix_point_distance(g_led_config.point[i], k_rgb_matrix_center);
+#ifdef RGB_MATRIX_LED_DISTANCE_TABLE
+        for (uint8_t j = 0; j < i; j++) {
+            g_rgb_led_distance[RGB_MATRIX_LED_DISTANCE_INDEX(i, j)] = rgb_matrix_point_distance(g_led_config.point[i], g_led_config.point[j]);
+        }
+#endif  // RGB_MATRIX_LED_DISTANCE_TABLE
+    }
+}
+
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
+#ifdef RGB_MATRIX_COMPOSITE
+    rgb_composite_valid = false;
+#endif  // RGB_MATRIX_COMPOSITE
+    rgb_matrix_update_geometry();
 
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
@@ -484,6 +698,11 @@ void rgb_matrix_set_suspend_state(bool state) {
         rgb_task_render(0);         // turn off all LEDs when suspending
         rgb_task_flush(0);          // and actually flash led state to LEDs
     }
+#    ifdef RGB_MATRIX_COMPOSITE
+    if (!state && suspend_state) {
+        rgb_composite_valid = false;  // the LEDs may have lost power, so send them every color again
+    }
+#    endif  // RGB_MATRIX_COMPOSITE
     suspend_state = state;
 #endif
 }
@@ -50,19 +50,27 @@
 #    define RGB_MATRIX_LED_PROCESS_LIMIT (DRIVER_LED_TOTAL + 4) / 5
 #endif
 
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#if defined(RGB_MATRIX_RENDER_BUDGET_US)
+// Adjusted after each frame, so that rendering takes about RGB_MATRIX_RENDER_BUDGET_US per task run
+extern uint8_t g_rgb_led_process_limit;
+#    define RGB_MATRIX_LED_CHUNK g_rgb_led_process_limit
+#elif defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#    define RGB_MATRIX_LED_CHUNK RGB_MATRIX_LED_PROCESS_LIMIT
+#endif
+
+#if defined(RGB_MATRIX_LED_CHUNK)
 #    if defined(RGB_MATRIX_SPLIT)
 #        define RGB_MATRIX_USE_LIMITS(min, max)                                                   \
-            uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;                            \
-            uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;                                     \
+            uint8_t min = RGB_MATRIX_LED_CHUNK * params->iter;                                    \
+            uint8_t max = min + RGB_MATRIX_LED_CHUNK;                                             \
             if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;                                   \
             uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;                                     \
             if (is_keyboard_left() && (max > k_rgb_matrix_split[0])) max = k_rgb_matrix_split[0]; \
             if (!(is_keyboard_left()) && (min < k_rgb_matrix_split[0])) min = k_rgb_matrix_split[0];
 #    else
-#        define RGB_MATRIX_USE_LIMITS(min, max)                        \
-            uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter; \
-            uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;          \
+#        define RGB_MATRIX_USE_LIMITS(min, max)                \
+            uint8_t min = RGB_MATRIX_LED_CHUNK * params->iter; \
+            uint8_t max = min + RGB_MATRIX_LED_CHUNK;          \
             if (max > DRIVER_LED_TOTAL) max = DRIVER_LED_TOTAL;
 #    endif
 #else
@@ -137,6 +145,20 @@ void rgb_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max);
 void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max);
 
 void rgb_matrix_init(void);
+// Works out the LED distances again, for keyboards that change g_led_config after init
+void rgb_matrix_update_geometry(void);
+
+#ifdef ENABLE_RGB_MATRIX_PLAYBACK
+// Sets the animation played by the PLAYBACK effect, and starts it over
+void rgb_matrix_playback_set(const rgb_matrix_animation_t *animation);
+#endif
+
+#ifdef RGB_MATRIX_COMPOSITE
+// Colors shown on top of the effect until they are cleared
+void rgb_matrix_set_overlay_color(int index, uint8_t red, uint8_t green, uint8_t blue);
+void rgb_matrix_clear_overlay(int index);
+void rgb_matrix_clear_overlay_all(void);
+#endif
 
 void        rgb_matrix_set_suspend_state(bool state);
 bool        rgb_matrix_get_suspend_state(void);
@@ -260,3 +282,18 @@ extern last_hit_t g_last_hit_tracker;
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 extern uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS];
 #endif
+
+// Distance of each LED from the center, worked out from g_led_config by rgb_matrix_update_geometry()
+extern uint8_t g_rgb_center_distance[DRIVER_LED_TOTAL];
+
+#ifdef RGB_MATRIX_LED_DISTANCE_TABLE
+// Distance between each pair of LEDs, only one of each pair is kept, read it with rgb_matrix_led_distance()
+#    define RGB_MATRIX_LED_DISTANCE_TABLE_SIZE (DRIVER_LED_TOTAL * (DRIVER_LED_TOTAL - 1) / 2)
+#    define RGB_MATRIX_LED_DISTANCE_INDEX(a, b) ((uint16_t)(a) * ((a)-1) / 2 + (b))
+extern uint8_t g_rgb_led_distance[RGB_MATRIX_LED_DISTANCE_TABLE_SIZE];
+
+static inline uint8_t rgb_matrix_led_distance(uint8_t a, uint8_t b) {
+    if (a == b) return 0;
+    return a > b ? g_rgb_led_distance[RGB_MATRIX_LED_DISTANCE_INDEX(a, b)] : g_rgb_led_distance[RGB_MATRIX_LED_DISTANCE_INDEX(b, a)];
+}
+#endif
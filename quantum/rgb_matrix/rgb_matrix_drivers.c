@@ -288,9 +288,16 @@ const rgb_matrix_driver_t rgb_matrix_driver = {
 // LED color buffer
 LED_TYPE rgb_matrix_ws2812_array[DRIVER_LED_TOTAL];
 
+// Unchanged frames aren't sent again, which leaves the strip, or the DMA driver, alone while an effect holds still
+static bool rgb_matrix_ws2812_dirty = true;
+
 static void init(void) {}
 
 static void flush(void) {
+    if (!rgb_matrix_ws2812_dirty) {
+        return;
+    }
+    rgb_matrix_ws2812_dirty = false;
     // Assumes use of RGB_DI_PIN
     ws2812_setleds(rgb_matrix_ws2812_array, DRIVER_LED_TOTAL);
 }
@@ -305,6 +312,17 @@ static inline void setled(int i, uint8_t r, uint8_t g, uint8_t b) {
         return;
 #    endif
 
+#    ifdef RGBW
+    // The white channel has been taken out of the stored color, so add it back to compare with the one asked for
+    uint8_t w = rgb_matrix_ws2812_array[i].w;
+#    else
+    uint8_t w = 0;
+#    endif
+    if (rgb_matrix_ws2812_array[i].r + w == r && rgb_matrix_ws2812_array[i].g + w == g && rgb_matrix_ws2812_array[i].b + w == b) {
+        return;
+    }
+    rgb_matrix_ws2812_dirty = true;
+
     rgb_matrix_ws2812_array[i].r = r;
     rgb_matrix_ws2812_array[i].g = g;
     rgb_matrix_ws2812_array[i].b = b;
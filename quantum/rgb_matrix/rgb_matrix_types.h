@@ -49,6 +49,16 @@ typedef struct PACKED {
 } last_hit_t;
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+// A pre-rendered animation, as generated by `qmk generate-rgb-animation`. The data is kept in PROGMEM, each frame is a
+// series of runs that either keep LEDs as they were in the previous frame, fill them with a single colour, or give each
+// of them its own colour. See quantum/rgb_matrix/animations/playback_anim.h for the encoding.
+typedef struct {
+    uint16_t       frame_count;
+    uint16_t       frame_ms;
+    uint8_t        led_count;
+    const uint8_t *data;
+} rgb_matrix_animation_t;
+
 typedef enum rgb_task_states { STARTING, RENDERING, FLUSHING, SYNCING } rgb_task_states;
 
 typedef uint8_t led_flags_t;
@@ -0,0 +1,112 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "lib8tion.h"
+#include "color.h"
+}
+
+// Every byte value against every scale, at every alignment and length the word loop has to deal with
+TEST(RgbMatrixBatch, Scale8BufferMatchesScale8) {
+    uint8_t buf[8 + 3];
+    for (uint16_t scale = 0; scale < 256; scale++) {
+        for (uint16_t base = 0; base < 256; base += 8) {
+            for (uint8_t offset = 0; offset < 4; offset++) {
+                for (uint8_t len = 0; len <= 8; len++) {
+                    for (uint8_t i = 0; i < sizeof(buf); i++) buf[i] = base + i;
+                    scale8_buffer(buf + offset, len, scale);
+                    for (uint8_t i = 0; i < sizeof(buf); i++) {
+                        uint8_t expected = (i >= offset && i < offset + len) ? scale8(base + i, scale) : (uint8_t)(base + i);
+                        ASSERT_EQ(buf[i], expected) << "scale " << scale << " byte " << (int)i << " offset " << (int)offset << " len " << (int)len;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(RgbMatrixBatch, Qadd8BufferMatchesQadd8) {
+    uint8_t buf[8 + 3];
+    for (uint16_t j = 0; j < 256; j++) {
+        for (uint16_t base = 0; base < 256; base += 8) {
+            for (uint8_t offset = 0; offset < 4; offset++) {
+                for (uint8_t len = 0; len <= 8; len++) {
+                    for (uint8_t i = 0; i < sizeof(buf); i++) buf[i] = base + i;
+                    qadd8_buffer(buf + offset, len, j);
+                    for (uint8_t i = 0; i < sizeof(buf); i++) {
+                        uint8_t expected = (i >= offset && i < offset + len) ? qadd8(base + i, j) : (uint8_t)(base + i);
+                        ASSERT_EQ(buf[i], expected) << "add " << j << " byte " << (int)i << " offset " << (int)offset << " len " << (int)len;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(RgbMatrixBatch, HsvToRgbBufferMatchesHsvToRgb) {
+    std::vector<HSV> hsv;
+    for (uint16_t h = 0; h < 256; h += 3) {
+        for (uint16_t s = 0; s < 256; s += 5) {
+            for (uint16_t v = 0; v < 256; v += 15) {
+                HSV color = {(uint8_t)h, (uint8_t)s, (uint8_t)v};
+                hsv.push_back(color);
+                // Repeat some colors, which are converted once and copied
+                if ((h + s + v) % 4 == 0) hsv.push_back(color);
+            }
+        }
+    }
+    std::vector<RGB> rgb(hsv.size());
+    for (size_t i = 0; i < hsv.size(); i += 256) {
+        hsv_to_rgb_buffer(&hsv[i], &rgb[i], std::min<size_t>(hsv.size() - i, 256), hsv_to_rgb);
+    }
+    for (size_t i = 0; i < hsv.size(); i++) {
+        RGB expected = hsv_to_rgb(hsv[i]);
+        ASSERT_EQ(rgb[i].r, expected.r) << "hsv " << (int)hsv[i].h << "," << (int)hsv[i].s << "," << (int)hsv[i].v;
+        ASSERT_EQ(rgb[i].g, expected.g) << "hsv " << (int)hsv[i].h << "," << (int)hsv[i].s << "," << (int)hsv[i].v;
+        ASSERT_EQ(rgb[i].b, expected.b) << "hsv " << (int)hsv[i].h << "," << (int)hsv[i].s << "," << (int)hsv[i].v;
+    }
+}
+
+static int convert_calls;
+
+static RGB swap_red_blue(HSV hsv) {
+    convert_calls++;
+    RGB rgb     = hsv_to_rgb(hsv);
+    RGB swapped = rgb;
+    swapped.r   = rgb.b;
+    swapped.b   = rgb.r;
+    return swapped;
+}
+
+// The conversion passed in is used, once for each run of the same color, as rgb_matrix passes its weak rgb_matrix_hsv_to_rgb()
+TEST(RgbMatrixBatch, HsvToRgbBufferUsesConversion) {
+    HSV hsv[] = {{0, 255, 255}, {0, 255, 255}, {85, 255, 255}, {0, 255, 255}, {0, 255, 255}};
+    RGB rgb[5];
+    convert_calls = 0;
+    hsv_to_rgb_buffer(hsv, rgb, 5, swap_red_blue);
+    EXPECT_EQ(convert_calls, 3);
+    for (uint8_t i = 0; i < 5; i++) {
+        RGB expected = swap_red_blue(hsv[i]);
+        EXPECT_EQ(rgb[i].r, expected.r);
+        EXPECT_EQ(rgb[i].g, expected.g);
+        EXPECT_EQ(rgb[i].b, expected.b);
+    }
+}
@@ -0,0 +1,159 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "rgb_matrix_mock.h"
+}
+
+// The LEDs the indicators light up, -1 for none
+static int indicator_led    = -1;
+static int indicator_led_kb = -1;
+
+extern "C" void rgb_matrix_indicators_user(void) {
+    if (indicator_led >= 0) rgb_matrix_set_color(indicator_led, 0, 0, 255);
+}
+
+extern "C" void rgb_matrix_indicators_advanced_kb(uint8_t led_min, uint8_t led_max) {
+    if (indicator_led_kb >= led_min && indicator_led_kb < led_max) rgb_matrix_set_color(indicator_led_kb, 255, 255, 255);
+}
+
+static bool operator==(const RGB& a, const RGB& b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+
+// The order of the fields depends on the driver
+static RGB rgb(uint8_t r, uint8_t g, uint8_t b) {
+    RGB color;
+    color.r = r;
+    color.g = g;
+    color.b = b;
+    return color;
+}
+
+static const RGB BLACK = rgb(0, 0, 0);
+static const RGB GREEN = rgb(0, 255, 0);
+static const RGB BLUE  = rgb(0, 0, 255);
+static const RGB WHITE = rgb(255, 255, 255);
+
+class RgbMatrixComposite : public testing::Test {
+   protected:
+    RGB effect;
+
+    void SetUp() override {
+        mock_reset();
+        indicator_led    = -1;
+        indicator_led_kb = -1;
+        rgb_matrix_init();
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        rgb_matrix_sethsv_noeeprom(HSV_RED);
+        rgb_matrix_clear_overlay_all();
+        mock_run_frame();
+        effect = mock_leds[0];
+        mock_set_color_calls = 0;
+    }
+};
+
+TEST_F(RgbMatrixComposite, IndicatorsOverOverlayOverEffect) {
+    rgb_matrix_set_overlay_color(1, 0, 255, 0);
+    rgb_matrix_set_overlay_color(2, 0, 255, 0);
+    indicator_led = 2;
+    mock_run_frame();
+    EXPECT_TRUE(mock_leds[0] == effect);
+    EXPECT_TRUE(mock_leds[1] == GREEN);
+    EXPECT_TRUE(mock_leds[2] == BLUE);
+
+    // the effect can't paint over either of them
+    rgb_matrix_sethsv_noeeprom(HSV_WHITE);
+    mock_run_frame();
+    EXPECT_FALSE(mock_leds[0] == effect);
+    EXPECT_TRUE(mock_leds[1] == GREEN);
+    EXPECT_TRUE(mock_leds[2] == BLUE);
+}
+
+TEST_F(RgbMatrixComposite, IndicatorsAreClearedEachFrame) {
+    indicator_led    = 3;
+    indicator_led_kb = 4;
+    rgb_matrix_set_overlay_color(4, 0, 255, 0);
+    mock_run_frame();
+    EXPECT_TRUE(mock_leds[3] == BLUE);
+    EXPECT_TRUE(mock_leds[4] == WHITE);
+
+    // an indicator that isn't set again goes back to what is underneath it
+    indicator_led    = -1;
+    indicator_led_kb = -1;
+    mock_run_frame();
+    EXPECT_TRUE(mock_leds[3] == effect);
+    EXPECT_TRUE(mock_leds[4] == GREEN);
+}
+
+TEST_F(RgbMatrixComposite, OverlayIsHiddenWhileOff) {
+    rgb_matrix_set_overlay_color(5, 0, 255, 0);
+    indicator_led = 6;
+    mock_run_frame();
+    EXPECT_TRUE(mock_leds[5] == GREEN);
+
+    // RGB_MATRIX_NONE only renders the frame that turns the LEDs off
+    rgb_matrix_disable_noeeprom();
+    mock_run_frame();
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        EXPECT_TRUE(mock_leds[i] == BLACK) << "LED " << (int)i;
+    }
+
+    // and the overlay is still there when they come back on
+    rgb_matrix_enable_noeeprom();
+    mock_run_frame();
+    EXPECT_TRUE(mock_leds[5] == GREEN);
+    EXPECT_TRUE(mock_leds[6] == BLUE);
+}
+
+TEST_F(RgbMatrixComposite, OnlyChangedLedsAreSent) {
+    mock_run_frame();
+    EXPECT_EQ(mock_set_color_calls, 0);
+
+    rgb_matrix_set_overlay_color(7, 0, 255, 0);
+    mock_run_frame();
+    EXPECT_EQ(mock_set_color_calls, 1);
+
+    // an indicator that is set to the same color on every frame is only sent once
+    mock_set_color_calls = 0;
+    indicator_led        = 8;
+    mock_run_frame();
+    mock_run_frame();
+    EXPECT_EQ(mock_set_color_calls, 1);
+
+    mock_set_color_calls = 0;
+    rgb_matrix_clear_overlay(7);
+    indicator_led = -1;
+    mock_run_frame();
+    EXPECT_EQ(mock_set_color_calls, 2);
+    EXPECT_TRUE(mock_leds[7] == effect);
+    EXPECT_TRUE(mock_leds[8] == effect);
+}
+
+TEST_F(RgbMatrixComposite, EveryLedIsSentAfterResume) {
+    rgb_matrix_set_overlay_color(9, 0, 255, 0);
+    mock_run_frame();
+
+    // the LEDs may have lost power while suspended, so the driver can't be trusted to still have the last frame
+    rgb_matrix_set_suspend_state(true);
+    rgb_matrix_set_suspend_state(false);
+    mock_set_color_calls = 0;
+    mock_run_frame();
+    EXPECT_EQ(mock_set_color_calls, DRIVER_LED_TOTAL);
+    EXPECT_TRUE(mock_leds[0] == effect);
+    EXPECT_TRUE(mock_leds[9] == GREEN);
+}
@@ -0,0 +1,73 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "rgb_matrix_mock.h"
+#include "timer.h"
+
+RGB      mock_leds[DRIVER_LED_TOTAL];
+uint16_t mock_set_color_calls = 0;
+uint16_t mock_flushes         = 0;
+
+static void mock_init(void) {}
+
+static void mock_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    mock_leds[index] = (RGB){.r = r, .g = g, .b = b};
+    mock_set_color_calls++;
+}
+
+static void mock_set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) mock_set_color(i, r, g, b);
+}
+
+static void mock_flush(void) { mock_flushes++; }
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = mock_init,
+    .set_color     = mock_set_color,
+    .set_color_all = mock_set_color_all,
+    .flush         = mock_flush,
+};
+
+// LEDs and keys in the same order, without positions
+led_config_t g_led_config;
+
+void mock_reset(void) {
+    memset(mock_leds, 0, sizeof(mock_leds));
+    mock_set_color_calls = 0;
+    mock_flushes         = 0;
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        g_led_config.matrix_co[i / MATRIX_COLS][i % MATRIX_COLS] = i;
+        g_led_config.flags[i]                                    = LED_FLAG_KEYLIGHT;
+    }
+}
+
+void mock_run_frame(void) {
+    uint16_t flushes = mock_flushes;
+    advance_time(RGB_MATRIX_LED_FLUSH_LIMIT);
+    while (mock_flushes == flushes) {
+        rgb_matrix_task();
+    }
+}
+
+bool is_keyboard_master(void) { return true; }
+
+bool eeconfig_is_enabled(void) { return true; }
+void eeconfig_init(void) {}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) { memset(buf, 0, len); }
+void eeprom_update_block(const void *buf, void *addr, size_t len) {}
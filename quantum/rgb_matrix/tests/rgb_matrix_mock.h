@@ -0,0 +1,34 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "rgb_matrix.h"
+
+// What the mocked driver was given
+extern RGB      mock_leds[DRIVER_LED_TOTAL];
+extern uint16_t mock_set_color_calls;
+extern uint16_t mock_flushes;
+
+void mock_reset(void);
+
+// Runs rgb_matrix_task() until the next frame has been rendered and flushed
+void mock_run_frame(void);
+
+// Simulated time, from platforms/test/timer.c and platforms/test/task_profile.c
+void advance_time(uint32_t ms);
+void advance_profile_time(uint32_t us);
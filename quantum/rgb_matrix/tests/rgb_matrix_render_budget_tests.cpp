@@ -0,0 +1,96 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "rgb_matrix_mock.h"
+}
+
+// What rendering each LED costs, charged to the task run that renders it
+static uint32_t render_us_per_led = 0;
+
+extern "C" void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) { advance_profile_time(render_us_per_led * (led_max - led_min)); }
+
+class RgbMatrixRenderBudget : public testing::Test {
+   protected:
+    void SetUp() override {
+        mock_reset();
+        rgb_matrix_init();
+        rgb_matrix_enable_noeeprom();
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+        render_us_per_led = 0;
+        // starts each test from every LED per run
+        g_rgb_led_process_limit = DRIVER_LED_TOTAL;
+        mock_run_frame();
+    }
+};
+
+// RGB_MATRIX_RENDER_BUDGET_US is 100, so at 10us per LED it fits 10 of them
+TEST_F(RgbMatrixRenderBudget, ConvergesOnTheBudget) {
+    render_us_per_led = 10;
+    // halfway from 32 to 10 each frame
+    mock_run_frame();
+    EXPECT_EQ(g_rgb_led_process_limit, 21);
+    mock_run_frame();
+    EXPECT_EQ(g_rgb_led_process_limit, 15);
+    for (int i = 0; i < 8; i++) {
+        mock_run_frame();
+    }
+    EXPECT_EQ(g_rgb_led_process_limit, 10);
+}
+
+TEST_F(RgbMatrixRenderBudget, AtMostEveryLed) {
+    render_us_per_led = 1;
+    for (int i = 0; i < 10; i++) {
+        mock_run_frame();
+        EXPECT_EQ(g_rgb_led_process_limit, DRIVER_LED_TOTAL);
+    }
+
+    // free on the millisecond fallback timer
+    render_us_per_led = 0;
+    mock_run_frame();
+    EXPECT_EQ(g_rgb_led_process_limit, DRIVER_LED_TOTAL);
+}
+
+TEST_F(RgbMatrixRenderBudget, AtLeastOneLed) {
+    render_us_per_led = 1000;
+    for (int i = 0; i < 10; i++) {
+        mock_run_frame();
+        EXPECT_GE(g_rgb_led_process_limit, 1);
+    }
+    EXPECT_EQ(g_rgb_led_process_limit, 1);
+}
+
+// The frame that starts an effect costs more than the ones after it, so it's left out
+TEST_F(RgbMatrixRenderBudget, SkipsInitFrames) {
+    render_us_per_led = 10;
+    for (int i = 0; i < 10; i++) {
+        mock_run_frame();
+    }
+    ASSERT_EQ(g_rgb_led_process_limit, 10);
+
+    render_us_per_led = 1000;
+    rgb_matrix_disable_noeeprom();
+    mock_run_frame();
+    EXPECT_EQ(g_rgb_led_process_limit, 10);
+    rgb_matrix_enable_noeeprom();
+    mock_run_frame();
+    EXPECT_EQ(g_rgb_led_process_limit, 10);
+
+    mock_run_frame();
+    EXPECT_EQ(g_rgb_led_process_limit, 5);
+}
@@ -0,0 +1,43 @@
+rgb_matrix_batch_INC := \
+	$(LIB_PATH)/lib8tion \
+	$(PLATFORM_PATH)
+rgb_matrix_batch_cie_INC := $(rgb_matrix_batch_INC)
+rgb_matrix_batch_cie_DEFS := -DUSE_CIE1931_CURVE
+
+rgb_matrix_batch_SRC := \
+	$(QUANTUM_PATH)/rgb_matrix/tests/rgb_matrix_batch_tests.cpp \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/led_tables.c
+rgb_matrix_batch_cie_SRC := $(rgb_matrix_batch_SRC)
+
+RGB_MATRIX_MOCK_INC := \
+	$(QUANTUM_PATH)/rgb_matrix/tests \
+	$(QUANTUM_PATH)/rgb_matrix \
+	$(QUANTUM_PATH)/rgb_matrix/animations \
+	$(QUANTUM_PATH)/rgb_matrix/animations/runners \
+	$(QUANTUM_PATH)/bootmagic \
+	$(QUANTUM_PATH)/logging \
+	$(LIB_PATH)/lib8tion \
+	$(PLATFORM_PATH) \
+	$(PLATFORM_PATH)/test \
+	$(TMK_PATH)/protocol
+RGB_MATRIX_MOCK_SRC := \
+	$(QUANTUM_PATH)/rgb_matrix/tests/rgb_matrix_mock.c \
+	$(QUANTUM_PATH)/rgb_matrix/rgb_matrix.c \
+	$(QUANTUM_PATH)/color.c \
+	$(PLATFORM_PATH)/test/timer.c \
+	$(PLATFORM_PATH)/test/task_profile.c
+
+rgb_matrix_render_budget_INC := $(RGB_MATRIX_MOCK_INC)
+rgb_matrix_render_budget_CONFIG := $(QUANTUM_PATH)/rgb_matrix/tests/config.h
+rgb_matrix_render_budget_DEFS := -DNO_DEBUG -DRGB_MATRIX_RENDER_BUDGET_US=100
+rgb_matrix_render_budget_SRC := \
+	$(RGB_MATRIX_MOCK_SRC) \
+	$(QUANTUM_PATH)/rgb_matrix/tests/rgb_matrix_render_budget_tests.cpp
+
+rgb_matrix_composite_INC := $(RGB_MATRIX_MOCK_INC)
+rgb_matrix_composite_CONFIG := $(QUANTUM_PATH)/rgb_matrix/tests/config.h
+rgb_matrix_composite_DEFS := -DNO_DEBUG -DRGB_MATRIX_COMPOSITE -DRGB_DISABLE_WHEN_USB_SUSPENDED
+rgb_matrix_composite_SRC := \
+	$(RGB_MATRIX_MOCK_SRC) \
+	$(QUANTUM_PATH)/rgb_matrix/tests/rgb_matrix_composite_tests.cpp
@@ -0,0 +1 @@
+TEST_LIST += rgb_matrix_batch rgb_matrix_batch_cie rgb_matrix_render_budget rgb_matrix_composite
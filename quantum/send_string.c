@@ -147,6 +147,10 @@ void send_string(const char *str) { send_string_with_delay(str, 0); }
 void send_string_P(const char *str) { send_string_with_delay_P(str, 0); }
 
 void send_string_with_delay(const char *str, uint8_t interval) {
+#ifdef SEND_STRING_ASYNC_ENABLE
+    // stay behind the strings already queued up
+    send_string_async_flush();
+#endif
     while (1) {
         char ascii_code = *str;
         if (!ascii_code) break;
@@ -188,6 +192,10 @@ void send_string_with_delay(const char *str, uint8_t interval) {
 }
 
 void send_string_with_delay_P(const char *str, uint8_t interval) {
+#ifdef SEND_STRING_ASYNC_ENABLE
+    // stay behind the strings already queued up
+    send_string_async_flush();
+#endif
     while (1) {
         char ascii_code = pgm_read_byte(str);
         if (!ascii_code) break;
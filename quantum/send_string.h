@@ -52,3 +52,30 @@ void send_byte(uint8_t number);
 void send_nibble(uint8_t number);
 
 void tap_random_base64(void);
+
+#ifdef SEND_STRING_ASYNC_ENABLE
+#    include <stdbool.h>
+
+#    define SEND_STRING_ASYNC(string) send_string_async_P(PSTR(string))
+#    define SEND_STRING_ASYNC_DELAY(string, interval) send_string_with_delay_async_P(PSTR(string), interval)
+
+// Queue a string to be typed from the main loop, returning straight away unless the queue is full. Strings in
+// RAM are copied into a buffer first, and block until the start of them has been typed if they don't fit.
+void send_string_async(const char *str);
+void send_string_with_delay_async(const char *str, uint8_t interval);
+void send_string_async_P(const char *str);
+void send_string_with_delay_async_P(const char *str, uint8_t interval);
+
+// Reads the byte of a string at offset, for strings that are neither in RAM nor in flash
+typedef uint8_t (*send_string_reader_t)(uint16_t offset);
+// Queue a string that is read through reader from offset on, as it's typed. SS_TAP_CODE, SS_DOWN_CODE and SS_UP_CODE
+// may leave out SS_QMK_PREFIX, as they do in dynamic keymap macros.
+void send_string_async_reader(send_string_reader_t reader, uint16_t offset);
+
+// Whether any queued string is still being typed
+bool send_string_async_busy(void);
+// Type whatever is left in the queue before returning
+void send_string_async_flush(void);
+// Send the next report of the queued strings, if it's time to. Called from the main loop.
+void send_string_async_task(void);
+#endif
@@ -0,0 +1,352 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+Plays send_string sequences back from the main loop, one keyboard report per
+keyboard_task(), instead of sending them all at once with wait_ms() in between.
+Sending a string only queues where to read it from: strings in flash are read
+in place, strings in RAM are copied into a buffer, and dynamic keymap macros are
+read through a callback. Each is parsed an operation at a time as it's played,
+and each operation is broken down into the presses and releases it takes. A step
+waits for the host to have taken the previous report, and delays are timers
+rather than waits, so the matrix, lighting and the rest of the keyboard carry on
+while a long macro types out.
+*/
+
+#include <ctype.h>
+
+#include "quantum.h"
+
+#include "send_string.h"
+#ifdef IDLE_WAIT_ENABLE
+#    include "idle_wait.h"
+#endif
+
+#ifndef SEND_STRING_ASYNC_QUEUE_SIZE
+#    define SEND_STRING_ASYNC_QUEUE_SIZE 8
+#endif
+
+#ifndef SEND_STRING_ASYNC_BUFFER_SIZE
+#    define SEND_STRING_ASYNC_BUFFER_SIZE 64
+#endif
+
+#if SEND_STRING_ASYNC_QUEUE_SIZE > 255
+#    error SEND_STRING_ASYNC_QUEUE_SIZE must be 255 or less
+#endif
+
+// A string longer than the buffer is played while it's copied, so the buffer has to hold any single operation, such as an SS_DELAY()
+#if SEND_STRING_ASYNC_BUFFER_SIZE < 16
+#    error SEND_STRING_ASYNC_BUFFER_SIZE must be 16 or more
+#endif
+
+typedef enum {
+    SEND_STRING_SOURCE_RAM,
+    SEND_STRING_SOURCE_PROGMEM,
+    SEND_STRING_SOURCE_READER,
+} send_string_source_type_t;
+
+// A queued string, and how far it has been played. Strings from RAM are read from the buffer.
+typedef struct {
+    uint8_t              type;
+    uint8_t              interval;
+    bool                 ended;    // its terminating null has been read
+    const char *         progmem;  // for SEND_STRING_SOURCE_PROGMEM
+    send_string_reader_t reader;   // for SEND_STRING_SOURCE_READER
+    uint16_t             offset;   // for SEND_STRING_SOURCE_READER
+} send_string_source_t;
+
+typedef enum {
+    SEND_STRING_OP_CHAR,
+    SEND_STRING_OP_TAP,
+    SEND_STRING_OP_DOWN,
+    SEND_STRING_OP_UP,
+    SEND_STRING_OP_DELAY,
+} send_string_op_type_t;
+
+typedef struct {
+    send_string_op_type_t type;
+    uint32_t              value;  // character, keycode or milliseconds
+} send_string_op_t;
+
+typedef struct {
+    uint8_t  keycode;
+    bool     pressed;
+    uint16_t delay;  // milliseconds to wait after this step
+} send_string_step_t;
+
+// Enough for a shifted, AltGr'd dead key: two mods down, the key down and up, two mods up, and a space to tap
+#define SEND_STRING_MAX_STEPS 8
+
+static send_string_source_t sources[SEND_STRING_ASYNC_QUEUE_SIZE];
+static uint8_t              source_head  = 0;
+static uint8_t              source_count = 0;
+
+// The strings queued from RAM, one after the other with their terminating nulls
+static char     buffer[SEND_STRING_ASYNC_BUFFER_SIZE];
+static uint16_t buffer_head  = 0;
+static uint16_t buffer_count = 0;
+
+static send_string_step_t steps[SEND_STRING_MAX_STEPS];
+static uint8_t            step_count = 0;
+static uint8_t            step_index = 0;
+static bool               waiting    = false;
+static uint32_t           wait_until;
+
+static void start_wait(uint32_t ms) {
+    if (ms == 0) return;
+    waiting    = true;
+    wait_until = timer_read32() + ms;
+}
+
+static void add_step(uint8_t keycode, bool pressed, uint16_t delay) { steps[step_count++] = (send_string_step_t){.keycode = keycode, .pressed = pressed, .delay = delay}; }
+
+static void add_tap(uint8_t keycode) {
+    add_step(keycode, true, keycode == KC_CAPS_LOCK ? TAP_HOLD_CAPS_DELAY : TAP_CODE_DELAY);
+    add_step(keycode, false, 0);
+}
+
+static bool lut_bit(const uint8_t *lut, uint8_t ascii_code) { return (pgm_read_byte(&lut[ascii_code / 8]) >> (ascii_code % 8)) & 0x01; }
+
+// The same presses and releases as send_char()
+static void add_char(char ascii_code) {
+#if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+    if (ascii_code == '\a') {
+        send_char(ascii_code);
+        return;
+    }
+#endif
+
+    uint8_t keycode    = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+    bool    is_shifted = lut_bit(ascii_to_shift_lut, ascii_code);
+    bool    is_altgred = lut_bit(ascii_to_altgr_lut, ascii_code);
+    bool    is_dead    = lut_bit(ascii_to_dead_lut, ascii_code);
+
+    if (is_shifted) add_step(KC_LSFT, true, 0);
+    if (is_altgred) add_step(KC_RALT, true, 0);
+    add_tap(keycode);
+    if (is_altgred) add_step(KC_RALT, false, 0);
+    if (is_shifted) add_step(KC_LSFT, false, 0);
+    if (is_dead) add_tap(KC_SPACE);
+}
+
+// Reads the next byte of the string being played
+static char read_next(send_string_source_t *source) {
+    char c;
+    switch (source->type) {
+        case SEND_STRING_SOURCE_RAM:
+            c           = buffer[buffer_head];
+            buffer_head = (buffer_head + 1) % SEND_STRING_ASYNC_BUFFER_SIZE;
+            buffer_count--;
+            break;
+        case SEND_STRING_SOURCE_PROGMEM:
+            c = pgm_read_byte(source->progmem++);
+            break;
+        default:
+            c = source->reader(source->offset++);
+            break;
+    }
+    if (!c) source->ended = true;
+    return c;
+}
+
+// Whether the string being played has nothing after what has been read of it. A RAM string still being copied isn't over.
+static bool at_end(send_string_source_t *source) {
+    switch (source->type) {
+        case SEND_STRING_SOURCE_RAM:
+            return buffer_count && !buffer[buffer_head];
+        case SEND_STRING_SOURCE_PROGMEM:
+            return !pgm_read_byte(source->progmem);
+        default:
+            return !source->reader(source->offset);
+    }
+}
+
+static void pop_source(void) {
+    source_head = (source_head + 1) % SEND_STRING_ASYNC_QUEUE_SIZE;
+    source_count--;
+}
+
+// Parses the next op of the string being played, returning false once it's over. Nothing is read past the
+// terminating null, so the buffer is left at the start of the next RAM string.
+static bool parse_next_op(send_string_source_t *source, send_string_op_t *op) {
+    while (!source->ended) {
+        char ascii_code = read_next(source);
+        if (!ascii_code) return false;
+
+        if (source->type == SEND_STRING_SOURCE_READER) {
+            // Dynamic keymap macros have SS_TAP_CODE, SS_DOWN_CODE and SS_UP_CODE without SS_QMK_PREFIX, and no delays
+            if (ascii_code != SS_TAP_CODE && ascii_code != SS_DOWN_CODE && ascii_code != SS_UP_CODE) {
+                op->type  = SEND_STRING_OP_CHAR;
+                op->value = (uint8_t)ascii_code;
+                return true;
+            }
+        } else {
+            if (ascii_code != SS_QMK_PREFIX) {
+                op->type  = SEND_STRING_OP_CHAR;
+                op->value = (uint8_t)ascii_code;
+                return true;
+            }
+            ascii_code = read_next(source);
+            if (ascii_code == SS_DELAY_CODE) {
+                uint32_t ms      = 0;
+                char     keycode = read_next(source);
+                while (isdigit(keycode)) {
+                    ms *= 10;
+                    ms += keycode - '0';
+                    keycode = read_next(source);
+                }
+                op->type  = SEND_STRING_OP_DELAY;
+                op->value = ms;
+                return true;
+            }
+        }
+
+        if (ascii_code == SS_TAP_CODE || ascii_code == SS_DOWN_CODE || ascii_code == SS_UP_CODE) {
+            uint8_t keycode = read_next(source);
+            if (!keycode) return false;
+            op->type  = ascii_code == SS_TAP_CODE ? SEND_STRING_OP_TAP : ascii_code == SS_DOWN_CODE ? SEND_STRING_OP_DOWN : SEND_STRING_OP_UP;
+            op->value = keycode;
+            return true;
+        }
+        // anything else after the prefix is skipped, as by send_string()
+    }
+    return false;
+}
+
+// Parses the next op of the queued strings and works out its steps, returning false if there's nothing left to play
+static bool load_next_op(void) {
+    while (source_count) {
+        send_string_source_t *source = &sources[source_head];
+        send_string_op_t      op;
+        if (!parse_next_op(source, &op)) {
+            pop_source();
+            continue;
+        }
+        uint8_t interval = source->interval;
+        // Let go of the string with its last op, so the queue isn't busy for a step longer than it's typing
+        if (at_end(source)) {
+            read_next(source);
+            pop_source();
+        }
+
+        step_count = 0;
+        step_index = 0;
+        switch (op.type) {
+            case SEND_STRING_OP_CHAR:
+                add_char(op.value);
+                break;
+            case SEND_STRING_OP_TAP:
+                add_tap(op.value);
+                break;
+            case SEND_STRING_OP_DOWN:
+                add_step(op.value, true, 0);
+                break;
+            case SEND_STRING_OP_UP:
+                add_step(op.value, false, 0);
+                break;
+            case SEND_STRING_OP_DELAY:
+                start_wait(op.value + interval);
+                return true;
+        }
+
+        // like the interval after each character of send_string_with_delay()
+        if (step_count) {
+            steps[step_count - 1].delay += interval;
+        } else {
+            start_wait(interval);
+        }
+        return true;
+    }
+    return false;
+}
+
+// Sends one report if it's time to, returning false when it has to wait for a delay or the host
+static bool play_step(void) {
+    if (waiting) {
+        if (!timer_expired32(timer_read32(), wait_until)) return false;
+        waiting = false;
+    }
+
+    if (step_index == step_count && !load_next_op()) return false;
+    if (step_index == step_count) return !waiting;
+
+    if (!host_keyboard_ready()) return false;
+
+    send_string_step_t step = steps[step_index++];
+    if (step.pressed) {
+        register_code(step.keycode);
+    } else {
+        unregister_code(step.keycode);
+    }
+    start_wait(step.delay);
+    return true;
+}
+
+bool send_string_async_busy(void) { return waiting || step_index < step_count || source_count; }
+
+void send_string_async_task(void) {
+    play_step();
+
+#ifdef IDLE_WAIT_ENABLE
+    if (send_string_async_busy()) idle_wakeup_in(1);
+#endif
+}
+
+// Plays the queued strings until there's nothing left, or until done() says to stop
+static void play_until(bool (*done)(void)) {
+    while (send_string_async_busy() && !(done && done())) {
+        if (!play_step()) wait_ms(1);
+    }
+}
+
+void send_string_async_flush(void) { play_until(NULL); }
+
+static bool source_free(void) { return source_count < SEND_STRING_ASYNC_QUEUE_SIZE; }
+
+static bool buffer_free(void) { return buffer_count < SEND_STRING_ASYNC_BUFFER_SIZE; }
+
+static send_string_source_t *queue_source(send_string_source_type_t type, uint8_t interval) {
+    // When the queue is full, play as much of it as it takes to make room
+    play_until(source_free);
+    send_string_source_t *source = &sources[(source_head + source_count) % SEND_STRING_ASYNC_QUEUE_SIZE];
+    source->type                 = type;
+    source->interval             = interval;
+    source->ended                = false;
+    source_count++;
+    return source;
+}
+
+void send_string_async(const char *str) { send_string_with_delay_async(str, 0); }
+
+void send_string_async_P(const char *str) { send_string_with_delay_async_P(str, 0); }
+
+void send_string_with_delay_async(const char *str, uint8_t interval) {
+    queue_source(SEND_STRING_SOURCE_RAM, interval);
+    // The string is copied, as it may not outlive the call. One longer than the buffer blocks until the start of it has been typed.
+    do {
+        play_until(buffer_free);
+        buffer[(buffer_head + buffer_count) % SEND_STRING_ASYNC_BUFFER_SIZE] = *str;
+        buffer_count++;
+    } while (*str++);
+}
+
+void send_string_with_delay_async_P(const char *str, uint8_t interval) { queue_source(SEND_STRING_SOURCE_PROGMEM, interval)->progmem = str; }
+
+void send_string_async_reader(send_string_reader_t reader, uint16_t offset) {
+    send_string_source_t *source = queue_source(SEND_STRING_SOURCE_READER, 0);
+    source->reader               = reader;
+    source->offset               = offset;
+}
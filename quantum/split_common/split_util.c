@@ -16,12 +16,12 @@
 #include "split_util.h"
 #include "matrix.h"
 #include "keyboard.h"
-#include "config.h"
 #include "timer.h"
 #include "transport.h"
 #include "quantum.h"
 #include "wait.h"
 #include "usb_util.h"
+#include "task_profile.h"
 
 #ifdef EE_HANDS
 #    include "eeconfig.h"
@@ -171,7 +171,9 @@ bool transport_master_if_connected(matrix_row_t master_matrix[], matrix_row_t sl
     }
 #endif  // SPLIT_MAX_CONNECTION_ERRORS > 0 && SPLIT_CONNECTION_CHECK_TIMEOUT > 0
 
+    TASK_PROFILE_BEGIN(TASK_PROFILE_SPLIT_TRANSACTIONS);
     __attribute__((unused)) bool okay = transport_master(master_matrix, slave_matrix);
+    TASK_PROFILE_END(TASK_PROFILE_SPLIT_TRANSACTIONS);
 #if SPLIT_MAX_CONNECTION_ERRORS > 0
     if (!okay) {
         if (connection_errors < UINT8_MAX) {
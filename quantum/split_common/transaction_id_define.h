@@ -24,6 +24,10 @@ enum serial_transaction_id {
     GET_SLAVE_MATRIX_CHECKSUM,
     GET_SLAVE_MATRIX_DATA,
 
+#ifdef SERIAL_USART_SLAVE_PUSH
+    PUT_SLAVE_PUSH_ACK,
+#endif  // SERIAL_USART_SLAVE_PUSH
+
 #ifdef SPLIT_TRANSPORT_MIRROR
     PUT_MASTER_MATRIX,
 #endif  // SPLIT_TRANSPORT_MIRROR
@@ -78,6 +82,10 @@ enum serial_transaction_id {
     PUT_ST7565,
 #endif  // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_TRANSACTION_BUNDLE
+    BUNDLED_EXCHANGE,
+#endif  // SPLIT_TRANSACTION_BUNDLE
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     PUT_RPC_INFO,
     PUT_RPC_REQ_DATA,
@@ -99,4 +107,8 @@ enum serial_transaction_id {
 };
 
 // Ensure we only use 5 bits for transaction
+#ifdef __cplusplus
+static_assert(NUM_TOTAL_TRANSACTIONS <= (1 << 5), "Max number of usable transactions exceeded");
+#else
 _Static_assert(NUM_TOTAL_TRANSACTIONS <= (1 << 5), "Max number of usable transactions exceeded");
+#endif
@@ -42,6 +42,9 @@
     { &dummy, 0, 0, sizeof_member(split_shared_memory_t, member), offsetof(split_shared_memory_t, member), cb }
 #define trans_target2initiator_initializer(member) trans_target2initiator_initializer_cb(member, NULL)
 
+#define trans_bidirectional_initializer(initiator2target_member, target2initiator_member) \
+    { &dummy, sizeof_member(split_shared_memory_t, initiator2target_member), offsetof(split_shared_memory_t, initiator2target_member), sizeof_member(split_shared_memory_t, target2initiator_member), offsetof(split_shared_memory_t, target2initiator_member), NULL }
+
 #define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
 #define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
 
@@ -70,16 +73,214 @@ static bool transaction_handler_master(matrix_row_t master_matrix[], matrix_row_
     return false;
 }
 
-#define TRANSACTION_HANDLER_MASTER(prefix)                                                                              \
-    do {                                                                                                                \
-        if (!transaction_handler_master(master_matrix, slave_matrix, #prefix, &prefix##_handlers_master)) return false; \
-    } while (0)
+#ifdef SPLIT_TRANSACTION_BUNDLE
+// Handlers only queue up or pick up data, the bundled exchange itself is retried on its own
+#    define TRANSACTION_HANDLER_MASTER(prefix)                                          \
+        do {                                                                            \
+            if (!prefix##_handlers_master(master_matrix, slave_matrix)) return false; \
+        } while (0)
+#else  // SPLIT_TRANSACTION_BUNDLE
+#    define TRANSACTION_HANDLER_MASTER(prefix)                                                                              \
+        do {                                                                                                                \
+            if (!transaction_handler_master(master_matrix, slave_matrix, #prefix, &prefix##_handlers_master)) return false; \
+        } while (0)
+#endif  // SPLIT_TRANSACTION_BUNDLE
 
 #define TRANSACTION_HANDLER_SLAVE(prefix)                                               \
     do {                                                                                \
         ATOMIC_BLOCK_FORCEON { prefix##_handlers_slave(master_matrix, slave_matrix); }; \
     } while (0)
 
+#ifdef SPLIT_TRANSACTION_BUNDLE
+
+////////////////////////////////////////////////////
+// Bundled exchange
+//
+// Instead of a transaction per subsystem, the master sends a single frame with the data of every transaction that
+// changed and the slave answers with a single frame of its own. Data sent by the master stays in its frames until the
+// slave acknowledges a frame that contained it, so nothing is lost if the slave misses a frame. Each section carries a
+// sequence number that changes along with its data, so neither side has to process data it has already seen.
+
+_Static_assert(sizeof(split_bundle_m2s_max_t) <= UINT8_MAX, "Bundled master frame too large");
+_Static_assert(sizeof(split_bundle_s2m_max_t) <= UINT8_MAX, "Bundled slave frame too large");
+
+// Transactions carried from the slave to the master
+static const int8_t bundle_s2m_ids[] = {
+    GET_SLAVE_MATRIX_DATA,
+#    ifdef ENCODER_ENABLE
+    GET_ENCODERS_DATA,
+#    endif  // ENCODER_ENABLE
+};
+
+static uint8_t  bundle_frame_seq = 0;  // master: sequence number of the last frame sent
+static uint8_t  bundle_frame_ack = 0;  // slave: sequence number of the last frame received
+static bool     bundle_received  = false;
+static uint32_t bundle_pending   = 0;  // transactions not yet acknowledged by the slave
+static uint32_t bundle_seen      = 0;  // transactions received at least once
+static uint8_t  bundle_sent_in[NUM_TOTAL_TRANSACTIONS];
+static uint8_t  bundle_seq_out[NUM_TOTAL_TRANSACTIONS];
+static uint8_t  bundle_seq_in[NUM_TOTAL_TRANSACTIONS];
+
+static uint8_t bundle_crc(const uint8_t *frame) {
+    const split_bundle_header_t *header = (const split_bundle_header_t *)frame;
+    return crc8(&header->seq, sizeof(split_bundle_header_t) - offsetof(split_bundle_header_t, seq) + header->length);
+}
+
+static uint8_t bundle_put(uint8_t *frame, uint8_t length, int8_t id, uint8_t seq, const void *data, uint8_t data_length) {
+    split_bundle_section_t *section = (split_bundle_section_t *)&frame[sizeof(split_bundle_header_t) + length];
+    section->id                     = id;
+    section->length                 = data_length;
+    section->seq                    = seq;
+    memcpy(section + 1, data, data_length);
+    return length + sizeof(split_bundle_section_t) + data_length;
+}
+
+static void bundle_finish(uint8_t *frame, uint8_t length, uint8_t seq, uint8_t ack) {
+    split_bundle_header_t *header = (split_bundle_header_t *)frame;
+    header->length                = length;
+    header->seq                   = seq;
+    header->ack                   = ack;
+    header->crc                   = bundle_crc(frame);
+}
+
+static bool bundle_valid(const uint8_t *frame, size_t size) {
+    const split_bundle_header_t *header = (const split_bundle_header_t *)frame;
+    return header->length <= size - sizeof(split_bundle_header_t) && header->crc == bundle_crc(frame);
+}
+
+// Calls `handler` for every well-formed section of `frame`
+static void bundle_for_each(const uint8_t *frame, void (*handler)(int8_t id, uint8_t seq, const void *data, uint8_t length)) {
+    const split_bundle_header_t *header = (const split_bundle_header_t *)frame;
+    uint16_t                     offset = 0;
+    while (offset + sizeof(split_bundle_section_t) <= header->length) {
+        const split_bundle_section_t *section = (const split_bundle_section_t *)&frame[sizeof(split_bundle_header_t) + offset];
+        offset += sizeof(split_bundle_section_t) + section->length;
+        if (offset > header->length) break;
+        if (section->id >= 0 && section->id < NUM_TOTAL_TRANSACTIONS) {
+            handler(section->id, section->seq, section + 1, section->length);
+        }
+    }
+}
+
+// Slave: whether a section is new, remembering it if so
+static bool bundle_accept(int8_t id, uint8_t seq) {
+    if ((bundle_seen & (1UL << id)) && bundle_seq_in[id] == seq) {
+        return false;
+    }
+    bundle_seen |= (1UL << id);
+    bundle_seq_in[id] = seq;
+    return true;
+}
+
+// Master: queues data for the next bundled exchange, in place of a write transaction
+static bool bundle_send(int8_t id, const void *data, size_t length) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    if (length > trans->initiator2target_buffer_size) {
+        length = trans->initiator2target_buffer_size;
+    }
+    // Keep the local copy up to date, as transport_execute_transaction() would
+    memcpy(split_trans_initiator2target_buffer(trans), data, length);
+    bundle_seq_out[id]++;
+    bundle_sent_in[id] = bundle_frame_seq + 1;
+    bundle_pending |= (1UL << id);
+    return true;
+}
+
+static void bundle_receive_master(int8_t id, uint8_t seq, const void *data, uint8_t length) {
+    // The slave's data is small and has to be current, so it is always taken over
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    if (length == trans->target2initiator_buffer_size) {
+        memcpy(split_trans_target2initiator_buffer(trans), data, length);
+        bundle_seen |= (1UL << id);
+    }
+}
+
+static uint8_t bundle_m2s_frame[sizeof(split_bundle_m2s_max_t)];
+static uint8_t bundle_s2m_frame[sizeof(split_bundle_s2m_max_t)];
+
+static bool bundle_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    uint8_t length = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; ++id) {
+        if (bundle_pending & (1UL << id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            length                          = bundle_put(bundle_m2s_frame, length, id, bundle_seq_out[id], split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size);
+        }
+    }
+    bundle_finish(bundle_m2s_frame, length, bundle_frame_seq, 0);
+
+    if (!transport_execute_transaction(BUNDLED_EXCHANGE, bundle_m2s_frame, sizeof(split_bundle_header_t) + length, bundle_s2m_frame, sizeof(bundle_s2m_frame))) {
+        return false;
+    }
+    if (!bundle_valid(bundle_s2m_frame, sizeof(bundle_s2m_frame))) {
+        return false;
+    }
+
+    // Everything first sent in a frame the slave has processed since has arrived
+    uint8_t ack = ((split_bundle_header_t *)bundle_s2m_frame)->ack;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; ++id) {
+        if ((bundle_pending & (1UL << id)) && (int8_t)(ack - bundle_sent_in[id]) >= 0) {
+            bundle_pending &= ~(1UL << id);
+        }
+    }
+
+    bundle_for_each(bundle_s2m_frame, bundle_receive_master);
+    return true;
+}
+
+// Master: picks up data received in the bundled exchange, in place of a read transaction
+static bool bundle_read(int8_t id, void *destination, size_t length) {
+    if (!(bundle_seen & (1UL << id))) {
+        return false;
+    }
+    memcpy(destination, split_trans_target2initiator_buffer(&split_transaction_table[id]), length);
+    return true;
+}
+
+static void bundle_receive_slave(int8_t id, uint8_t seq, const void *data, uint8_t length) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    if (length == trans->initiator2target_buffer_size && bundle_accept(id, seq)) {
+        memcpy(split_trans_initiator2target_buffer(trans), data, length);
+    }
+}
+
+// Slave: unpacks the latest frame from the master into the shared memory, for the regular handlers to act upon
+static void bundle_receive_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    const split_bundle_header_t *header = (const split_bundle_header_t *)split_shmem->bundle_m2s;
+    if ((bundle_received && header->seq == bundle_frame_ack) || !bundle_valid(split_shmem->bundle_m2s, sizeof(split_shmem->bundle_m2s))) {
+        return;
+    }
+    bundle_for_each(split_shmem->bundle_m2s, bundle_receive_slave);
+    bundle_frame_ack = header->seq;
+    bundle_received  = true;
+}
+
+// Slave: prepares the frame the master receives in the next exchange
+static void bundle_send_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint8_t last_crc[sizeof(bundle_s2m_ids)];
+    static uint8_t frame_seq = 0;
+    uint8_t        length = 0;
+    for (uint8_t i = 0; i < sizeof(bundle_s2m_ids); ++i) {
+        split_transaction_desc_t *trans = &split_transaction_table[bundle_s2m_ids[i]];
+        const uint8_t *           data  = split_trans_target2initiator_buffer(trans);
+        uint8_t                   crc   = crc8(data, trans->target2initiator_buffer_size);
+        if (crc != last_crc[i]) {
+            last_crc[i] = crc;
+            bundle_seq_out[bundle_s2m_ids[i]]++;
+        }
+        length = bundle_put(split_shmem->bundle_s2m, length, bundle_s2m_ids[i], bundle_seq_out[bundle_s2m_ids[i]], data, trans->target2initiator_buffer_size);
+    }
+    bundle_finish(split_shmem->bundle_s2m, length, ++frame_seq, bundle_frame_ack);
+}
+
+#    define transaction_send(id, data, length) bundle_send(id, data, length)
+
+// The frame checksum already covers the data, and unchanged data is skipped by its sequence number
+inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t trans_id_retrieve, uint32_t *last_update, void *destination, const void *equiv_shmem, size_t length) { return bundle_read(trans_id_retrieve, destination, length); }
+
+#else  // SPLIT_TRANSACTION_BUNDLE
+
+#    define transaction_send(id, data, length) transport_write(id, data, length)
+
 inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t trans_id_retrieve, uint32_t *last_update, void *destination, const void *equiv_shmem, size_t length) {
     uint8_t curr_checksum;
     bool    okay = transport_read(trans_id_checksum, &curr_checksum, sizeof(curr_checksum));
@@ -95,10 +296,12 @@ inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t tr
     return okay;
 }
 
+#endif  // SPLIT_TRANSACTION_BUNDLE
+
 inline static bool send_if_condition(int8_t trans_id, uint32_t *last_update, bool condition, void *source, size_t length) {
     bool okay = true;
     if (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || condition) {
-        okay &= transport_write(trans_id, source, length);
+        okay &= transaction_send(trans_id, source, length);
         if (okay) {
             *last_update = timer_read32();
         }
@@ -114,6 +317,144 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
 ////////////////////////////////////////////////////
 // Slave matrix
 
+#ifdef SERIAL_USART_SLAVE_PUSH
+
+#    ifndef SERIAL_USART_PUSH_RETRY_MS
+#        define SERIAL_USART_PUSH_RETRY_MS 5
+#    endif  // SERIAL_USART_PUSH_RETRY_MS
+
+static split_slave_push_t slave_push;                  // master: last state taken
+static bool               slave_push_fresh   = false;  // master: slave_push was pushed during this scan
+static bool               slave_push_updated = false;  // master: slave_push was pushed or polled during this scan
+static bool               slave_push_polling = true;   // master: pushes went missing, so the slave is polled on every scan
+static uint8_t            slave_push_seq     = 0;      // slave: last state pushed
+static bool               slave_push_acked   = true;   // slave: the master took the last state pushed
+
+static uint8_t slave_push_checksum(const split_slave_push_t *push) { return crc8(push, offsetof(split_slave_push_t, checksum)); }
+
+// Master: takes the oldest push and acknowledges it. Pushes are taken one per scan, so every state the slave went
+// through is seen, and this runs once per scan however often the rest of the slave matrix handler is retried.
+static void slave_push_receive(void) {
+    split_slave_push_t push;
+    slave_push_fresh   = false;
+    slave_push_updated = false;
+    if (!transport_master_receive_push(&push) || push.checksum != slave_push_checksum(&push)) {
+        return;
+    }
+
+    // A state pushed again because its acknowledgement got lost, or one that was polled already, isn't taken twice
+    if ((int8_t)(push.seq - slave_push.seq) > 0) {
+        memcpy(&slave_push, &push, sizeof(push));
+        slave_push_fresh   = true;
+        slave_push_updated = true;
+        slave_push_polling = false;
+    }
+    // If this gets lost the slave pushes the same state again
+    transport_write(PUT_SLAVE_PUSH_ACK, &push.seq, sizeof(push.seq));
+}
+
+static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t last_update = 0;
+
+    bool okay = true;
+    // Every now and then, check that nothing the slave pushed went missing. This is also what tells whether the slave
+    // is still connected. Once something did, the slave is polled on every scan until its pushes come through again.
+    if (slave_push_polling || timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS) {
+        split_slave_push_t poll;
+        okay = transport_read(GET_SLAVE_MATRIX_DATA, &poll, sizeof(poll));
+        if (okay && poll.checksum == slave_push_checksum(&poll)) {
+            last_update = timer_read32();
+            if (poll.seq != slave_push.seq || memcmp(poll.matrix, slave_push.matrix, sizeof(poll.matrix)) != 0) {
+                // Also catches up with the numbering after either half was reset
+                memcpy(&slave_push, &poll, sizeof(poll));
+                slave_push_updated = true;
+                slave_push_polling = true;
+            }
+        }
+    }
+
+    memcpy(slave_matrix, slave_push.matrix, sizeof(slave_push.matrix));
+    return okay;
+}
+
+static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    split_slave_push_t *poll = &split_shmem->spush;
+    poll->seq                = slave_push_seq;
+    poll->time               = sync_timer_read();
+    memcpy(poll->matrix, slave_matrix, sizeof(poll->matrix));
+#    ifdef ENCODER_ENABLE
+    encoder_state_raw(poll->encoders);
+#    endif  // ENCODER_ENABLE
+    poll->checksum = slave_push_checksum(poll);
+}
+
+// Slave: pushes the matrix and encoders to the master as soon as they change. A state is pushed again until the master
+// has acknowledged it, and only then is the next one pushed, so that none of them get lost on the way.
+static void slave_push_task(matrix_row_t slave_matrix[]) {
+    static split_slave_push_t last_push;
+    static uint16_t           last_try = 0;
+
+    if (!slave_push_acked) {
+        if (timer_elapsed(last_try) >= SERIAL_USART_PUSH_RETRY_MS) {
+            transport_slave_repush();
+            last_try = timer_read();
+        }
+        return;
+    }
+
+    split_slave_push_t push;
+    memcpy(push.matrix, slave_matrix, sizeof(push.matrix));
+#    ifdef ENCODER_ENABLE
+    encoder_state_raw(push.encoders);
+#    endif  // ENCODER_ENABLE
+
+    const size_t state_offset = offsetof(split_slave_push_t, matrix);
+    if (memcmp((uint8_t *)&push + state_offset, (uint8_t *)&last_push + state_offset, offsetof(split_slave_push_t, checksum) - state_offset) == 0) {
+        return;
+    }
+
+    push.seq      = slave_push_seq + 1;
+    push.time     = sync_timer_read();
+    push.checksum = slave_push_checksum(&push);
+    if (transport_slave_push(&push)) {
+        memcpy(&last_push, &push, sizeof(push));
+        slave_push_seq   = push.seq;
+        slave_push_acked = false;
+        last_try         = timer_read();
+    }
+}
+
+static void slave_push_ack_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    if (split_shmem->spush_ack == slave_push_seq) slave_push_acked = true;
+}
+
+uint16_t transactions_slave_event_time(uint16_t not_before, uint16_t not_after) {
+#    ifndef DISABLE_SYNC_TIMER
+    if (slave_push_fresh) {
+        uint16_t age = TIMER_DIFF_16(not_after, slave_push.time);
+        // Ahead of the master, or so far behind that the timers can't be in sync yet
+        if (age > FORCED_SYNC_THROTTLE_MS) age = 0;
+        if (age > TIMER_DIFF_16(not_after, not_before)) age = TIMER_DIFF_16(not_after, not_before);
+        return (not_after - age) | 1;
+    }
+#    endif  // DISABLE_SYNC_TIMER
+    return not_after;
+}
+
+// clang-format off
+#    define TRANSACTIONS_SLAVE_MATRIX_MASTER()           \
+        do {                                             \
+            slave_push_receive();                        \
+            TRANSACTION_HANDLER_MASTER(slave_matrix);    \
+        } while (0)
+#    define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+    [GET_SLAVE_MATRIX_DATA] = trans_target2initiator_initializer(spush), \
+    [PUT_SLAVE_PUSH_ACK]    = trans_initiator2target_initializer_cb(spush_ack, slave_push_ack_callback),
+// clang-format on
+
+#else  // SERIAL_USART_SLAVE_PUSH
+
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t     last_update                    = 0;
     static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0};  // last successfully-read matrix, so we can replicate if there are checksum errors
@@ -135,13 +476,15 @@ static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row
 }
 
 // clang-format off
-#define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
-#define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
-#define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
+#    define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_matrix)
+#    define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
     [GET_SLAVE_MATRIX_CHECKSUM] = trans_target2initiator_initializer(smatrix.checksum), \
     [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
 // clang-format on
 
+#endif  // SERIAL_USART_SLAVE_PUSH
+
 ////////////////////////////////////////////////////
 // Master matrix
 
@@ -175,12 +518,18 @@ static void master_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_ro
 #ifdef ENCODER_ENABLE
 
 static bool encoder_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#    ifdef SERIAL_USART_SLAVE_PUSH
+    // Encoder states only ever move forward with the pushes and polls, taking an older one would undo rotations
+    if (slave_push_updated) encoder_update_raw(slave_push.encoders);
+    return true;
+#    else   // SERIAL_USART_SLAVE_PUSH
     static uint32_t last_update = 0;
     uint8_t         temp_state[NUMBER_OF_ENCODERS];
 
     bool okay = read_if_checksum_mismatch(GET_ENCODERS_CHECKSUM, GET_ENCODERS_DATA, &last_update, temp_state, split_shmem->encoders.state, sizeof(temp_state));
     if (okay) encoder_update_raw(temp_state);
     return okay;
+#    endif  // SERIAL_USART_SLAVE_PUSH
 }
 
 static void encoder_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
@@ -219,7 +568,7 @@ static bool sync_timer_handlers_master(matrix_row_t master_matrix[], matrix_row_
     bool okay = true;
     if (timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS) {
         uint32_t sync_timer = sync_timer_read32() + SYNC_TIMER_OFFSET;
-        okay &= transport_write(PUT_SYNC_TIMER, &sync_timer, sizeof(sync_timer));
+        okay &= transaction_send(PUT_SYNC_TIMER, &sync_timer, sizeof(sync_timer));
         if (okay) {
             last_update = timer_read32();
         }
@@ -340,7 +689,7 @@ static bool mods_handlers_master(matrix_row_t master_matrix[], matrix_row_t slav
 
     bool okay = true;
     if (mods_need_sync) {
-        okay &= transport_write(PUT_MODS, &new_mods, sizeof(new_mods));
+        okay &= transaction_send(PUT_MODS, &new_mods, sizeof(new_mods));
         if (okay) {
             last_update = timer_read32();
         }
@@ -606,6 +955,10 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_ST7565_REGISTRATIONS
 // clang-format on
 
+#ifdef SPLIT_TRANSACTION_BUNDLE
+    [BUNDLED_EXCHANGE] = trans_bidirectional_initializer(bundle_m2s, bundle_s2m),
+#endif  // SPLIT_TRANSACTION_BUNDLE
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
         [PUT_RPC_INFO]  = trans_initiator2target_initializer_cb(rpc_info, slave_rpc_info_callback),
     [PUT_RPC_REQ_DATA]  = trans_initiator2target_initializer(rpc_m2s_buffer),
@@ -615,9 +968,13 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 };
 
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#ifndef SPLIT_TRANSACTION_BUNDLE
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
+#else   // SPLIT_TRANSACTION_BUNDLE
+    TRANSACTIONS_MASTER_MATRIX_MASTER();
+#endif  // SPLIT_TRANSACTION_BUNDLE
     TRANSACTIONS_SYNC_TIMER_MASTER();
     TRANSACTIONS_LAYER_STATE_MASTER();
     TRANSACTIONS_LED_STATE_MASTER();
@@ -629,10 +986,20 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_WPM_MASTER();
     TRANSACTIONS_OLED_MASTER();
     TRANSACTIONS_ST7565_MASTER();
+#ifdef SPLIT_TRANSACTION_BUNDLE
+    // Exchange everything queued up above, then pick up what the slave sent back
+    bundle_frame_seq++;
+    if (!transaction_handler_master(master_matrix, slave_matrix, "bundle", &bundle_handlers_master)) return false;
+    TRANSACTIONS_SLAVE_MATRIX_MASTER();
+    TRANSACTIONS_ENCODERS_MASTER();
+#endif  // SPLIT_TRANSACTION_BUNDLE
     return true;
 }
 
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#ifdef SPLIT_TRANSACTION_BUNDLE
+    TRANSACTION_HANDLER_SLAVE(bundle_receive);
+#endif  // SPLIT_TRANSACTION_BUNDLE
     TRANSACTIONS_SLAVE_MATRIX_SLAVE();
     TRANSACTIONS_MASTER_MATRIX_SLAVE();
     TRANSACTIONS_ENCODERS_SLAVE();
@@ -647,6 +1014,12 @@ void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[
     TRANSACTIONS_WPM_SLAVE();
     TRANSACTIONS_OLED_SLAVE();
     TRANSACTIONS_ST7565_SLAVE();
+#ifdef SPLIT_TRANSACTION_BUNDLE
+    TRANSACTION_HANDLER_SLAVE(bundle_send);
+#endif  // SPLIT_TRANSACTION_BUNDLE
+#ifdef SERIAL_USART_SLAVE_PUSH
+    slave_push_task(slave_matrix);
+#endif  // SERIAL_USART_SLAVE_PUSH
 }
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
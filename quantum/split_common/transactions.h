@@ -46,6 +46,11 @@ extern split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS];
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 
+#ifdef SERIAL_USART_SLAVE_PUSH
+// Time the slave saw the changes of its half that are in the matrix now, kept between not_before and not_after
+uint16_t transactions_slave_event_time(uint16_t not_before, uint16_t not_after);
+#endif  // SERIAL_USART_SLAVE_PUSH
+
 void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback);
 
 bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
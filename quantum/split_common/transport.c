@@ -111,6 +111,12 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
     return true;
 }
 
+#    ifdef SERIAL_USART_SLAVE_PUSH
+bool transport_slave_push(const split_slave_push_t *push) { return soft_serial_target_push(push, sizeof(*push)); }
+void transport_slave_repush(void) { soft_serial_target_repush(); }
+bool transport_master_receive_push(split_slave_push_t *push) { return soft_serial_initiator_receive_push(push, sizeof(*push)); }
+#    endif  // SERIAL_USART_SLAVE_PUSH
+
 #endif  // USE_I2C
 
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) { return transactions_master(master_matrix, slave_matrix); }
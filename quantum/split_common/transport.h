@@ -106,6 +106,33 @@ typedef struct _split_mods_sync_t {
 } split_mods_sync_t;
 #endif  // SPLIT_MODS_ENABLE
 
+#ifdef SERIAL_USART_SLAVE_PUSH
+#    ifdef USE_I2C
+#        error "SERIAL_USART_SLAVE_PUSH requires the serial transport"
+#    endif  // USE_I2C
+#    ifdef SPLIT_TRANSACTION_BUNDLE
+#        error "SERIAL_USART_SLAVE_PUSH cannot be combined with SPLIT_TRANSACTION_BUNDLE"
+#    endif  // SPLIT_TRANSACTION_BUNDLE
+
+// State the slave pushes to the master whenever it changes
+typedef struct __attribute__((packed)) _split_slave_push_t {
+    uint8_t      seq;   // counts the states pushed, for the master to acknowledge
+    uint16_t     time;  // sync_timer_read() when the change was seen
+    matrix_row_t matrix[(MATRIX_ROWS) / 2];
+#    ifdef ENCODER_ENABLE
+    uint8_t encoders[NUMBER_OF_ENCODERS];
+#    endif  // ENCODER_ENABLE
+    uint8_t checksum;  // crc8 over everything before this field
+} split_slave_push_t;
+
+// Sends the slave's state to the master without waiting for a transaction
+bool transport_slave_push(const split_slave_push_t *push);
+// Sends the last pushed state again
+void transport_slave_repush(void);
+// Takes the oldest state pushed by the slave, returns false if there is none
+bool transport_master_receive_push(split_slave_push_t *push);
+#endif  // SERIAL_USART_SLAVE_PUSH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 typedef struct _rpc_sync_info_t {
     int8_t  transaction_id;
@@ -114,6 +141,80 @@ typedef struct _rpc_sync_info_t {
 } rpc_sync_info_t;
 #endif  // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
+#ifdef SPLIT_TRANSACTION_BUNDLE
+// Bundled frames start with this header, followed by sections of split_bundle_section_t and the section's data
+typedef struct __attribute__((packed)) _split_bundle_header_t {
+    uint8_t length;  // bytes of sections after the header
+    uint8_t crc;     // crc8 over everything after this field
+    uint8_t seq;     // sequence number of this frame
+    uint8_t ack;     // sequence number of the last frame received from the other half
+} split_bundle_header_t;
+
+typedef struct __attribute__((packed)) _split_bundle_section_t {
+    int8_t  id;      // transaction ID the data belongs to
+    uint8_t length;  // bytes of data following
+    uint8_t seq;     // changes whenever the data does
+} split_bundle_section_t;
+
+#    define SPLIT_BUNDLE_SECTION(name, type) \
+        split_bundle_section_t name##_section; \
+        type                   name;
+
+// Largest possible frames, only used for their size
+typedef struct __attribute__((packed)) _split_bundle_m2s_max_t {
+    split_bundle_header_t header;
+#    ifdef SPLIT_TRANSPORT_MIRROR
+    SPLIT_BUNDLE_SECTION(mmatrix, split_master_matrix_sync_t)
+#    endif  // SPLIT_TRANSPORT_MIRROR
+#    ifndef DISABLE_SYNC_TIMER
+    SPLIT_BUNDLE_SECTION(sync_timer, uint32_t)
+#    endif  // DISABLE_SYNC_TIMER
+#    if !defined(NO_ACTION_LAYER) && defined(SPLIT_LAYER_STATE_ENABLE)
+    SPLIT_BUNDLE_SECTION(layer_state, layer_state_t)
+    SPLIT_BUNDLE_SECTION(default_layer_state, layer_state_t)
+#    endif  // !defined(NO_ACTION_LAYER) && defined(SPLIT_LAYER_STATE_ENABLE)
+#    ifdef SPLIT_LED_STATE_ENABLE
+    SPLIT_BUNDLE_SECTION(led_state, uint8_t)
+#    endif  // SPLIT_LED_STATE_ENABLE
+#    ifdef SPLIT_MODS_ENABLE
+    SPLIT_BUNDLE_SECTION(mods, split_mods_sync_t)
+#    endif  // SPLIT_MODS_ENABLE
+#    ifdef BACKLIGHT_ENABLE
+    SPLIT_BUNDLE_SECTION(backlight_level, uint8_t)
+#    endif  // BACKLIGHT_ENABLE
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    SPLIT_BUNDLE_SECTION(rgblight_sync, rgblight_syncinfo_t)
+#    endif  // defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+#    if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
+    SPLIT_BUNDLE_SECTION(led_matrix_sync, led_matrix_sync_t)
+#    endif  // defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
+#    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+    SPLIT_BUNDLE_SECTION(rgb_matrix_sync, rgb_matrix_sync_t)
+#    endif  // defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+#    if defined(WPM_ENABLE) && defined(SPLIT_WPM_ENABLE)
+    SPLIT_BUNDLE_SECTION(current_wpm, uint8_t)
+#    endif  // defined(WPM_ENABLE) && defined(SPLIT_WPM_ENABLE)
+#    if defined(OLED_ENABLE) && defined(SPLIT_OLED_ENABLE)
+    SPLIT_BUNDLE_SECTION(current_oled_state, uint8_t)
+#    endif  // defined(OLED_ENABLE) && defined(SPLIT_OLED_ENABLE)
+#    if defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
+    SPLIT_BUNDLE_SECTION(current_st7565_state, uint8_t)
+#    endif  // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
+} split_bundle_m2s_max_t;
+
+typedef struct __attribute__((packed)) _split_bundle_s2m_max_t {
+    split_bundle_header_t header;
+    split_bundle_section_t smatrix_section;
+    matrix_row_t           smatrix[(MATRIX_ROWS) / 2];
+#    ifdef ENCODER_ENABLE
+    split_bundle_section_t encoders_section;
+    uint8_t                encoders[NUMBER_OF_ENCODERS];
+#    endif  // ENCODER_ENABLE
+} split_bundle_s2m_max_t;
+
+#    undef SPLIT_BUNDLE_SECTION
+#endif  // SPLIT_TRANSACTION_BUNDLE
+
 typedef struct _split_shared_memory_t {
 #ifdef USE_I2C
     int8_t transaction_id;
@@ -121,6 +222,11 @@ typedef struct _split_shared_memory_t {
 
     split_slave_matrix_sync_t smatrix;
 
+#ifdef SERIAL_USART_SLAVE_PUSH
+    split_slave_push_t spush;      // the slave's current state, for the master to poll
+    uint8_t            spush_ack;  // the last push the master took
+#endif  // SERIAL_USART_SLAVE_PUSH
+
 #ifdef SPLIT_TRANSPORT_MIRROR
     split_master_matrix_sync_t mmatrix;
 #endif  // SPLIT_TRANSPORT_MIRROR
@@ -173,6 +279,11 @@ typedef struct _split_shared_memory_t {
     uint8_t current_st7565_state;
 #endif  // ST7565_ENABLE(OLED_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_TRANSACTION_BUNDLE
+    uint8_t bundle_m2s[sizeof(split_bundle_m2s_max_t)];
+    uint8_t bundle_s2m[sizeof(split_bundle_s2m_max_t)];
+#endif  // SPLIT_TRANSACTION_BUNDLE
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     rpc_sync_info_t rpc_info;
     uint8_t         rpc_m2s_buffer[RPC_M2S_BUFFER_SIZE];
@@ -0,0 +1,155 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include <timer.h>
+#include <task_profile.h>
+#include "debug.h"
+
+#if TASK_PROFILE_HISTOGRAM_BUCKETS < 1
+#    error "TASK_PROFILE_HISTOGRAM_BUCKETS must be at least 1"
+#endif
+
+typedef struct {
+    uint32_t total_us;
+    uint16_t min_us;
+    uint16_t max_us;
+    uint32_t histogram[TASK_PROFILE_HISTOGRAM_BUCKETS];
+} task_profile_entry_t;
+
+static task_profile_entry_t entries[TASK_PROFILE_COUNT];
+static bool                 initialized = false;
+
+#if TASK_PROFILE_PRINT_INTERVAL > 0 && defined(CONSOLE_ENABLE)
+static uint32_t last_print = 0;
+#endif
+
+void task_profile_reset(void) {
+    memset(entries, 0, sizeof(entries));
+    for (uint8_t i = 0; i < TASK_PROFILE_COUNT; ++i) {
+        entries[i].min_us = UINT16_MAX;
+    }
+    initialized = true;
+}
+
+static uint32_t entry_calls(const task_profile_entry_t *entry) {
+    uint32_t calls = 0;
+    for (uint8_t i = 0; i < TASK_PROFILE_HISTOGRAM_BUCKETS; ++i) {
+        calls += entry->histogram[i];
+    }
+    return calls;
+}
+
+void task_profile_record(task_profile_task_t task, uint32_t elapsed_us) {
+    if (task >= TASK_PROFILE_COUNT) {
+        return;
+    }
+    if (!initialized) {
+        task_profile_reset();
+    }
+
+    task_profile_entry_t *entry = &entries[task];
+
+    uint8_t  bucket = 0;
+    uint32_t limit  = TASK_PROFILE_HISTOGRAM_BASE;
+    while (bucket < TASK_PROFILE_HISTOGRAM_BUCKETS - 1 && elapsed_us >= limit) {
+        bucket++;
+        limit <<= 1;
+    }
+
+    // Halve everything instead of overflowing, which keeps the averages and the shape of the histogram
+    if (entry->total_us > UINT32_MAX - elapsed_us || entry->histogram[bucket] == UINT32_MAX) {
+        entry->total_us /= 2;
+        for (uint8_t i = 0; i < TASK_PROFILE_HISTOGRAM_BUCKETS; ++i) {
+            entry->histogram[i] /= 2;
+        }
+    }
+
+    entry->total_us += elapsed_us;
+    entry->histogram[bucket]++;
+
+    uint16_t clamped = elapsed_us > UINT16_MAX ? UINT16_MAX : elapsed_us;
+    if (clamped < entry->min_us) entry->min_us = clamped;
+    if (clamped > entry->max_us) entry->max_us = clamped;
+}
+
+bool task_profile_get_stats(uint8_t task, task_profile_stats_t *stats) {
+    if (task >= TASK_PROFILE_COUNT) {
+        return false;
+    }
+    if (!initialized) {
+        task_profile_reset();
+    }
+
+    const task_profile_entry_t *entry = &entries[task];
+
+    stats->calls = entry_calls(entry);
+    if (stats->calls > 0) {
+        uint32_t avg  = entry->total_us / stats->calls;
+        stats->min_us = entry->min_us;
+        stats->avg_us = avg > UINT16_MAX ? UINT16_MAX : avg;
+        stats->max_us = entry->max_us;
+    } else {
+        stats->min_us = stats->avg_us = stats->max_us = 0;
+    }
+    memcpy(stats->histogram, entry->histogram, sizeof(stats->histogram));
+    return true;
+}
+
+#ifdef CONSOLE_ENABLE
+static const char *const task_names[TASK_PROFILE_COUNT] = {
+    [TASK_PROFILE_KEYBOARD_TASK]      = "keyboard_task",
+    [TASK_PROFILE_MATRIX_SCAN]        = "matrix_scan",
+    [TASK_PROFILE_SPLIT_TRANSACTIONS] = "split_transactions",
+    [TASK_PROFILE_ACTION_EXEC]        = "action_exec",
+    [TASK_PROFILE_RGBLIGHT]           = "rgblight",
+    [TASK_PROFILE_LED_MATRIX]         = "led_matrix",
+    [TASK_PROFILE_RGB_MATRIX]         = "rgb_matrix",
+    [TASK_PROFILE_BACKLIGHT]          = "backlight",
+    [TASK_PROFILE_ENCODER]            = "encoder",
+    [TASK_PROFILE_OLED]               = "oled",
+    [TASK_PROFILE_ST7565]             = "st7565",
+    [TASK_PROFILE_MOUSEKEY]           = "mousekey",
+    [TASK_PROFILE_PS2_MOUSE]          = "ps2_mouse",
+    [TASK_PROFILE_POINTING_DEVICE]    = "pointing_device",
+    [TASK_PROFILE_MIDI]               = "midi",
+    [TASK_PROFILE_JOYSTICK]           = "joystick",
+    [TASK_PROFILE_DIGITIZER]          = "digitizer",
+    [TASK_PROFILE_EEPROM]             = "eeprom",
+    [TASK_PROFILE_DEFERRED_EXEC]      = "deferred_exec",
+    [TASK_PROFILE_HOUSEKEEPING]       = "housekeeping",
+};
+#endif
+
+void task_profile_print(void) {
+#ifdef CONSOLE_ENABLE
+    task_profile_stats_t stats;
+    for (uint8_t task = 0; task < TASK_PROFILE_COUNT; ++task) {
+        task_profile_get_stats(task, &stats);
+        if (stats.calls == 0) {
+            continue;
+        }
+        dprintf("%-18s %8lu calls, %5u/%5u/%5u us min/avg/max:", task_names[task], (unsigned long)stats.calls, stats.min_us, stats.avg_us, stats.max_us);
+        for (uint8_t i = 0; i < TASK_PROFILE_HISTOGRAM_BUCKETS; ++i) {
+            dprintf(" %lu", (unsigned long)stats.histogram[i]);
+        }
+        dprintf("\n");
+    }
+#endif
+}
+
+void task_profile_task(void) {
+#if TASK_PROFILE_PRINT_INTERVAL > 0 && defined(CONSOLE_ENABLE)
+    uint32_t now = timer_read32();
+    if (TIMER_DIFF_32(now, last_print) >= TASK_PROFILE_PRINT_INTERVAL) {
+        if (debug_enable) {
+            task_profile_stats_t scans;
+            task_profile_get_stats(TASK_PROFILE_KEYBOARD_TASK, &scans);
+            dprintf("task profile: %lu scans/s\n", (unsigned long)(scans.calls * 1000 / TIMER_DIFF_32(now, last_print)));
+            task_profile_print();
+            task_profile_reset();
+        }
+        last_print = now;
+    }
+#endif
+}
@@ -0,0 +1,94 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Number of histogram buckets kept for each task. Bucket 0 counts calls shorter than TASK_PROFILE_HISTOGRAM_BASE
+// microseconds, each following bucket covers twice the range of the one before, and the last one counts everything else.
+#ifndef TASK_PROFILE_HISTOGRAM_BUCKETS
+#    define TASK_PROFILE_HISTOGRAM_BUCKETS 8
+#endif
+
+// Upper bound of the first histogram bucket, in microseconds.
+#ifndef TASK_PROFILE_HISTOGRAM_BASE
+#    define TASK_PROFILE_HISTOGRAM_BASE 16
+#endif
+
+// How often the statistics are printed to the console and started over, in milliseconds. Zero disables printing.
+#ifndef TASK_PROFILE_PRINT_INTERVAL
+#    define TASK_PROFILE_PRINT_INTERVAL 5000
+#endif
+
+// The profiled tasks. The values are reported over raw HID, so only ever append to this list.
+typedef enum {
+    TASK_PROFILE_KEYBOARD_TASK,
+    TASK_PROFILE_MATRIX_SCAN,
+    TASK_PROFILE_SPLIT_TRANSACTIONS,
+    TASK_PROFILE_ACTION_EXEC,
+    TASK_PROFILE_RGBLIGHT,
+    TASK_PROFILE_LED_MATRIX,
+    TASK_PROFILE_RGB_MATRIX,
+    TASK_PROFILE_BACKLIGHT,
+    TASK_PROFILE_ENCODER,
+    TASK_PROFILE_OLED,
+    TASK_PROFILE_ST7565,
+    TASK_PROFILE_MOUSEKEY,
+    TASK_PROFILE_PS2_MOUSE,
+    TASK_PROFILE_POINTING_DEVICE,
+    TASK_PROFILE_MIDI,
+    TASK_PROFILE_JOYSTICK,
+    TASK_PROFILE_DIGITIZER,
+    TASK_PROFILE_EEPROM,
+    TASK_PROFILE_DEFERRED_EXEC,
+    TASK_PROFILE_HOUSEKEEPING,
+    TASK_PROFILE_COUNT
+} task_profile_task_t;
+
+typedef struct {
+    uint32_t calls;
+    uint16_t min_us;
+    uint16_t avg_us;
+    uint16_t max_us;
+    uint32_t histogram[TASK_PROFILE_HISTOGRAM_BUCKETS];
+} task_profile_stats_t;
+
+#ifdef TASK_PROFILE_ENABLE
+// Times everything between the two macros as a call of the given task. Both have to be in the same scope.
+#    define TASK_PROFILE_BEGIN(task) const uint32_t task##_start = task_profile_timer_read()
+#    define TASK_PROFILE_END(task) task_profile_record(task, task_profile_timer_elapsed_us(task##_start))
+#else
+#    define TASK_PROFILE_BEGIN(task)
+#    define TASK_PROFILE_END(task)
+#endif
+
+// Adds a single call of a task to its statistics.
+//  -- Parameter task: the task that ran
+//  -- Parameter elapsed_us: how long it ran for, in microseconds
+void task_profile_record(task_profile_task_t task, uint32_t elapsed_us);
+
+// Retrieves the statistics of a task since they were last reset.
+//  -- Parameter task: the task to look up
+//  -- Parameter stats: receives the statistics
+//  -- Returns false if the task is not valid
+bool task_profile_get_stats(uint8_t task, task_profile_stats_t *stats);
+
+// Starts all statistics over.
+void task_profile_reset(void);
+
+// Prints the statistics of every task that ran to the console.
+void task_profile_print(void);
+
+// Platform-specific free-running timer with sub-millisecond resolution where available.
+//  -- Returns the current time, in platform-specific units
+uint32_t task_profile_timer_read(void);
+
+// Platform-specific conversion of the time since a task_profile_timer_read() call.
+//  -- Parameter start: the time the task started at
+//  -- Returns the microseconds elapsed since then
+uint32_t task_profile_timer_elapsed_us(uint32_t start);
+
+// Forward declaration for keyboard_task() in order to print the statistics periodically. Should not be invoked by keyboard/user code.
+void task_profile_task(void);
@@ -0,0 +1,9 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "timer.h"
+#include "task_profile.h"
+
+// Platforms without a finer timer fall back to the millisecond one
+__attribute__((weak)) uint32_t task_profile_timer_read(void) { return timer_read32(); }
+__attribute__((weak)) uint32_t task_profile_timer_elapsed_us(uint32_t start) { return TIMER_DIFF_32(timer_read32(), start) * 1000; }
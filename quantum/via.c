@@ -59,6 +59,10 @@ void via_qmk_rgblight_set_value(uint8_t *data);
 void via_qmk_rgblight_get_value(uint8_t *data);
 #endif
 
+#if defined(TASK_PROFILE_ENABLE)
+void via_task_profile_get_value(uint8_t *data);
+#endif
+
 // Can be called in an overriding via_init_kb() to test if keyboard level code usage of
 // EEPROM is invalid and use/save defaults.
 bool via_eeprom_is_valid(void) {
@@ -113,6 +117,10 @@ void eeconfig_init_via(void) {
     dynamic_keymap_reset();
     // This resets the macros in EEPROM to nothing.
     dynamic_keymap_macro_reset();
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+    // Make sure the defaults have reached EEPROM before marking it valid
+    dynamic_keymap_flush();
+#endif
     // Save the magic number last, in case saving was interrupted
     via_eeprom_set_valid(true);
 }
@@ -241,6 +249,12 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
 #endif
                     break;
                 }
+#ifdef TASK_PROFILE_ENABLE
+                case id_task_profile: {
+                    via_task_profile_get_value(command_data);
+                    break;
+                }
+#endif
                 default: {
                     raw_hid_receive_kb(data, length);
                     break;
@@ -255,6 +269,12 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
                     via_set_layout_options(value);
                     break;
                 }
+#ifdef TASK_PROFILE_ENABLE
+                case id_task_profile: {
+                    task_profile_reset();
+                    break;
+                }
+#endif
                 default: {
                     raw_hid_receive_kb(data, length);
                     break;
@@ -491,3 +511,39 @@ void via_qmk_rgblight_set_value(uint8_t *data) {
 }
 
 #endif  // #if defined(VIA_QMK_RGBLIGHT_ENABLE)
+
+#if defined(TASK_PROFILE_ENABLE)
+
+// Per-task timing statistics, all values big-endian.
+// Request:  data[1] = task, data[2] = first histogram bucket
+// Response: data[3] = number of tasks, data[4] = number of buckets, data[5..6] = upper bound of the first bucket in us,
+//           data[7..10] = calls, data[11..16] = min/avg/max in us, data[17..28] = three histogram buckets from data[2]
+void via_task_profile_get_value(uint8_t *data) {
+    task_profile_stats_t stats  = {0};
+    uint8_t              bucket = data[2];
+    task_profile_get_stats(data[1], &stats);
+
+    data[3]  = TASK_PROFILE_COUNT;
+    data[4]  = TASK_PROFILE_HISTOGRAM_BUCKETS;
+    data[5]  = (TASK_PROFILE_HISTOGRAM_BASE >> 8) & 0xFF;
+    data[6]  = TASK_PROFILE_HISTOGRAM_BASE & 0xFF;
+    data[7]  = (stats.calls >> 24) & 0xFF;
+    data[8]  = (stats.calls >> 16) & 0xFF;
+    data[9]  = (stats.calls >> 8) & 0xFF;
+    data[10] = stats.calls & 0xFF;
+    data[11] = stats.min_us >> 8;
+    data[12] = stats.min_us & 0xFF;
+    data[13] = stats.avg_us >> 8;
+    data[14] = stats.avg_us & 0xFF;
+    data[15] = stats.max_us >> 8;
+    data[16] = stats.max_us & 0xFF;
+    for (uint8_t i = 0; i < 3; i++, bucket++) {
+        uint32_t value = bucket < TASK_PROFILE_HISTOGRAM_BUCKETS ? stats.histogram[bucket] : 0;
+        data[17 + i * 4] = (value >> 24) & 0xFF;
+        data[18 + i * 4] = (value >> 16) & 0xFF;
+        data[19 + i * 4] = (value >> 8) & 0xFF;
+        data[20 + i * 4] = value & 0xFF;
+    }
+}
+
+#endif  // #if defined(TASK_PROFILE_ENABLE)
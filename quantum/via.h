@@ -84,7 +84,8 @@ enum via_command_id {
 enum via_keyboard_value_id {
     id_uptime              = 0x01,  //
     id_layout_options      = 0x02,
-    id_switch_matrix_state = 0x03
+    id_switch_matrix_state = 0x03,
+    id_task_profile        = 0x04
 };
 
 enum via_lighting_value {
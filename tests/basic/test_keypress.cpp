@@ -64,21 +64,22 @@ TEST_F(KeyPress, CorrectKeysAreReportedWhenTwoKeysArePressed) {
 
     key_b.press();
     key_c.press();
-    // Note that QMK only processes one key at a time
-    // See issue #1476 for more information
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code)));
-    keyboard_task();
-
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code, key_c.report_code)));
+    // Note that all changed keys are processed in the same scan, in matrix order
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code, key_c.report_code)));
+    }
     keyboard_task();
 
     key_b.release();
     key_c.release();
     // Note that the first key released is the first one in the matrix order
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_c.report_code)));
-    keyboard_task();
-
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_c.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
     keyboard_task();
 }
 
@@ -94,9 +95,11 @@ TEST_F(KeyPress, LeftShiftIsReportedCorrectly) {
 
     // Unfortunately modifiers are also processed in the wrong order
     // See issue #1476 for more information
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code)));
-    keyboard_task();
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_lsft.report_code)));
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_lsft.report_code)));
+    }
     keyboard_task();
 
     key_a.release();
@@ -120,19 +123,21 @@ TEST_F(KeyPress, PressLeftShiftAndControl) {
 
     // Unfortunately modifiers are also processed in the wrong order
     // See issue #1476 for more information
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code)));
-    keyboard_task();
-
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code, key_lctrl.report_code)));
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code, key_lctrl.report_code)));
+    }
     keyboard_task();
 
     key_lsft.release();
     key_lctrl.release();
 
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lctrl.report_code)));
-    keyboard_task();
-
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lctrl.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
     keyboard_task();
 }
 
@@ -147,19 +152,21 @@ TEST_F(KeyPress, LeftAndRightShiftCanBePressedAtTheSameTime) {
     key_rsft.press();
     // Unfortunately modifiers are also processed in the wrong order
     // See issue #1476 for more information
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code)));
-    keyboard_task();
-
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code, key_rsft.report_code)));
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code, key_rsft.report_code)));
+    }
     keyboard_task();
 
     key_lsft.release();
     key_rsft.release();
 
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_rsft.report_code)));
-    keyboard_task();
-
-    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_rsft.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
     keyboard_task();
 }
 
@@ -0,0 +1,41 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+class BenchBasic : public BenchmarkFixture {};
+
+TEST_F(BenchBasic, Typing) {
+    auto keys = letter_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, typing_trace(keys.size(), 2000, 60, 60, 90, 1));
+    report("basic typing", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_EQ(result.latency_max, 0);
+}
+
+TEST_F(BenchBasic, FastRollover) {
+    auto keys = letter_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, typing_trace(keys.size(), 2000, 15, 10, 120, 2));
+    report("basic rollover", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_EQ(result.latency_max, 0);
+}
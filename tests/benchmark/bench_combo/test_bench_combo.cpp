@@ -0,0 +1,62 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+const uint16_t PROGMEM as_combo[]  = {KC_A, KC_S, COMBO_END};
+const uint16_t PROGMEM df_combo[]  = {KC_D, KC_F, COMBO_END};
+const uint16_t PROGMEM jk_combo[]  = {KC_J, KC_K, COMBO_END};
+const uint16_t PROGMEM kl_combo[]  = {KC_K, KC_L, COMBO_END};
+const uint16_t PROGMEM qw_combo[]  = {KC_Q, KC_W, COMBO_END};
+const uint16_t PROGMEM er_combo[]  = {KC_E, KC_R, COMBO_END};
+const uint16_t PROGMEM uio_combo[] = {KC_U, KC_I, KC_O, COMBO_END};
+const uint16_t PROGMEM xcv_combo[] = {KC_X, KC_C, KC_V, COMBO_END};
+
+combo_t key_combos[COMBO_COUNT] = {
+    COMBO(as_combo, KC_ESC), COMBO(df_combo, KC_TAB), COMBO(jk_combo, KC_ENT), COMBO(kl_combo, KC_BSPC), COMBO(qw_combo, KC_1), COMBO(er_combo, KC_2), COMBO(uio_combo, KC_3), COMBO(xcv_combo, KC_4),
+};
+
+class BenchCombo : public BenchmarkFixture {};
+
+TEST_F(BenchCombo, Typing) {
+    auto keys = letter_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, typing_trace(keys.size(), 2000, 60, 60, 90, 1));
+    report("combo typing", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_LE(result.latency_max, COMBO_TERM + 1);
+}
+
+TEST_F(BenchCombo, Chords) {
+    auto keys = letter_keys();
+    set_keymap(keys);
+
+    /* A+S, then U+I+O, interleaved with single taps */
+    Trace chords = {
+        {100, KC_A - KC_A, true}, {0, KC_S - KC_A, true}, {60, KC_A - KC_A, false}, {0, KC_S - KC_A, false}, {100, KC_U - KC_A, true}, {5, KC_I - KC_A, true}, {5, KC_O - KC_A, true}, {60, KC_U - KC_A, false}, {0, KC_I - KC_A, false}, {0, KC_O - KC_A, false}, {100, KC_T - KC_A, true}, {60, KC_T - KC_A, false},
+    };
+    Trace trace;
+    append_trace(trace, chords, 200);
+
+    auto result = replay(keys, trace);
+    report("combo chords", result);
+    EXPECT_EQ(result.unreported, 0);
+    /* A combo fires a combo term after its last key, which is up to 12 ms after the first with the scans in between */
+    EXPECT_LE(result.latency_max, COMBO_TERM + 13);
+}
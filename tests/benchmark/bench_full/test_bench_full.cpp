@@ -0,0 +1,38 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+class BenchFull : public BenchmarkFixture {};
+
+TEST_F(BenchFull, Typing) {
+    auto keys = letter_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, typing_trace(keys.size(), 5000, 60, 60, 90, 1));
+    report("full typing", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_LE(result.latency_max, AUTO_SHIFT_TIMEOUT + 1);
+}
+
+TEST_F(BenchFull, ProcessRecordQuantum) {
+    auto key = KeymapKey(0, 0, 0, KC_F24);
+    set_keymap({key});
+
+    std::cout << "[ BENCHMARK] full process_record_quantum: " << time_process_record(key, 50000) << " ns per event" << std::endl;
+}
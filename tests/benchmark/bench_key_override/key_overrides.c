@@ -0,0 +1,34 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const key_override_t delete_key_override = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+const key_override_t home_key_override   = ko_make_basic(MOD_MASK_CTRL, KC_A, KC_HOME);
+const key_override_t end_key_override    = ko_make_basic(MOD_MASK_CTRL, KC_E, KC_END);
+const key_override_t up_key_override     = ko_make_basic(MOD_MASK_CTRL, KC_P, KC_UP);
+const key_override_t down_key_override   = ko_make_basic(MOD_MASK_CTRL, KC_N, KC_DOWN);
+
+// clang-format off
+const key_override_t **key_overrides = (const key_override_t *[]){
+    &delete_key_override,
+    &home_key_override,
+    &end_key_override,
+    &up_key_override,
+    &down_key_override,
+    NULL
+};
+// clang-format on
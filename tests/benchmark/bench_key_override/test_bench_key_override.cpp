@@ -0,0 +1,58 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+class BenchKeyOverride : public BenchmarkFixture {
+   protected:
+    /* The letters, followed by backspace, shift and control */
+    std::vector<KeymapKey> key_override_keys(void) {
+        auto keys = letter_keys();
+        keys.push_back(KeymapKey(0, 6, 2, KC_BSPC));
+        keys.push_back(KeymapKey(0, 7, 2, KC_LSFT));
+        keys.push_back(KeymapKey(0, 8, 2, KC_LCTL));
+        return keys;
+    }
+};
+
+TEST_F(BenchKeyOverride, Typing) {
+    auto keys = key_override_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, typing_trace(26, 2000, 60, 60, 90, 1));
+    report("key override typing", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_EQ(result.latency_max, 0);
+}
+
+TEST_F(BenchKeyOverride, Overrides) {
+    auto keys = key_override_keys();
+    set_keymap(keys);
+
+    /* Shift+Backspace, then Ctrl held over A, E, P and N */
+    Trace overrides = {
+        {100, 27, true}, {20, 26, true}, {60, 26, false}, {20, 27, false}, {100, 28, true}, {40, KC_A - KC_A, true}, {40, KC_A - KC_A, false}, {40, KC_E - KC_A, true}, {40, KC_E - KC_A, false}, {40, KC_P - KC_A, true}, {40, KC_P - KC_A, false}, {40, KC_N - KC_A, true}, {40, KC_N - KC_A, false}, {40, 28, false},
+    };
+    Trace trace;
+    append_trace(trace, overrides, 200);
+
+    auto result = replay(keys, trace);
+    report("key override overrides", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_EQ(result.latency_max, 0);
+}
@@ -0,0 +1,36 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+LEADER_EXTERNS();
+
+void housekeeping_task_user(void) {
+    LEADER_DICTIONARY() {
+        leading = false;
+        leader_end();
+
+        SEQ_ONE_KEY(KC_F) {
+            tap_code(KC_ESC);
+        }
+        SEQ_TWO_KEYS(KC_D, KC_D) {
+            tap_code(KC_DEL);
+        }
+        SEQ_THREE_KEYS(KC_A, KC_S, KC_D) {
+            tap_code(KC_ENT);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+class BenchLeader : public BenchmarkFixture {
+   protected:
+    /* The letters, followed by the leader key */
+    std::vector<KeymapKey> leader_keys(void) {
+        auto keys = letter_keys();
+        keys.push_back(KeymapKey(0, 6, 2, KC_LEAD));
+        return keys;
+    }
+};
+
+TEST_F(BenchLeader, Typing) {
+    auto keys = leader_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, typing_trace(26, 2000, 60, 60, 90, 1));
+    report("leader typing", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_EQ(result.latency_max, 0);
+}
+
+TEST_F(BenchLeader, Sequences) {
+    auto keys = leader_keys();
+    set_keymap(keys);
+
+    /* Each sequence ends in a tap once the leader times out, then some regular typing */
+    Trace sequences = {
+        {100, 26, true}, {40, 26, false}, {40, KC_F - KC_A, true}, {40, KC_F - KC_A, false}, {400, 26, true}, {40, 26, false}, {40, KC_D - KC_A, true}, {40, KC_D - KC_A, false}, {40, KC_D - KC_A, true}, {40, KC_D - KC_A, false}, {400, 26, true}, {40, 26, false}, {40, KC_A - KC_A, true}, {40, KC_A - KC_A, false}, {40, KC_S - KC_A, true}, {40, KC_S - KC_A, false}, {40, KC_D - KC_A, true}, {40, KC_D - KC_A, false}, {400, KC_H - KC_A, true}, {40, KC_H - KC_A, false},
+    };
+    Trace trace;
+    append_trace(trace, sequences, 200);
+
+    auto result = replay(keys, trace);
+    report("leader sequences", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_LE(result.latency_max, 3 * 80 + LEADER_TIMEOUT + 1);
+}
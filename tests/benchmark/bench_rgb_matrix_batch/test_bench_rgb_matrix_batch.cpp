@@ -0,0 +1,108 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "lib/lib8tion/lib8tion.h"
+#include "color.h"
+}
+
+#define BENCHMARK_LEDS 84
+#define BENCHMARK_FRAMES 20000
+
+// Times a function over many frames, returning nanoseconds per LED
+template <typename F>
+static double time_per_led(F frame) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCHMARK_FRAMES; i++) {
+        frame(i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / BENCHMARK_FRAMES / BENCHMARK_LEDS;
+}
+
+// Compares the batch functions with calling the scalar ones on each LED, as the effects did before
+TEST(BenchRgbMatrixBatch, Conversion) {
+    HSV      hsv[BENCHMARK_LEDS];
+    RGB      rgb[BENCHMARK_LEDS];
+    uint8_t  channels[BENCHMARK_LEDS * 3];
+    uint32_t sink = 0;
+
+    // A gradient across the keyboard, as from the cycle and spiral effects, where neighbouring keys often share a hue
+    auto gradient = [&](int frame) {
+        for (uint8_t i = 0; i < BENCHMARK_LEDS; i++) {
+            hsv[i].h = frame + (i / 14) * 16 + (i % 14) * 2;
+            hsv[i].s = 255;
+            hsv[i].v = 200;
+        }
+    };
+    // Every LED a different color, as from the rainbow and reactive effects
+    auto scattered = [&](int frame) {
+        for (uint8_t i = 0; i < BENCHMARK_LEDS; i++) {
+            hsv[i].h = frame + i * 37;
+            hsv[i].s = 255 - i;
+            hsv[i].v = 128 + i;
+        }
+    };
+
+    for (auto &[name, fill] : {std::make_pair("gradient", std::function<void(int)>(gradient)), std::make_pair("scattered", std::function<void(int)>(scattered))}) {
+        double scalar = time_per_led([&](int frame) {
+            fill(frame);
+            for (uint8_t i = 0; i < BENCHMARK_LEDS; i++) {
+                rgb[i] = hsv_to_rgb(hsv[i]);
+            }
+            sink += rgb[frame % BENCHMARK_LEDS].r;
+        });
+        double batch = time_per_led([&](int frame) {
+            fill(frame);
+            hsv_to_rgb_buffer(hsv, rgb, BENCHMARK_LEDS, hsv_to_rgb);
+            sink += rgb[frame % BENCHMARK_LEDS].r;
+        });
+        std::cout << "[ BENCHMARK] hsv_to_rgb, " << name << ": " << scalar << "ns/LED scalar, " << batch << "ns/LED batch" << std::endl;
+    }
+
+    double scalar = time_per_led([&](int frame) {
+        for (uint16_t i = 0; i < sizeof(channels); i++) channels[i] = frame + i;
+        for (uint16_t i = 0; i < sizeof(channels); i++) channels[i] = scale8(channels[i], frame);
+        sink += channels[frame % sizeof(channels)];
+    });
+    double batch = time_per_led([&](int frame) {
+        for (uint16_t i = 0; i < sizeof(channels); i++) channels[i] = frame + i;
+        scale8_buffer(channels, sizeof(channels), frame);
+        sink += channels[frame % sizeof(channels)];
+    });
+    std::cout << "[ BENCHMARK] scale8: " << scalar << "ns/LED scalar, " << batch << "ns/LED batch" << std::endl;
+
+    scalar = time_per_led([&](int frame) {
+        for (uint16_t i = 0; i < sizeof(channels); i++) channels[i] = frame + i;
+        for (uint16_t i = 0; i < sizeof(channels); i++) channels[i] = qadd8(channels[i], frame);
+        sink += channels[frame % sizeof(channels)];
+    });
+    batch = time_per_led([&](int frame) {
+        for (uint16_t i = 0; i < sizeof(channels); i++) channels[i] = frame + i;
+        qadd8_buffer(channels, sizeof(channels), frame);
+        sink += channels[frame % sizeof(channels)];
+    });
+    std::cout << "[ BENCHMARK] qadd8: " << scalar << "ns/LED scalar, " << batch << "ns/LED batch" << std::endl;
+
+    // Keeps the results alive
+    EXPECT_NE(sink, 0xFFFFFFFF);
+}
@@ -0,0 +1,47 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+// Built once for each of the transports set up in the folders next to this file, which name it with BENCH_SPLIT_NAME
+
+#ifndef BENCH_SPLIT_LATENCY_MAX
+#    define BENCH_SPLIT_LATENCY_MAX 0
+#endif
+
+class BenchSplit : public BenchmarkFixture {};
+
+TEST_F(BenchSplit, Typing) {
+    auto keys = letter_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, typing_trace(keys.size(), 2000, 60, 60, 90, 1));
+    report("split " BENCH_SPLIT_NAME " typing", result);
+    report_split("split " BENCH_SPLIT_NAME " typing");
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_LE(result.latency_max, BENCH_SPLIT_LATENCY_MAX);
+}
+
+TEST_F(BenchSplit, Idle) {
+    auto keys = letter_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, Trace(), 5000);
+    report_split("split " BENCH_SPLIT_NAME " idle");
+    EXPECT_EQ(result.reports, 0);
+}
@@ -0,0 +1,57 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+class BenchTapDance : public BenchmarkFixture {
+   protected:
+    /* The letters, followed by both tap dances */
+    std::vector<KeymapKey> tap_dance_keys(void) {
+        auto keys = letter_keys(20);
+        keys.push_back(KeymapKey(0, 0, 2, TD(0)));
+        keys.push_back(KeymapKey(0, 1, 2, TD(1)));
+        return keys;
+    }
+};
+
+TEST_F(BenchTapDance, Typing) {
+    auto keys = tap_dance_keys();
+    set_keymap(keys);
+
+    auto result = replay(keys, typing_trace(keys.size(), 2000, 60, 60, 90, 1));
+    report("tap dance typing", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_LE(result.latency_max, TAPPING_TERM + 1);
+}
+
+TEST_F(BenchTapDance, DoubleTaps) {
+    auto keys = tap_dance_keys();
+    set_keymap(keys);
+
+    /* Double tap, single tap left to time out, then a double tap interrupted by a letter */
+    Trace taps = {
+        {100, 20, true}, {40, 20, false}, {40, 20, true}, {40, 20, false}, {300, 21, true}, {40, 21, false}, {300, 21, true}, {40, 21, false}, {40, 21, true}, {40, 21, false}, {20, 0, true}, {40, 0, false},
+    };
+    Trace trace;
+    append_trace(trace, taps, 200);
+
+    auto result = replay(keys, trace);
+    report("tap dance double taps", result);
+    EXPECT_EQ(result.unreported, 0);
+    EXPECT_LE(result.latency_max, TAPPING_TERM + 1);
+}
@@ -0,0 +1,141 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+
+extern "C" {
+extern combo_t key_combos[COMBO_COUNT];
+}
+
+namespace {
+
+const uint16_t PAIR_COMBOS = 450;
+const uint8_t  KEY_COUNT   = MATRIX_ROWS * MATRIX_COLS;
+
+/* Key indices of each combo, into letter_keys(KEY_COUNT) */
+std::vector<std::vector<uint8_t>> combo_key_indices;
+uint16_t                          combo_keys[COMBO_COUNT][4];
+std::vector<uint16_t>             fired_combos;
+
+/* 450 two key combos and 50 three key combos over every key of the matrix, chosen at random but always the same. */
+bool define_combos(void) {
+    std::mt19937                     rng(500);
+    std::vector<std::vector<uint8_t>> pairs;
+    for (uint8_t a = 0; a < KEY_COUNT; ++a) {
+        for (uint8_t b = a + 1; b < KEY_COUNT; ++b) {
+            pairs.push_back({a, b});
+        }
+    }
+    std::shuffle(pairs.begin(), pairs.end(), rng);
+    combo_key_indices.assign(pairs.begin(), pairs.begin() + PAIR_COMBOS);
+
+    std::set<std::vector<uint8_t>> triples;
+    while (triples.size() < COMBO_COUNT - PAIR_COMBOS) {
+        std::vector<uint8_t> triple = {(uint8_t)(rng() % KEY_COUNT), (uint8_t)(rng() % KEY_COUNT), (uint8_t)(rng() % KEY_COUNT)};
+        std::sort(triple.begin(), triple.end());
+        if (triple[0] != triple[1] && triple[1] != triple[2]) {
+            triples.insert(triple);
+        }
+    }
+    combo_key_indices.insert(combo_key_indices.end(), triples.begin(), triples.end());
+
+    for (uint16_t i = 0; i < COMBO_COUNT; ++i) {
+        uint8_t n = 0;
+        for (uint8_t key : combo_key_indices[i]) {
+            combo_keys[i][n++] = KC_A + key;
+        }
+        combo_keys[i][n] = COMBO_END;
+        key_combos[i]    = COMBO_ACTION(combo_keys[i]);
+    }
+    return true;
+}
+
+bool combos_defined = define_combos();
+
+}  // namespace
+
+extern "C" void process_combo_event(uint16_t combo_index, bool pressed) {
+    if (pressed) {
+        fired_combos.push_back(combo_index);
+        tap_code(KC_F1);
+    }
+}
+
+class ComboStress : public BenchmarkFixture {
+   protected:
+    void SetUp() override {
+        keys = letter_keys(KEY_COUNT);
+        set_keymap(keys);
+        fired_combos.clear();
+    }
+
+    std::vector<KeymapKey> keys;
+};
+
+TEST_F(ComboStress, EachComboFiresAlone) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (uint16_t i = 0; i < COMBO_COUNT; ++i) {
+        for (uint8_t key : combo_key_indices[i]) {
+            keys[key].press();
+        }
+        run_one_scan_loop();
+        idle_for(COMBO_TERM + 1);
+        for (uint8_t key : combo_key_indices[i]) {
+            keys[key].release();
+        }
+        idle_for(COMBO_TERM + 1);
+
+        EXPECT_EQ(fired_combos, std::vector<uint16_t>({i})) << "combo " << i;
+        fired_combos.clear();
+    }
+}
+
+TEST_F(ComboStress, TypingIsNotMistakenForCombos) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (uint8_t i = 0; i < KEY_COUNT; ++i) {
+        keys[i].press();
+        run_one_scan_loop();
+        idle_for(COMBO_TERM + 1);
+        keys[i].release();
+        idle_for(COMBO_TERM + 1);
+    }
+    EXPECT_TRUE(fired_combos.empty());
+}
+
+TEST_F(ComboStress, Typing) {
+    auto result = replay(keys, typing_trace(KEY_COUNT, 2000, 60, 60, 90, 1));
+#ifdef COMBO_KEY_INDEX_SIZE
+    report("500 combos, key index", result);
+#else
+    report("500 combos, linear scan", result);
+#endif
+    EXPECT_EQ(result.unreported, 0);
+}
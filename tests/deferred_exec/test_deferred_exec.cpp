@@ -0,0 +1,266 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "deferred_exec.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+namespace {
+
+struct Timer {
+    deferred_token token;
+    uint32_t       due;
+    uint32_t       repeat;
+    uint32_t       fired;
+    bool           active;
+};
+
+uint32_t timer_callback(uint32_t trigger_time, void *cb_arg) {
+    Timer *t = static_cast<Timer *>(cb_arg);
+    EXPECT_TRUE(t->active);
+    EXPECT_EQ(trigger_time, t->due);
+    EXPECT_EQ(timer_read32(), t->due);
+    t->fired++;
+    if (t->repeat == 0) {
+        t->active = false;
+    } else {
+        t->due += t->repeat;
+    }
+    return t->repeat;
+}
+
+}  // namespace
+
+class DeferredExec : public ::testing::Test {
+   protected:
+    void TearDown() override {
+        for (auto &t : timers) {
+            if (t.active) {
+                EXPECT_TRUE(cancel_deferred_exec(t.token));
+            }
+        }
+        timers.clear();
+    }
+
+    Timer *schedule(uint32_t delay, uint32_t repeat = 0) {
+        timers.push_back({INVALID_DEFERRED_TOKEN, timer_read32() + delay, repeat, 0, true});
+        Timer *t = &timers.back();
+        t->token = defer_exec(delay, timer_callback, t);
+        EXPECT_NE(t->token, INVALID_DEFERRED_TOKEN);
+        return t;
+    }
+
+    void run_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; ++i) {
+            advance_time(1);
+            deferred_exec_task();
+        }
+    }
+
+    // Jumps forward in steps the millisecond throttle can follow, without firing anything on the way
+    void jump_to(uint32_t target) {
+        while (TIMER_DIFF_32(target, timer_read32()) > 0x40000000) {
+            advance_time(0x40000000);
+            deferred_exec_task();
+        }
+        set_time(target);
+        deferred_exec_task();
+    }
+
+    std::vector<Timer> timers;
+
+    DeferredExec() { timers.reserve(100000); }
+};
+
+static uint32_t noop_callback(uint32_t trigger_time, void *cb_arg) { return 0; }
+
+TEST_F(DeferredExec, RejectsInvalidArguments) {
+    EXPECT_EQ(defer_exec(0, noop_callback, nullptr), INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(defer_exec(10, nullptr, nullptr), INVALID_DEFERRED_TOKEN);
+    EXPECT_FALSE(extend_deferred_exec(INVALID_DEFERRED_TOKEN, 10));
+    EXPECT_FALSE(cancel_deferred_exec(INVALID_DEFERRED_TOKEN));
+}
+
+TEST_F(DeferredExec, FiresOnceAtTriggerTime) {
+    Timer *t = schedule(50);
+    run_for(49);
+    EXPECT_EQ(t->fired, 0);
+    run_for(1);
+    EXPECT_EQ(t->fired, 1);
+    run_for(100);
+    EXPECT_EQ(t->fired, 1);
+    EXPECT_FALSE(cancel_deferred_exec(t->token));
+}
+
+TEST_F(DeferredExec, FiresInTriggerOrder) {
+    Timer *late  = schedule(30);
+    Timer *early = schedule(10);
+    run_for(10);
+    EXPECT_EQ(early->fired, 1);
+    EXPECT_EQ(late->fired, 0);
+    run_for(20);
+    EXPECT_EQ(late->fired, 1);
+}
+
+TEST_F(DeferredExec, RepeatsRelativeToPreviousTrigger) {
+    Timer *t = schedule(10, 25);
+    run_for(10 + 25 * 4);
+    EXPECT_EQ(t->fired, 5);
+    EXPECT_TRUE(t->active);
+}
+
+TEST_F(DeferredExec, ExtendPushesBackTrigger) {
+    Timer *t = schedule(10);
+    run_for(5);
+    EXPECT_TRUE(extend_deferred_exec(t->token, 20));
+    t->due = timer_read32() + 20;
+    run_for(19);
+    EXPECT_EQ(t->fired, 0);
+    run_for(1);
+    EXPECT_EQ(t->fired, 1);
+    EXPECT_FALSE(extend_deferred_exec(t->token, 20));
+}
+
+TEST_F(DeferredExec, CancelPreventsExecution) {
+    Timer *t = schedule(10);
+    EXPECT_TRUE(cancel_deferred_exec(t->token));
+    t->active = false;
+    EXPECT_FALSE(cancel_deferred_exec(t->token));
+    run_for(20);
+    EXPECT_EQ(t->fired, 0);
+}
+
+TEST_F(DeferredExec, TokensAreNotReusedImmediately) {
+    deferred_token first = defer_exec(10, noop_callback, nullptr);
+    EXPECT_TRUE(cancel_deferred_exec(first));
+    for (int i = 0; i < MAX_DEFERRED_EXECUTORS * 4; ++i) {
+        deferred_token token = defer_exec(10, noop_callback, nullptr);
+        EXPECT_NE(token, INVALID_DEFERRED_TOKEN);
+        EXPECT_NE(token, first);
+        EXPECT_FALSE(cancel_deferred_exec(first));
+        EXPECT_TRUE(cancel_deferred_exec(token));
+    }
+}
+
+TEST_F(DeferredExec, LimitedToMaxExecutors) {
+    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
+        schedule(100 + i);
+    }
+    EXPECT_EQ(defer_exec(10, noop_callback, nullptr), INVALID_DEFERRED_TOKEN);
+
+    // Freeing one up allows scheduling again
+    EXPECT_TRUE(cancel_deferred_exec(timers[10].token));
+    timers[10].active = false;
+    schedule(10);
+    run_for(100 + MAX_DEFERRED_EXECUTORS);
+    for (auto &t : timers) {
+        EXPECT_EQ(t.fired, &t == &timers[10] ? 0 : 1);
+    }
+}
+
+static deferred_token self_token;
+static uint32_t       self_cancel_callback(uint32_t trigger_time, void *cb_arg) {
+    EXPECT_TRUE(cancel_deferred_exec(self_token));
+    // Reuse of the freed slot from within a callback must not be clobbered on return
+    *static_cast<deferred_token *>(cb_arg) = defer_exec(5, noop_callback, nullptr);
+    return 10;
+}
+
+TEST_F(DeferredExec, CallbackCanCancelItself) {
+    deferred_token replacement = INVALID_DEFERRED_TOKEN;
+    self_token                 = defer_exec(10, self_cancel_callback, &replacement);
+    run_for(10);
+    EXPECT_NE(replacement, INVALID_DEFERRED_TOKEN);
+    EXPECT_FALSE(cancel_deferred_exec(self_token));
+    EXPECT_TRUE(cancel_deferred_exec(replacement));
+}
+
+TEST_F(DeferredExec, HandlesTimerWraparound) {
+    jump_to(0xFFFFFFF0);
+    Timer *before = schedule(8);
+    Timer *after  = schedule(40);
+    Timer *repeat = schedule(4, 7);
+    run_for(8);
+    EXPECT_EQ(before->fired, 1);
+    EXPECT_EQ(after->fired, 0);
+    run_for(32);
+    EXPECT_EQ(after->fired, 1);
+    EXPECT_EQ(repeat->fired, 6);
+}
+
+TEST_F(DeferredExec, RandomisedCreateExtendCancelAcrossWraparound) {
+    std::mt19937 rng(0x5EED);
+    auto         random = [&](uint32_t lo, uint32_t hi) { return std::uniform_int_distribution<uint32_t>(lo, hi)(rng); };
+
+    jump_to(0xFFFF0000);
+    std::vector<size_t> active;
+    for (int step = 0; step < 200000; ++step) {
+        std::vector<size_t> still_active;
+        for (size_t i : active) {
+            if (timers[i].active) still_active.push_back(i);
+        }
+        active.swap(still_active);
+
+        switch (random(0, 9)) {
+            case 0:
+            case 1:
+            case 2:
+                if (active.size() < MAX_DEFERRED_EXECUTORS) {
+                    schedule(random(1, 300), random(0, 3) == 0 ? random(1, 50) : 0);
+                    active.push_back(timers.size() - 1);
+                } else {
+                    EXPECT_EQ(defer_exec(10, noop_callback, nullptr), INVALID_DEFERRED_TOKEN);
+                }
+                break;
+            case 3:
+                if (!active.empty()) {
+                    Timer *  t     = &timers[active[random(0, active.size() - 1)]];
+                    uint32_t delay = random(1, 300);
+                    EXPECT_TRUE(extend_deferred_exec(t->token, delay));
+                    t->due = timer_read32() + delay;
+                }
+                break;
+            case 4:
+                if (!active.empty()) {
+                    Timer *t = &timers[active[random(0, active.size() - 1)]];
+                    EXPECT_TRUE(cancel_deferred_exec(t->token));
+                    t->active = false;
+                    EXPECT_FALSE(cancel_deferred_exec(t->token));
+                }
+                break;
+            default:
+                run_for(random(1, 3));
+                break;
+        }
+    }
+
+    // Everything still scheduled fires exactly on time
+    run_for(400);
+    for (auto &t : timers) {
+        if (t.active) {
+            EXPECT_NE(t.repeat, 0);
+        }
+    }
+}
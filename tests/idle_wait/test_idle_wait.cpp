@@ -0,0 +1,130 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "deferred_exec.h"
+#include "idle_wait.h"
+
+void set_idle_interrupt(uint32_t time);
+}
+
+using testing::_;
+
+class IdleWait : public TestFixture {
+   public:
+    IdleWait() {
+        // Drop any wakeups left behind by the previous test's clean-up, without sleeping
+        idle_wakeup_in(0);
+        idle_wait_task();
+    }
+
+   protected:
+    // Runs the idle task, returning how long the simulated clock was put to sleep for
+    uint32_t idle() {
+        uint32_t start = timer_read32();
+        idle_wait_task();
+        return timer_elapsed32(start);
+    }
+};
+
+TEST_F(IdleWait, SleepsForTheMaximumWhenNothingIsScheduled) { EXPECT_EQ(idle(), IDLE_WAIT_MAX_MS); }
+
+TEST_F(IdleWait, SleepsUntilTheEarliestWakeup) {
+    idle_wakeup_in(20);
+    idle_wakeup_in(7);
+    idle_wakeup_in(30);
+    EXPECT_EQ(idle(), 7);
+
+    // Requests only last for a single iteration
+    EXPECT_EQ(idle(), IDLE_WAIT_MAX_MS);
+}
+
+TEST_F(IdleWait, ZeroDelayPreventsSleeping) {
+    idle_wakeup_in(10);
+    idle_wakeup_in(0);
+    EXPECT_EQ(idle(), 0);
+}
+
+TEST_F(IdleWait, PastWakeupsPreventSleeping) {
+    idle_wakeup_at(timer_read32() - 5);
+    EXPECT_EQ(idle(), 0);
+}
+
+TEST_F(IdleWait, WakeupsAreClampedToTheMaximum) {
+    idle_wakeup_in(IDLE_WAIT_MAX_MS * 3);
+    EXPECT_EQ(idle(), IDLE_WAIT_MAX_MS);
+}
+
+TEST_F(IdleWait, InterruptEndsSleepEarly) {
+    set_idle_interrupt(timer_read32() + 3);
+    idle_wakeup_in(50);
+    EXPECT_EQ(idle(), 3);
+
+    // The interrupt has been consumed
+    idle_wakeup_in(50);
+    EXPECT_EQ(idle(), 50);
+}
+
+TEST_F(IdleWait, InterruptBeforeSleepingIsNotLost) {
+    idle_wakeup_from_isr();
+    idle_wakeup_in(50);
+    EXPECT_EQ(idle(), 0);
+}
+
+static uint32_t count_callback(uint32_t trigger_time, void *cb_arg) {
+    (*static_cast<int *>(cb_arg))++;
+    return 0;
+}
+
+TEST_F(IdleWait, SleepsUntilTheNextDeferredExecutor) {
+    int            calls = 0;
+    deferred_token token = defer_exec(25, count_callback, &calls);
+    EXPECT_NE(token, INVALID_DEFERRED_TOKEN);
+
+    EXPECT_EQ(idle(), 25);
+    deferred_exec_task();
+    EXPECT_EQ(calls, 1);
+
+    // Nothing else is due
+    deferred_exec_task();
+    EXPECT_EQ(idle(), IDLE_WAIT_MAX_MS);
+}
+
+TEST_F(IdleWait, MatrixIsPolledAtTheScanInterval) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    keyboard_task();
+    EXPECT_EQ(idle(), IDLE_WAIT_MATRIX_SCAN_INTERVAL);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key.report_code)));
+    keyboard_task();
+    EXPECT_EQ(idle(), IDLE_WAIT_MATRIX_SCAN_INTERVAL);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key.release();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,94 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class KeysPerScan : public TestFixture {};
+
+TEST_F(KeysPerScan, ChangesThatDoNotFitAreProcessedOnTheNextScan) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 0, 1, KC_B);
+    auto       key_c = KeymapKey(0, 0, 2, KC_C);
+
+    set_keymap({key_a, key_b, key_c});
+
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_b.report_code)));
+    }
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_b.report_code, key_c.report_code)));
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    keyboard_task();
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeysPerScan, BusyRowDoesNotStarveLaterRows) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 0, 2, KC_C);
+
+    set_keymap({key_a, key_b, key_c});
+
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_b.report_code)));
+    }
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Row 0 changes again, but the pending press on row 2 is processed first
+    key_a.release();
+    key_b.release();
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_b.report_code, key_c.report_code)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code, key_c.report_code)));
+    }
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_c.report_code)));
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_c.release();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    keyboard_task();
+}
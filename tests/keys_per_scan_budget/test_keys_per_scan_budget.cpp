@@ -0,0 +1,104 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+extern "C" {
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+// How long each key takes to process, in milliseconds
+static uint8_t process_time = 0;
+
+extern "C" bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    advance_time(process_time);
+    return true;
+}
+
+class KeysPerScanBudget : public TestFixture {
+   protected:
+    void TearDown() override {
+        process_time = 0;
+        TestFixture::TearDown();
+    }
+};
+
+// The event time is made odd so it's never 0, which mustn't push the start of the budget into the future
+TEST_F(KeysPerScanBudget, EvenStartTimeDispatchesEveryKey) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 0, 1, KC_B);
+    auto       key_c = KeymapKey(0, 0, 2, KC_C);
+
+    set_keymap({key_a, key_b, key_c});
+    set_time(1000);
+
+    key_a.press();
+    key_b.press();
+    key_c.press();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+    keyboard_task();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(KeysPerScanBudget, KeysLeftOverBudgetAreProcessedOnTheNextScan) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 0, 1, KC_B);
+    auto       key_c = KeymapKey(0, 0, 2, KC_C);
+
+    set_keymap({key_a, key_b, key_c});
+    process_time = 1;
+
+    for (uint32_t start : {1000, 1001}) {
+        set_time(start);
+
+        key_a.press();
+        key_b.press();
+        key_c.press();
+        {
+            InSequence s;
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code)));
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_b.report_code)));
+        }
+        keyboard_task();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_b.report_code, key_c.report_code)));
+        keyboard_task();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        key_a.release();
+        key_b.release();
+        key_c.release();
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(3);
+        keyboard_task();
+        keyboard_task();
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+}
@@ -0,0 +1,152 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+using testing::_;
+
+class LayerLookupCache : public TestFixture {
+   protected:
+    // Runs lookups against the currently active layers, either straight from the cache or resolved from scratch each time
+    double lookups_per_second(keypos_t key, bool cached) {
+        constexpr int iterations = 200000;
+        uint32_t      checksum   = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            if (!cached) {
+                layer_lookup_cache_invalidate();
+            }
+            checksum += layer_switch_get_layer(key);
+        }
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        EXPECT_EQ(checksum, 0);
+        return iterations / elapsed;
+    }
+
+    void benchmark(uint8_t layers) {
+        std::vector<KeymapKey> keys;
+        keypos_t               key = {.col = 4, .row = 2};
+        keys.push_back(KeymapKey(0, key.col, key.row, KC_A));
+        for (uint8_t layer = 1; layer < 32; layer++) {
+            keys.push_back(KeymapKey(layer, key.col, key.row, KC_TRNS));
+        }
+        for (auto &k : keys) {
+            add_key(k);
+        }
+
+        layer_state_set(layers == 32 ? UINT32_MAX : ((layer_state_t)1 << layers) - 1);
+
+        double uncached = lookups_per_second(key, false);
+        double cached   = lookups_per_second(key, true);
+        std::cout << "[ BENCHMARK] " << +layers << " active layers: " << uint64_t(uncached) << " lookups/s uncached, " << uint64_t(cached) << " lookups/s cached" << std::endl;
+    }
+};
+
+TEST_F(LayerLookupCache, ResolvesTopmostNonTransparentLayer) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key, KeymapKey(1, 0, 0, KC_TRNS), KeymapKey(2, 0, 0, KC_B)});
+
+    EXPECT_EQ(layer_switch_get_layer(key.position), 0);
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(key.position), 0);
+    layer_on(2);
+    EXPECT_EQ(layer_switch_get_layer(key.position), 2);
+    layer_off(2);
+    EXPECT_EQ(layer_switch_get_layer(key.position), 0);
+    layer_off(1);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerLookupCache, FollowsDefaultLayerChanges) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key, KeymapKey(1, 0, 0, KC_B)});
+
+    EXPECT_EQ(layer_switch_get_layer(key.position), 0);
+    default_layer_set(1UL << 1);
+    EXPECT_EQ(layer_switch_get_layer(key.position), 1);
+    default_layer_set(1UL << 0);
+    EXPECT_EQ(layer_switch_get_layer(key.position), 0);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerLookupCache, InvalidatedWhenKeymapChanges) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key, KeymapKey(1, 0, 0, KC_TRNS)});
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(key.position), 0);
+
+    set_keymap({key, KeymapKey(1, 0, 0, KC_B)});
+    EXPECT_EQ(layer_switch_get_layer(key.position), 1);
+    layer_off(1);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerLookupCache, KeysResolveIndependently) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(1, 1, 0, KC_C);
+
+    set_keymap({key_a, key_b, KeymapKey(1, 0, 0, KC_TRNS), key_c});
+    layer_on(1);
+
+    key_a.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_c.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_c.report_code)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_a.release();
+    key_c.release();
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    layer_off(1);
+}
+
+TEST_F(LayerLookupCache, BenchmarkSixteenLayers) {
+    TestDriver driver;
+    benchmark(16);
+    layer_clear();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerLookupCache, BenchmarkThirtyTwoLayers) {
+    TestDriver driver;
+    benchmark(32);
+    layer_clear();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,265 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "send_string.h"
+}
+
+using testing::_;
+using testing::InSequence;
+
+class SendStringAsync : public TestFixture {};
+
+TEST_F(SendStringAsync, ReturnsBeforeTyping) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    SEND_STRING_ASYNC("aB");
+    EXPECT_TRUE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // One report per scan
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_B)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    for (int i = 0; i < 6; i++) {
+        run_one_scan_loop();
+    }
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringAsync, TapDownUp) {
+    TestDriver driver;
+
+    SEND_STRING_ASYNC(SS_DOWN(X_LCTL) SS_TAP(X_C) SS_UP(X_LCTL));
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_C)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+// The matrix is still scanned during a delay, and keys pressed then are reported straight away
+TEST_F(SendStringAsync, DelayDoesNotBlockKeys) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_Z);
+
+    set_keymap({key});
+
+    SEND_STRING_ASYNC("a" SS_DELAY(100) "b");
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key.press();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key.release();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // nothing more until the delay is over
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(98);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringAsync, Interval) {
+    TestDriver driver;
+
+    SEND_STRING_ASYNC_DELAY("ab", 10);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(9);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // the interval after the last character
+    idle_for(10);
+    EXPECT_FALSE(send_string_async_busy());
+}
+
+TEST_F(SendStringAsync, WaitsForHost) {
+    TestDriver driver;
+
+    driver.set_keyboard_ready(false);
+    SEND_STRING_ASYNC("a");
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    driver.set_keyboard_ready(true);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    driver.set_keyboard_ready(false);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    driver.set_keyboard_ready(true);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+// Strings in flash are read as they're typed, however long they are
+TEST_F(SendStringAsync, LongStringDoesNotBlock) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    SEND_STRING_ASYNC("abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+    EXPECT_TRUE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2 * 52);
+    idle_for(2 * 52);
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+// Longer than the buffer: the first characters are typed to make room for the rest
+TEST_F(SendStringAsync, FullBuffer) {
+    TestDriver driver;
+    const char text[] = "abcdefghijklmnopqrst";
+
+    {
+        InSequence s;
+        for (const char *c = text; *c; c++) {
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A + (*c - 'a'))));
+            EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        }
+    }
+    send_string_async(text);
+    EXPECT_TRUE(send_string_async_busy());
+    idle_for(2 * sizeof(text));
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+// A blocking string waits for the queued ones, so they come out in order
+TEST_F(SendStringAsync, SendStringAfterAsync) {
+    TestDriver driver;
+
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    SEND_STRING_ASYNC("a");
+    SEND_STRING("b");
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+// More strings than the queue holds: the first ones are typed to make room
+TEST_F(SendStringAsync, FullQueue) {
+    TestDriver driver;
+
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    SEND_STRING_ASYNC("a");
+    send_string_async("b");
+    SEND_STRING_ASYNC("c");
+    EXPECT_TRUE(send_string_async_busy());
+    idle_for(6);
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+// Past the range of the 16 bit timer
+TEST_F(SendStringAsync, LongDelay) {
+    TestDriver driver;
+
+    SEND_STRING_ASYNC(SS_DELAY(40000) "a");
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(39999);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    idle_for(3);
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+// As dynamic keymap macros are stored: tap, down and up codes without the prefix
+static const char reader_macro[] = "a" "\2" "\xe0" "\1" "\x06" "\3" "\xe0" "b";
+
+static uint8_t read_macro(uint16_t offset) { return reader_macro[offset]; }
+
+TEST_F(SendStringAsync, Reader) {
+    TestDriver driver;
+
+    {
+        InSequence s;
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL, KC_C)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+        EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    }
+    send_string_async_reader(read_macro, 0);
+    idle_for(10);
+    EXPECT_FALSE(send_string_async_busy());
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
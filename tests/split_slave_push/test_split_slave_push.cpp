@@ -0,0 +1,161 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "split_sim.h"
+#include "timer.h"
+#include "transaction_id_define.h"
+#include "transactions.h"
+}
+
+using testing::_;
+
+// Not exported by transactions.c, the tests only need to know the defaults
+#define FORCED_SYNC_THROTTLE_MS 100
+#define SERIAL_USART_PUSH_RETRY_MS 5
+
+class SplitSlavePush : public TestFixture {
+   public:
+    SplitSlavePush() {
+        split_sim_configure(&split_sim_default_config);
+        split_sim_reset_stats();
+    }
+    ~SplitSlavePush() { split_sim_configure(&split_sim_default_config); }
+
+   protected:
+    void lose_pushes(bool lost) {
+        split_sim_config_t config = split_sim_default_config;
+        config.pushes_lost        = lost;
+        split_sim_configure(&config);
+    }
+
+    uint32_t polls() {
+        split_sim_stats_t stats;
+        split_sim_get_stats(&stats);
+        return stats.per_transaction[GET_SLAVE_MATRIX_DATA];
+    }
+
+    // Taps a key with the pushes coming through, so that the master stops polling the slave
+    void settle(TestDriver& driver, KeymapKey& key) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+        key.press();
+        run_one_scan_loop();
+        key.release();
+        run_one_scan_loop();
+        idle_for(10);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+    }
+};
+
+TEST_F(SplitSlavePush, DroppedPushIsSentAgain) {
+    TestDriver driver;
+    auto       warmup = KeymapKey(0, 1, 3, KC_B);
+    auto       key    = KeymapKey(0, 0, 2, KC_A);
+
+    set_keymap({warmup, key});
+    settle(driver, warmup);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    lose_pushes(true);
+    key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The slave pushes the press again until the master acknowledges it, long before the master would poll
+    lose_pushes(false);
+    uint32_t polls_before = polls();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    idle_for(SERIAL_USART_PUSH_RETRY_MS);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_EQ(polls(), polls_before);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SplitSlavePush, FallsBackToPolling) {
+    TestDriver driver;
+    auto       warmup = KeymapKey(0, 1, 3, KC_B);
+    auto       key    = KeymapKey(0, 0, 2, KC_A);
+
+    set_keymap({warmup, key});
+    settle(driver, warmup);
+
+    // With the pushes gone, the press is only seen by the check the master makes every now and then
+    lose_pushes(true);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    key.press();
+    idle_for(FORCED_SYNC_THROTTLE_MS);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // From then on the slave is polled on every scan
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The press pushed again once the pushes come back is stale, the master only acknowledges it
+    lose_pushes(false);
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(SERIAL_USART_PUSH_RETRY_MS);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The next push that does come through ends the polling
+    settle(driver, key);
+    uint32_t polls_before = polls();
+    idle_for(FORCED_SYNC_THROTTLE_MS / 2);
+    EXPECT_EQ(polls(), polls_before);
+}
+
+TEST_F(SplitSlavePush, EventTimeIsClamped) {
+    TestDriver driver;
+    auto       warmup = KeymapKey(0, 1, 3, KC_B);
+    auto       key    = KeymapKey(0, 0, 2, KC_A);
+
+    set_keymap({warmup, key});
+    settle(driver, warmup);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The time the slave saw the press, as it was pushed
+    uint16_t now    = timer_read();
+    uint16_t pushed = transactions_slave_event_time(now - 1000, now + 50);
+    EXPECT_LE(TIMER_DIFF_16(pushed, now - 1000), 1000 + 50);
+
+    EXPECT_EQ(transactions_slave_event_time(pushed - 1000, pushed + 20), pushed);
+    // Never before the events ahead of it
+    EXPECT_EQ(transactions_slave_event_time(pushed + 10, pushed + 20), (uint16_t)((pushed + 10) | 1));
+    // Never past the scan, nor taken from a push that is too old to have its timer in sync
+    EXPECT_EQ(transactions_slave_event_time(pushed - 1000, pushed - 10), (uint16_t)((pushed - 10) | 1));
+    EXPECT_EQ(transactions_slave_event_time(pushed - 1000, pushed + FORCED_SYNC_THROTTLE_MS + 10), (uint16_t)((pushed + FORCED_SYNC_THROTTLE_MS + 10) | 1));
+
+    // Only the scan the push arrived in has a time from the slave
+    run_one_scan_loop();
+    EXPECT_EQ(transactions_slave_event_time(now - 1000, now + 50), (uint16_t)(now + 50));
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
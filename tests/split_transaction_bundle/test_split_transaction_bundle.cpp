@@ -0,0 +1,204 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "split_sim.h"
+#include "rgb_matrix.h"
+
+static void noop_init(void) {}
+static void noop_set_color(int index, uint8_t r, uint8_t g, uint8_t b) {}
+static void noop_set_color_all(uint8_t r, uint8_t g, uint8_t b) {}
+static void noop_flush(void) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = noop_init,
+    .set_color     = noop_set_color,
+    .set_color_all = noop_set_color_all,
+    .flush         = noop_flush,
+};
+
+led_config_t g_led_config;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+// Not exported by transactions.c, the tests only need to know the default
+#define FORCED_SYNC_THROTTLE_MS 100
+
+// What the slave has been told by the master
+typedef struct {
+    layer_state_t layer_state;
+    uint8_t       mods;
+    uint8_t       leds;
+    rgb_config_t  rgb_matrix;
+} synced_t;
+
+static synced_t slave_synced;
+
+static void read_synced(void) {
+    slave_synced.layer_state = layer_state;
+    slave_synced.mods        = get_mods();
+    slave_synced.leds        = host_keyboard_leds();
+    slave_synced.rgb_matrix  = rgb_matrix_config;
+}
+
+class SplitTransactionBundle : public TestFixture {
+   public:
+    SplitTransactionBundle() : rgb_matrix_before(rgb_matrix_config) {
+        split_sim_configure(&split_sim_default_config);
+        split_sim_reset_stats();
+    }
+    ~SplitTransactionBundle() {
+        split_sim_configure(&split_sim_default_config);
+        clear_mods();
+        rgb_matrix_config = rgb_matrix_before;
+    }
+
+   protected:
+    rgb_config_t rgb_matrix_before;
+
+    synced_t slave() {
+        split_sim_on_slave(read_synced);
+        return slave_synced;
+    }
+
+    void expect_synced() {
+        synced_t synced = slave();
+        EXPECT_EQ(synced.layer_state, layer_state);
+        EXPECT_EQ(synced.mods, get_mods());
+        EXPECT_EQ(synced.leds, host_keyboard_leds());
+        EXPECT_EQ(synced.rgb_matrix.raw, rgb_matrix_config.raw);
+        EXPECT_EQ(synced.rgb_matrix.speed, rgb_matrix_config.speed);
+    }
+
+    void configure(bool disconnected, uint16_t corrupt_rate) {
+        split_sim_config_t config = split_sim_default_config;
+        config.disconnected       = disconnected;
+        config.corrupt_rate       = corrupt_rate;
+        split_sim_configure(&config);
+    }
+};
+
+TEST_F(SplitTransactionBundle, SyncsStateToSlave) {
+    TestDriver         driver;
+    split_sim_config_t config = split_sim_default_config;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(10);
+    expect_synced();
+
+    // Everything the master syncs shares the bundled frames, and has to arrive through a lossy link as well
+    config.drop_rate    = 65536 / 8;
+    config.corrupt_rate = 65536 / 8;
+    config.seed         = 3;
+    split_sim_configure(&config);
+
+    layer_on(1);
+    add_mods(MOD_BIT(KC_LSFT) | MOD_BIT(KC_RALT));
+    driver.set_leds(1 << USB_LED_CAPS_LOCK);
+    rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
+    rgb_matrix_sethsv_noeeprom(85, 255, 128);
+    idle_for(20);
+    expect_synced();
+
+    layer_off(1);
+    layer_on(2);
+    del_mods(MOD_BIT(KC_LSFT));
+    driver.set_leds(0);
+    rgb_matrix_sethsv_noeeprom(170, 200, 64);
+    idle_for(20);
+    expect_synced();
+
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    EXPECT_GT(stats.failed, 0);
+    EXPECT_GT(stats.corrupted, 0);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SplitTransactionBundle, ResendsLostFrame) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(10);
+
+    // The frame carrying the change never arrives
+    configure(true, 0);
+    layer_on(1);
+    run_one_scan_loop();
+    configure(false, 0);
+    EXPECT_EQ(slave().layer_state, 0);
+
+    // It isn't acknowledged, so the next frame carries it again. The slave unpacks a frame on its next scan.
+    idle_for(2);
+    EXPECT_EQ(slave().layer_state, layer_state);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SplitTransactionBundle, ResendsCorruptedFrame) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(10);
+
+    // Nearly every frame arrives with a flipped bit. The slave never acts on one, and only the
+    // frames that happen to get through intact carry the change.
+    configure(false, UINT16_MAX);
+    add_mods(MOD_BIT(KC_LCTL));
+    for (int i = 0; i < 20; i++) {
+        run_one_scan_loop();
+        synced_t synced = slave();
+        EXPECT_TRUE(synced.mods == 0 || synced.mods == MOD_BIT(KC_LCTL));
+        EXPECT_EQ(synced.layer_state, 0);
+    }
+
+    // Whatever didn't get through is sent again until acknowledged
+    configure(false, 0);
+    idle_for(2);
+    EXPECT_EQ(slave().mods, MOD_BIT(KC_LCTL));
+
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    EXPECT_GT(stats.corrupted, 0);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SplitTransactionBundle, StaleFrameNumberRecoversOnForcedSync) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    idle_for(10);
+
+    // The slave keeps the number of the last frame it took, whatever happens to the master. After a reset of the master,
+    // or as here once the master's numbers have come all the way around while the slave was away, the next frame can
+    // carry that same number. The slave then takes it for a repeat and skips it, but still acknowledges it.
+    configure(true, 0);
+    idle_for(255);
+    configure(false, 0);
+    layer_on(1);
+    run_one_scan_loop();
+
+    // So the change only arrives with the resend the master makes every FORCED_SYNC_THROTTLE_MS
+    idle_for(FORCED_SYNC_THROTTLE_MS - 1);
+    EXPECT_EQ(slave().layer_state, 0);
+    idle_for(2);
+    EXPECT_EQ(slave().layer_state, layer_state);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
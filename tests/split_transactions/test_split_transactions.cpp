@@ -0,0 +1,175 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <set>
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "split_sim.h"
+#include "split_util.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class SplitTransactions : public TestFixture {
+   public:
+    SplitTransactions() {
+        split_sim_configure(&split_sim_default_config);
+        split_sim_reset_stats();
+    }
+    ~SplitTransactions() { split_sim_configure(&split_sim_default_config); }
+
+   protected:
+    /* Presses and releases each key in turn, recording every key that showed up in a report on the way
+     * and the keys held in the last one. */
+    std::set<uint8_t> type_keys(TestDriver& driver, std::vector<KeymapKey>& keys, std::set<uint8_t>* held) {
+        std::set<uint8_t> reported;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber()).WillRepeatedly([&](report_keyboard_t& report) {
+            held->clear();
+            for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+                if (report.keys[i]) held->insert(report.keys[i]);
+            }
+            reported.insert(held->begin(), held->end());
+        });
+        for (auto& key : keys) {
+            key.press();
+            idle_for(30);
+            key.release();
+            idle_for(30);
+        }
+        idle_for(200);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        return reported;
+    }
+};
+
+TEST_F(SplitTransactions, SlaveKeyReachesHost) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 3, 2, KC_B);
+
+    set_keymap({key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SplitTransactions, MasterMatrixIsMirrored) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 4, 1, KC_C);
+
+    set_keymap({key});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    key.press();
+    // The slave picks the mirrored matrix up on its next scan
+    run_one_scan_loop();
+    run_one_scan_loop();
+    EXPECT_EQ(split_sim_slave_master_rows()[1], 1 << 4);
+
+    key.release();
+    run_one_scan_loop();
+    run_one_scan_loop();
+    EXPECT_EQ(split_sim_slave_master_rows()[1], 0);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SplitTransactions, SurvivesDroppedTransactions) {
+    TestDriver              driver;
+    std::vector<KeymapKey> keys = {KeymapKey(0, 0, 2, KC_A), KeymapKey(0, 5, 3, KC_B), KeymapKey(0, 9, 2, KC_C), KeymapKey(0, 2, 0, KC_D)};
+    split_sim_config_t      config = split_sim_default_config;
+    std::set<uint8_t>       held;
+
+    set_keymap({keys[0], keys[1], keys[2], keys[3]});
+    config.drop_rate = 65536 / 8;
+    config.seed      = 1;
+    split_sim_configure(&config);
+
+    auto reported = type_keys(driver, keys, &held);
+    EXPECT_EQ(reported, std::set<uint8_t>({KC_A, KC_B, KC_C, KC_D}));
+    EXPECT_TRUE(held.empty());
+
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    EXPECT_GT(stats.failed, 0);
+    EXPECT_TRUE(is_transport_connected());
+}
+
+TEST_F(SplitTransactions, RejectsCorruptedBuffers) {
+    TestDriver              driver;
+    std::vector<KeymapKey> keys = {KeymapKey(0, 0, 2, KC_A), KeymapKey(0, 5, 3, KC_B), KeymapKey(0, 9, 2, KC_C), KeymapKey(0, 2, 0, KC_D)};
+    split_sim_config_t      config = split_sim_default_config;
+    std::set<uint8_t>       held;
+
+    set_keymap({keys[0], keys[1], keys[2], keys[3]});
+    config.corrupt_rate = 65536 / 4;
+    config.seed         = 2;
+    split_sim_configure(&config);
+
+    // A flipped bit on the way must never show up as a key that wasn't pressed
+    auto reported = type_keys(driver, keys, &held);
+    EXPECT_EQ(reported, std::set<uint8_t>({KC_A, KC_B, KC_C, KC_D}));
+    EXPECT_TRUE(held.empty());
+
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    EXPECT_GT(stats.corrupted, 0);
+}
+
+TEST_F(SplitTransactions, ReconnectsAfterDisconnect) {
+    TestDriver         driver;
+    auto               master_key = KeymapKey(0, 0, 0, KC_A);
+    auto               slave_key  = KeymapKey(0, 0, 3, KC_B);
+    split_sim_config_t config     = split_sim_default_config;
+
+    set_keymap({master_key, slave_key});
+    config.disconnected = true;
+    split_sim_configure(&config);
+
+    // The master half keeps working on its own
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    slave_key.press();
+    idle_for(50);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_FALSE(is_transport_connected());
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    master_key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Once the slave answers again, its held key comes through
+    config.disconnected = false;
+    split_sim_configure(&config);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    idle_for(1000);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+    EXPECT_TRUE(is_transport_connected());
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    master_key.release();
+    slave_key.release();
+    idle_for(50);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
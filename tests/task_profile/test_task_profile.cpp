@@ -0,0 +1,132 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "task_profile.h"
+
+void advance_profile_time(uint32_t us);
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    // A keycode that takes a while to process
+    if (keycode == KC_B && record->event.pressed) {
+        advance_profile_time(300);
+    }
+    return true;
+}
+}
+
+using testing::_;
+
+class TaskProfile : public TestFixture {
+   public:
+    TaskProfile() { task_profile_reset(); }
+
+   protected:
+    task_profile_stats_t stats(task_profile_task_t task) {
+        task_profile_stats_t result;
+        EXPECT_TRUE(task_profile_get_stats(task, &result));
+        return result;
+    }
+};
+
+TEST_F(TaskProfile, CountsEveryScan) {
+    TestDriver driver;
+
+    run_one_scan_loop();
+    run_one_scan_loop();
+    run_one_scan_loop();
+
+    EXPECT_EQ(stats(TASK_PROFILE_KEYBOARD_TASK).calls, 3);
+    EXPECT_EQ(stats(TASK_PROFILE_MATRIX_SCAN).calls, 3);
+    // Idle scans still run the action layer with a tick
+    EXPECT_EQ(stats(TASK_PROFILE_ACTION_EXEC).calls, 3);
+    // Disabled features are never recorded
+    EXPECT_EQ(stats(TASK_PROFILE_RGB_MATRIX).calls, 0);
+}
+
+TEST_F(TaskProfile, AttributesTimeToTheSlowTask) {
+    TestDriver driver;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+
+    set_keymap({key_a, key_b});
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    key_a.press();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    auto action = stats(TASK_PROFILE_ACTION_EXEC);
+    EXPECT_EQ(action.calls, 2);
+    EXPECT_EQ(action.min_us, 0);
+    EXPECT_EQ(action.avg_us, 150);
+    EXPECT_EQ(action.max_us, 300);
+    // 256 to 511 us
+    EXPECT_EQ(action.histogram[0], 1);
+    EXPECT_EQ(action.histogram[5], 1);
+
+    // The scan as a whole includes the slow keycode, but the matrix scan doesn't
+    EXPECT_EQ(stats(TASK_PROFILE_KEYBOARD_TASK).max_us, 300);
+    EXPECT_EQ(stats(TASK_PROFILE_MATRIX_SCAN).max_us, 0);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(2);
+    key_a.release();
+    key_b.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TaskProfile, HistogramDoublesPerBucket) {
+    task_profile_record(TASK_PROFILE_OLED, 0);
+    task_profile_record(TASK_PROFILE_OLED, TASK_PROFILE_HISTOGRAM_BASE - 1);
+    task_profile_record(TASK_PROFILE_OLED, TASK_PROFILE_HISTOGRAM_BASE);
+    task_profile_record(TASK_PROFILE_OLED, TASK_PROFILE_HISTOGRAM_BASE * 4);
+    task_profile_record(TASK_PROFILE_OLED, 100000);
+
+    auto oled = stats(TASK_PROFILE_OLED);
+    EXPECT_EQ(oled.calls, 5);
+    EXPECT_EQ(oled.histogram[0], 2);
+    EXPECT_EQ(oled.histogram[1], 1);
+    EXPECT_EQ(oled.histogram[2], 0);
+    EXPECT_EQ(oled.histogram[3], 1);
+    // Everything beyond the last bucket ends up in it
+    EXPECT_EQ(oled.histogram[TASK_PROFILE_HISTOGRAM_BUCKETS - 1], 1);
+    EXPECT_EQ(oled.min_us, 0);
+    EXPECT_EQ(oled.max_us, UINT16_MAX);
+    EXPECT_EQ(oled.avg_us, (TASK_PROFILE_HISTOGRAM_BASE * 6 - 1 + 100000) / 5);
+}
+
+TEST_F(TaskProfile, ResetStartsOver) {
+    task_profile_record(TASK_PROFILE_EEPROM, 40);
+    EXPECT_EQ(stats(TASK_PROFILE_EEPROM).calls, 1);
+
+    task_profile_reset();
+
+    auto eeprom = stats(TASK_PROFILE_EEPROM);
+    EXPECT_EQ(eeprom.calls, 0);
+    EXPECT_EQ(eeprom.min_us, 0);
+    EXPECT_EQ(eeprom.max_us, 0);
+}
+
+TEST_F(TaskProfile, RejectsUnknownTasks) {
+    task_profile_stats_t result;
+    EXPECT_FALSE(task_profile_get_stats(TASK_PROFILE_COUNT, &result));
+}
@@ -20,6 +20,32 @@
 
 static matrix_row_t matrix[MATRIX_ROWS] = {};
 
+#ifdef SPLIT_KEYBOARD
+#    include "split_util.h"
+#    include "split_sim.h"
+
+#    define ROWS_PER_HAND (MATRIX_ROWS / 2)
+
+// The keys as the master sees them: its own, the left half, directly and the others through the simulated transport
+static matrix_row_t master_matrix[MATRIX_ROWS] = {};
+
+void matrix_init(void) {
+    split_pre_init();
+    clear_all_keys();
+    matrix_init_quantum();
+    split_post_init();
+}
+
+uint8_t matrix_scan(void) {
+    split_sim_slave_scan(matrix + ROWS_PER_HAND);
+    memcpy(master_matrix, matrix, sizeof(matrix_row_t) * ROWS_PER_HAND);
+    transport_master_if_connected(master_matrix, master_matrix + ROWS_PER_HAND);
+    matrix_scan_quantum();
+    return 1;
+}
+
+matrix_row_t matrix_get_row(uint8_t row) { return master_matrix[row]; }
+#else
 void matrix_init(void) {
     clear_all_keys();
     matrix_init_quantum();
@@ -31,6 +57,7 @@ uint8_t matrix_scan(void) {
 }
 
 matrix_row_t matrix_get_row(uint8_t row) { return matrix[row]; }
+#endif
 
 void matrix_print(void) {}
 
@@ -0,0 +1,278 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_benchmark.hpp"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <random>
+#include "gtest/gtest.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "action.h"
+#include "host.h"
+#include "keycode.h"
+#include "keyboard.h"
+#include "timer.h"
+#ifdef SPLIT_KEYBOARD
+#    include "split_sim.h"
+#endif
+
+void advance_time(uint32_t ms);
+}
+
+namespace {
+
+/* Bytes of stack below the caller painted before each measured scan. */
+const size_t    STACK_PAINT_SIZE = 64 * 1024;
+const uint8_t   STACK_PAINT_BYTE = 0xA5;
+uintptr_t       stack_paint_base = 0;
+
+__attribute__((noinline)) void paint_stack(void) {
+    volatile uint8_t region[STACK_PAINT_SIZE];
+    for (size_t i = 0; i < STACK_PAINT_SIZE; ++i) {
+        region[i] = STACK_PAINT_BYTE;
+    }
+    stack_paint_base = reinterpret_cast<uintptr_t>(&region[0]);
+}
+
+__attribute__((noinline)) size_t measure_stack(void) {
+    const volatile uint8_t* region = reinterpret_cast<const volatile uint8_t*>(stack_paint_base);
+    size_t                  i      = 0;
+    while (i < STACK_PAINT_SIZE && region[i] == STACK_PAINT_BYTE) {
+        ++i;
+    }
+    return STACK_PAINT_SIZE - i;
+}
+
+inline uint64_t read_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* Events waiting for the host to see a keyboard report, and the latencies of those that have. */
+std::deque<uint32_t>  pending_events;
+std::vector<uint32_t> latencies;
+unsigned              report_count;
+
+uint8_t benchmark_keyboard_leds(void) { return 0; }
+
+void benchmark_send_keyboard(report_keyboard_t* report) {
+    uint32_t now = timer_read32();
+    for (uint32_t event_time : pending_events) {
+        latencies.push_back(now - event_time);
+    }
+    pending_events.clear();
+    report_count++;
+}
+
+void benchmark_send_mouse(report_mouse_t* report) {}
+void benchmark_send_system(uint16_t data) {}
+void benchmark_send_consumer(uint16_t data) {}
+
+host_driver_t benchmark_driver = {benchmark_keyboard_leds, benchmark_send_keyboard, benchmark_send_mouse, benchmark_send_system, benchmark_send_consumer};
+
+template <typename T>
+T percentile(std::vector<T> values, unsigned pct) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[(values.size() - 1) * pct / 100];
+}
+
+}  // namespace
+
+Trace typing_trace(uint8_t key_count, unsigned strokes, uint16_t interval, uint16_t jitter, uint16_t hold, uint32_t seed) {
+    struct Change {
+        uint32_t time;
+        uint8_t  key;
+        bool     pressed;
+    };
+
+    std::mt19937          rng(seed);
+    std::vector<Change>   changes;
+    std::vector<uint32_t> released_at(key_count, 0);
+    uint32_t              time = 0;
+
+    for (unsigned i = 0; i < strokes; ++i) {
+        time += interval + (jitter ? rng() % (jitter + 1) : 0);
+
+        // Pick a key that isn't still held from an earlier stroke
+        uint8_t key = rng() % key_count;
+        while (released_at[key] >= time) {
+            key = (key + 1) % key_count;
+        }
+        released_at[key] = time + hold;
+        changes.push_back({time, key, true});
+        changes.push_back({time + hold, key, false});
+    }
+
+    std::stable_sort(changes.begin(), changes.end(), [](const Change& a, const Change& b) { return a.time < b.time; });
+
+    Trace    trace;
+    uint32_t last = 0;
+    for (auto& change : changes) {
+        trace.push_back({static_cast<uint16_t>(change.time - last), change.key, change.pressed});
+        last = change.time;
+    }
+    return trace;
+}
+
+std::vector<KeymapKey> letter_keys(uint8_t count) {
+    std::vector<KeymapKey> keys;
+    for (uint8_t i = 0; i < count; ++i) {
+        keys.push_back(KeymapKey(0, i % MATRIX_COLS, i / MATRIX_COLS, KC_A + i));
+    }
+    return keys;
+}
+
+void append_trace(Trace& trace, const Trace& pattern, unsigned times) {
+    for (unsigned i = 0; i < times; ++i) {
+        trace.insert(trace.end(), pattern.begin(), pattern.end());
+    }
+}
+
+void BenchmarkFixture::set_keymap(const std::vector<KeymapKey>& keys) {
+    this->keymap.clear();
+    for (auto& key : keys) {
+        add_key(key);
+    }
+}
+
+BenchmarkResult BenchmarkFixture::replay(const std::vector<KeymapKey>& keys, const Trace& trace, unsigned settle) {
+    std::vector<uint64_t> event_ns;
+    std::vector<uint64_t> event_cycles;
+    size_t                stack_high_water = 0;
+    host_driver_t*        previous_driver  = host_get_driver();
+
+    pending_events.clear();
+    latencies.clear();
+    report_count = 0;
+    host_set_driver(&benchmark_driver);
+#ifdef SPLIT_KEYBOARD
+    split_sim_reset_stats();
+#endif
+
+    for (auto& event : trace) {
+        idle_for(event.delay);
+
+        KeymapKey key = keys[event.key];
+        if (event.pressed) {
+            key.press();
+        } else {
+            key.release();
+        }
+        pending_events.push_back(timer_read32());
+
+        paint_stack();
+        auto     start        = std::chrono::steady_clock::now();
+        uint64_t start_cycles = read_cycles();
+        keyboard_task();
+        uint64_t end_cycles = read_cycles();
+        auto     end        = std::chrono::steady_clock::now();
+        stack_high_water    = std::max(stack_high_water, measure_stack());
+        advance_time(1);
+
+        event_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        event_cycles.push_back(end_cycles - start_cycles);
+    }
+    idle_for(settle);
+
+    host_set_driver(previous_driver);
+
+    BenchmarkResult result;
+    result.events           = trace.size();
+    result.reports          = report_count;
+    result.unreported       = pending_events.size();
+    result.ns_p50           = percentile(event_ns, 50);
+    result.ns_p99           = percentile(event_ns, 99);
+    result.cycles_p50       = percentile(event_cycles, 50);
+    result.cycles_p99       = percentile(event_cycles, 99);
+    result.latency_p50      = percentile(latencies, 50);
+    result.latency_p99      = percentile(latencies, 99);
+    result.latency_max      = percentile(latencies, 100);
+    result.stack_high_water = stack_high_water;
+    return result;
+}
+
+uint64_t BenchmarkFixture::time_process_record(const KeymapKey& key, unsigned iterations) {
+    host_driver_t* previous_driver = host_get_driver();
+    host_set_driver(&benchmark_driver);
+
+    // Take the best of several rounds, to keep other load on the host out of the result
+    uint64_t    best   = UINT64_MAX;
+    keyrecord_t record = {};
+    record.event.key   = key.position;
+    for (unsigned round = 0; round < 10; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < iterations * 2; ++i) {
+            record.event.pressed = !record.event.pressed;
+            record.event.time    = timer_read() | 1;
+            process_record_quantum(&record);
+        }
+        auto end = std::chrono::steady_clock::now();
+        best     = std::min<uint64_t>(best, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (iterations * 2));
+    }
+
+    host_set_driver(previous_driver);
+    pending_events.clear();
+    return best;
+}
+
+void BenchmarkFixture::report(const std::string& name, const BenchmarkResult& result) const {
+    std::cout << "[ BENCHMARK] " << name << ": " << result.events << " events, " << result.reports << " reports, " << result.unreported << " unreported" << std::endl;
+    std::cout << "[ BENCHMARK] " << name << ": host " << result.ns_p50 << "/" << result.ns_p99 << " ns";
+    if (result.cycles_p99) {
+        std::cout << ", " << result.cycles_p50 << "/" << result.cycles_p99 << " cycles";
+    }
+    std::cout << " per event (p50/p99), " << result.stack_high_water << " bytes stack" << std::endl;
+    std::cout << "[ BENCHMARK] " << name << ": latency " << result.latency_p50 << "/" << result.latency_p99 << "/" << result.latency_max << " ms (p50/p99/max)" << std::endl;
+}
+
+#ifdef SPLIT_KEYBOARD
+void BenchmarkFixture::report_split(const std::string& name) const {
+    split_sim_stats_t stats;
+    split_sim_get_stats(&stats);
+    if (stats.scans == 0) {
+        return;
+    }
+
+    std::cout << "[ BENCHMARK] " << name << ": " << stats.scans << " scans, " << static_cast<double>(stats.transactions) / stats.scans << " transactions, " << static_cast<double>(stats.bytes) / stats.scans << " bytes, " << static_cast<double>(stats.link_us) / stats.scans << " us link per scan";
+    if (stats.pushes) {
+        std::cout << ", " << stats.pushes << " pushes";
+    }
+    if (stats.link_us) {
+        std::cout << ", " << static_cast<uint64_t>(stats.scans) * 1000000 / stats.link_us << " scans/s max";
+    }
+    std::cout << std::endl;
+    std::cout << "[ BENCHMARK] " << name << ": transactions by id:";
+    for (unsigned i = 0; i < SPLIT_SIM_MAX_TRANSACTIONS; ++i) {
+        if (stats.per_transaction[i]) {
+            std::cout << " " << i << "=" << stats.per_transaction[i];
+        }
+    }
+    std::cout << std::endl;
+}
+#endif
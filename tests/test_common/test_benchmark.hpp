@@ -0,0 +1,83 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+/* A single recorded matrix change: wait `delay` ms of scans, then press or release keys[key]. */
+struct TraceEvent {
+    uint16_t delay;
+    uint8_t  key;
+    bool     pressed;
+};
+
+typedef std::vector<TraceEvent> Trace;
+
+/* Deterministic typing trace over `key_count` keys: each stroke starts `interval` ms after the previous one (with up to
+ * `jitter` ms added) and is held for `hold` ms, so strokes roll over into each other whenever hold > interval. */
+Trace typing_trace(uint8_t key_count, unsigned strokes, uint16_t interval, uint16_t jitter, uint16_t hold, uint32_t seed);
+
+/* KC_A onwards on layer 0, filling the matrix row by row from (0,0). */
+std::vector<KeymapKey> letter_keys(uint8_t count = 26);
+
+/* Appends `times` repetitions of `pattern` to `trace`. */
+void append_trace(Trace& trace, const Trace& pattern, unsigned times = 1);
+
+struct BenchmarkResult {
+    unsigned events;
+    unsigned reports;
+    /* Events that never led to a keyboard report, e.g. keys swallowed by a leader sequence. */
+    unsigned unreported;
+    /* Host cost of the scan that picked up each event. */
+    uint64_t ns_p50;
+    uint64_t ns_p99;
+    uint64_t cycles_p50;
+    uint64_t cycles_p99;
+    /* Simulated time from each event to the next keyboard report. */
+    uint32_t latency_p50;
+    uint32_t latency_p99;
+    uint32_t latency_max;
+    /* Deepest stack used by keyboard_task() below its caller, on the host. */
+    size_t stack_high_water;
+};
+
+class BenchmarkFixture : public TestFixture {
+   public:
+    using TestFixture::set_keymap;
+    void set_keymap(const std::vector<KeymapKey>& keys);
+
+    /* Replays `trace` over `keys` through keyboard_task(), idling for `settle` ms at the end for anything still pending.
+     * All keys are expected to be released by the end of the trace. */
+    BenchmarkResult replay(const std::vector<KeymapKey>& keys, const Trace& trace, unsigned settle = 1000);
+
+    /* Host time in ns for each event through process_record_quantum() alone, pressing and releasing `key`
+     * `iterations` times. */
+    uint64_t time_process_record(const KeymapKey& key, unsigned iterations);
+
+    /* Prints a result as a "[ BENCHMARK]" line. */
+    void report(const std::string& name, const BenchmarkResult& result) const;
+
+#ifdef SPLIT_KEYBOARD
+    /* Prints the traffic between the halves since the last replay() started, per scan, and the scan rate the link
+     * alone would allow. */
+    void report_split(const std::string& name) const;
+#endif
+};
@@ -18,7 +18,7 @@
 
 TestDriver* TestDriver::m_this = nullptr;
 
-TestDriver::TestDriver() : m_driver{&TestDriver::keyboard_leds, &TestDriver::send_keyboard, &TestDriver::send_mouse, &TestDriver::send_system, &TestDriver::send_consumer} {
+TestDriver::TestDriver() : m_driver{&TestDriver::keyboard_leds, &TestDriver::send_keyboard, &TestDriver::send_mouse, &TestDriver::send_system, &TestDriver::send_consumer, nullptr, &TestDriver::keyboard_ready} {
     host_set_driver(&m_driver);
     m_this = this;
 }
@@ -37,3 +37,5 @@ void TestDriver::send_mouse(report_mouse_t* report) { m_this->send_mouse_mock(*r
 void TestDriver::send_system(uint16_t data) { m_this->send_system_mock(data); }
 
 void TestDriver::send_consumer(uint16_t data) { m_this->send_consumer(data); }
+
+bool TestDriver::keyboard_ready(void) { return m_this->m_keyboard_ready; }
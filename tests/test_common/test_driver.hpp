@@ -27,6 +27,7 @@ class TestDriver {
     TestDriver();
     ~TestDriver();
     void set_leds(uint8_t leds) { m_leds = leds; }
+    void set_keyboard_ready(bool ready) { m_keyboard_ready = ready; }
 
     MOCK_METHOD1(send_keyboard_mock, void(report_keyboard_t&));
     MOCK_METHOD1(send_mouse_mock, void(report_mouse_t&));
@@ -39,7 +40,9 @@ class TestDriver {
     static void        send_mouse(report_mouse_t* report);
     static void        send_system(uint16_t data);
     static void        send_consumer(uint16_t data);
+    static bool        keyboard_ready(void);
     host_driver_t      m_driver;
-    uint8_t            m_leds = 0;
+    uint8_t            m_leds           = 0;
+    bool               m_keyboard_ready = true;
     static TestDriver* m_this;
 };
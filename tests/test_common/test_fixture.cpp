@@ -100,10 +100,16 @@ void TestFixture::add_key(KeymapKey key) {
     }
 
     this->keymap.push_back(key);
+#if defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_invalidate();
+#endif
 }
 
 void TestFixture::set_keymap(std::initializer_list<KeymapKey> keys) {
     this->keymap.clear();
+#if defined(LAYER_LOOKUP_CACHE)
+    layer_lookup_cache_invalidate();
+#endif
     for (auto& key : keys) {
         add_key(key);
     }
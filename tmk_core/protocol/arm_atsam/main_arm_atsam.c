@@ -44,6 +44,10 @@ void    send_consumer(uint16_t data);
 void deferred_exec_task(void);
 #endif  // DEFERRED_EXEC_ENABLE
 
+#ifdef IDLE_WAIT_ENABLE
+void idle_wait_task(void);
+#endif  // IDLE_WAIT_ENABLE
+
 host_driver_t arm_atsam_driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
 
 uint8_t led_states;
@@ -371,6 +375,11 @@ int main(void) {
 
         // Run housekeeping
         housekeeping_task();
+
+#ifdef IDLE_WAIT_ENABLE
+        // Sleep until something needs the main loop again
+        idle_wait_task();
+#endif  // IDLE_WAIT_ENABLE
     }
 
     return 1;
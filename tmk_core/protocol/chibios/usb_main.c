@@ -40,6 +40,9 @@
 #endif
 #include "wait.h"
 #include "usb_device_state.h"
+#ifdef IDLE_WAIT_ENABLE
+#    include "idle_wait.h"
+#endif
 #include "usb_descriptor.h"
 #include "usb_driver.h"
 
@@ -409,6 +412,10 @@ static inline bool usb_event_queue_enqueue(usbevent_t event) {
     }
     event_queue[event_queue_head] = event;
     event_queue_head              = next;
+#ifdef IDLE_WAIT_ENABLE
+    // Enqueued from the USB interrupt, make sure the main loop gets to it straight away
+    idle_wakeup_from_isr();
+#endif
     return true;
 }
 
@@ -821,6 +828,21 @@ static void keyboard_idle_timer_cb(void *arg) {
 /* LED status */
 uint8_t keyboard_leds(void) { return keyboard_led_state; }
 
+/* whether the keyboard endpoint is free, so send_keyboard() won't have to wait for the previous report
+ * not callable from ISR or locked state */
+bool keyboard_ready(void) {
+    uint8_t ep = KEYBOARD_IN_EPNUM;
+#ifdef NKRO_ENABLE
+    if (keymap_config.nkro && keyboard_protocol) {
+        ep = SHARED_IN_EPNUM;
+    }
+#endif
+    osalSysLock();
+    bool ready = usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE || !usbGetTransmitStatusI(&USB_DRIVER, ep);
+    osalSysUnlock();
+    return ready;
+}
+
 /* prepare and start sending a report IN
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
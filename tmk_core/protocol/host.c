@@ -81,6 +81,12 @@ void host_keyboard_send(report_keyboard_t *report) {
     }
 }
 
+/* whether a keyboard report would go out without waiting for the previous one */
+bool host_keyboard_ready(void) {
+    if (!driver || !driver->keyboard_ready) return true;
+    return (*driver->keyboard_ready)();
+}
+
 void host_mouse_send(report_mouse_t *report) {
     if (!driver) return;
 #ifdef MOUSE_SHARED_EP
@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "report.h"
 #ifdef MIDI_ENABLE
 #    include "midi.h"
@@ -30,6 +31,7 @@ typedef struct {
     void (*send_system)(uint16_t);
     void (*send_consumer)(uint16_t);
     void (*send_programmable_button)(uint32_t);
+    bool (*keyboard_ready)(void);  // optional, whether the previous keyboard report has gone out
 } host_driver_t;
 
 void send_digitizer(report_digitizer_t *report);
\ No newline at end of file